@@ -25,6 +25,7 @@
 
 
 #include <bsp.h>
+#include <mcbsp-affinity.h>
 #include <math.h>
 #include <stdio.h>
 #include <stddef.h>
@@ -41,7 +42,17 @@ void timerlib_deriveStats(
 
 void timerlib_recordMax( double * const max, const double * const restrict times, const size_t n );
 
-int main() {
+static const enum mcbsp_barrier_mode modes[ 4 ] = {
+	MCBSP_BARRIER_CENTRAL, MCBSP_BARRIER_DISSEMINATION, MCBSP_BARRIER_TOURNAMENT, MCBSP_BARRIER_TREE
+};
+
+static const char * const mode_names[ 4 ] = {
+	"central", "dissemination", "tournament", "tree"
+};
+
+void spmd( void );
+
+void spmd( void ) {
 	bsp_begin( bsp_nprocs() );
 	const unsigned int p = bsp_nprocs();
 	const unsigned int s = bsp_pid();
@@ -81,8 +92,21 @@ int main() {
 		double min, avg, max, var;
 		timerlib_deriveStats( &max, &min, &avg, &var, times, var_repeat );
 		printf( "Time taken for a barrier (bsp_sync): min = %e, avg = %e, max = %e, stddev = %e ms.\n", min, avg, max, sqrt( var ) );
+		free( time );
+		free( times );
 	}
 
 	bsp_end();
 }
 
+int main( int argc, char ** argv ) {
+	//benchmark each barrier algorithm in turn
+	for( size_t m = 0; m < 4; ++m ) {
+		printf( "Barrier algorithm: %s\n", mode_names[ m ] );
+		mcbsp_set_barrier_mode( modes[ m ] );
+		bsp_init( spmd, argc, argv );
+		spmd();
+	}
+	return EXIT_SUCCESS;
+}
+
@@ -32,6 +32,8 @@
  * 1: bsp_hpput
  * 2: bsp_get
  * 3: bsp_hpget
+ * 4: MulticoreBSP collectives (mcbsp_allgather, mcbsp_reduce, mcbsp_broadcast,
+ *    and mcbsp_allreduce)
  * 10: MPI_Put
  * 11: MPI_Get
  * 12: MPI collectives (MPI_Allgather, MPI_Gather, and MPI_Bcast)
@@ -39,8 +41,9 @@
  #define PRIMITIVE 0
 #endif
 
-#if PRIMITIVE < 4
+#if PRIMITIVE < 5
  #include <bsp.h>
+ #include <mcbsp-collectives.h>
 #elif PRIMITIVE > 9
  #include <mpi.h>
 #endif
@@ -69,6 +72,7 @@ void   kernel  ( char * const chunk1, char * const chunk2, const size_t rep, con
 void   kernel2 ( char * const chunk1, char * const chunk2, const size_t rep, const size_t n, const size_t s, const size_t p );
 void   kernel3 ( char * const chunk1, char * const chunk2, const size_t rep, const size_t n, const size_t s, const size_t p );
 #endif
+void   kernel4 ( char * const chunk1, char * const chunk2, const size_t rep, const size_t s, const size_t p );
 
 static const size_t  n1 = 1ul<<13; //8kb
 static const size_t  n2 = (1ul<<16) + (1ul<<15); //96kB
@@ -76,7 +80,7 @@ static const size_t  n3 = 1ul<<23; //8MB
 static const size_t  n4 = 1ul<<28; //256MB
 
 double time( void ) {
-#if PRIMITIVE < 4
+#if PRIMITIVE < 5
 	return bsp_time();
 #elif PRIMITIVE > 9
 	return MPI_Wtime();
@@ -84,7 +88,7 @@ double time( void ) {
 }
 
 void sync( void ) {
-#if PRIMITIVE < 4
+#if PRIMITIVE < 5
 	bsp_sync();
 #elif PRIMITIVE > 9
 	MPI_Barrier( MPI_COMM_WORLD );
@@ -96,7 +100,7 @@ double max_time( const double time, const size_t s, const size_t p ) {
 #else
 double max_time( double time, const size_t s, const size_t p ) {
 #endif
-#if PRIMITIVE < 4
+#if PRIMITIVE < 5
 	bsp_send( 0, NULL, &time, sizeof(double) );
 	double maximum = time;
 	bsp_sync();
@@ -158,6 +162,8 @@ void kernel( char * const chunk1, char * const chunk2, const size_t rep, const s
 #endif
 #if PRIMITIVE == 12
 		MPI_Allgather( chunk1, n, MPI_CHAR, chunk2, n, MPI_CHAR, MPI_COMM_WORLD );
+#elif PRIMITIVE == 4
+		mcbsp_allgather( chunk1, chunk2, n );
 #else
 		for( size_t k = 0; k < p; ++k ) {
  #if PRIMITIVE == 0
@@ -254,6 +260,9 @@ void kernel2( char * const chunk1, char * const chunk2, const size_t rep, const
 			bsp_hpget( k, chunk1, 0, chunk2 + s*n, n );
 		}
 		bsp_sync();
+#elif PRIMITIVE == 4
+		//all-to-one of the same volume, as a reduction at PID 0
+		mcbsp_reduce( 0, chunk1, chunk2, n / sizeof( unsigned int ), MCBSP_UNSIGNED_INT, MCBSP_SUM );
 #elif PRIMITIVE == 10
 		if( s == 0 ) {
 			if( MPI_Win_post( group, 0, window ) != 0 ) {
@@ -349,6 +358,8 @@ void kernel3( char * const chunk1, char * const chunk2, const size_t rep, const
 		for( size_t k = 0; s == 0 && k < p; ++k ) {
 			bsp_hpput( (bsp_pid_t)k, chunk1, chunk2, 0, n );
 		}
+#elif PRIMITIVE == 4
+		mcbsp_broadcast( 0, chunk1, chunk2, n );
 #elif PRIMITIVE == 10
 		MPI_Win_post( root, 0, window );
 		if( s == 0 ) {
@@ -389,6 +400,53 @@ void kernel3( char * const chunk1, char * const chunk2, const size_t rep, const
 #endif
 }
 
+//all-reduce of a single double, as in an inner product
+void kernel4( char * const chunk1, char * const chunk2, const size_t rep, const size_t s, const size_t p ) {
+	const double local = (double)s;
+	double sum = 0;
+#if PRIMITIVE == 4 || PRIMITIVE == 12
+	(void)chunk2;
+#endif
+	memcpy( chunk1, &local, sizeof( double ) );
+	const double t0 = time();
+	for( size_t i = 0; i < rep; ++i ) {
+#if PRIMITIVE == 0 || PRIMITIVE == 1
+		for( size_t k = 0; k < p; ++k ) {
+ #if PRIMITIVE == 0
+			bsp_put( (bsp_pid_t)k, &local, chunk2, s * sizeof( double ), sizeof( double ) );
+ #else
+			bsp_hpput( (bsp_pid_t)k, &local, chunk2, s * sizeof( double ), sizeof( double ) );
+ #endif
+		}
+		bsp_sync();
+#elif PRIMITIVE == 2 || PRIMITIVE == 3
+		for( size_t k = 0; k < p; ++k ) {
+ #if PRIMITIVE == 2
+			bsp_get( (bsp_pid_t)k, chunk1, 0, chunk2 + k * sizeof( double ), sizeof( double ) );
+ #else
+			bsp_hpget( (bsp_pid_t)k, chunk1, 0, chunk2 + k * sizeof( double ), sizeof( double ) );
+ #endif
+		}
+		bsp_sync();
+#endif
+#if PRIMITIVE < 4
+		sum = 0;
+		for( size_t k = 0; k < p; ++k ) {
+			sum += ((double*)chunk2)[ k ];
+		}
+#elif PRIMITIVE == 4
+		mcbsp_allreduce( &local, &sum, 1, MCBSP_DOUBLE, MCBSP_SUM );
+#elif PRIMITIVE == 12
+		MPI_Allreduce( (void*)&local, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+#endif
+	}
+	const double local_elapsed_time = time() - t0;
+	const double global_elapsed_time = 1000.0 * max_time( local_elapsed_time, s, p ) / ((double)rep); //avg time in ms
+	if( s == 0 ) {
+		printf( "Average time taken: %lf ms. Experiments were repeated %ld times (sum: %lf).\n\n", global_elapsed_time, rep, sum );
+	}
+}
+
 #if PRIMITIVE > 9
 int main( int argc, char** argv ) {
 	MPI_Init( &argc, &argv );
@@ -402,7 +460,7 @@ int main( int argc, char** argv ) {
  #elif PRIMITIVE == 12
 	const char method[] = "MPI collectives";
  #endif
-#elif PRIMITIVE < 4
+#elif PRIMITIVE < 5
 int main() {
 	bsp_begin( bsp_nprocs() );
 	const size_t p = bsp_nprocs();
@@ -415,6 +473,8 @@ int main() {
 	const char method[] = "bsp_get";
  #elif PRIMITIVE == 3
 	const char method[] = "bsp_hpget";
+ #elif PRIMITIVE == 4
+	const char method[] = "MulticoreBSP collectives";
  #endif
 	size_t old_tagsize = 0;
 	bsp_set_tagsize( &old_tagsize );
@@ -432,7 +492,7 @@ int main() {
 		fprintf( stderr, "Could not allocate memory!\n" );
 		MPI_Abort( MPI_COMM_WORLD, EXIT_FAILURE );
 	}
-#elif PRIMITIVE < 4
+#elif PRIMITIVE < 5
 	//get chunks of memory
 	void * const chunk1 = malloc( n4 / p );
 	void * const chunk2 = malloc(   n4   );
@@ -541,12 +601,21 @@ int main() {
 	sync();
 	kernel3( chunk1, chunk2, rep/1000, n4/p, s, p );
 
+#if PRIMITIVE < 5 || PRIMITIVE == 12
+	if( s == 0 ) {
+		printf( "\nAll-reduce %s benchmark, each BSP process contributes a single double (inner-product pattern).\n", method );
+		fflush( stdout );
+	}
+	sync();
+	kernel4( chunk1, chunk2, rep, s, p );
+#endif
+
 	if( s== 0 ) {
 		printf( "Cleaning up...\n" );
 		fflush( stdout );
 	}
 
-#if PRIMITIVE < 4
+#if PRIMITIVE < 5
 	//free chunks
 	free( chunk1 );
 	free( chunk2 );
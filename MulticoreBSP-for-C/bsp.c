@@ -86,6 +86,9 @@ void MCBSP_FUNCTION_PREFIX(begin)( const bsp_pid_t P ) {
 		fprintf( stderr, "Could not allocate new threads!\n" );
 		mcbsp_util_fatal();
 	}
+#ifdef MCBSP_THREAD_POOL
+	init->workers = mcbsp_util_malloc( ((size_t)P) * sizeof( struct mcbsp_pool_worker * ), "bsp_begin (MulticoreBSP for C) pooled worker array" );
+#endif
 
 	pthread_attr_t attr;
 
@@ -107,6 +110,8 @@ void MCBSP_FUNCTION_PREFIX(begin)( const bsp_pid_t P ) {
 	init->skipped_checkpoints = 0;
 	init->current_superstep   = 0;
 	init->sync_entry_counter  = 0;
+	init->sync_pending[ 0 ] = init->sync_pending[ 1 ] = init->sync_pending[ 2 ] = 0;
+	init->unbuffered_pending[ 0 ] = init->unbuffered_pending[ 1 ] = init->unbuffered_pending[ 2 ] = 0;
 	init->sync_exit_counter   = 0;
 	pthread_mutex_init( &(init->mutex), NULL );
 	init->    sl_condition = mcbsp_util_malloc( ((size_t)P) * sizeof( unsigned char ), "bsp_begin (MulticoreBSP for C) default spinlocking array" );
@@ -115,6 +120,8 @@ void MCBSP_FUNCTION_PREFIX(begin)( const bsp_pid_t P ) {
 	for( size_t s = 0; s < ((size_t)P); ++s ) {
 		init->sl_condition[ s ] = init->sl_mid_condition[ s ] = init->sl_end_condition[ s ] = 0;
 	}
+	mcbsp_internal_barrier_initialise( init, machine );
+	init->loop_deques = mcbsp_util_malloc( ((size_t)P) * sizeof( struct mcbsp_loop_deque ), "bsp_begin (MulticoreBSP for C) work-stealing deques" );
 	pthread_cond_init( &(init->    condition), NULL );
 	pthread_cond_init( &(init->mid_condition), NULL );
 	pthread_cond_init( &(init->end_condition), NULL );
@@ -168,6 +175,18 @@ void MCBSP_FUNCTION_PREFIX(begin)( const bsp_pid_t P ) {
 
 		//spawn new threads if s>0
 		if( s > 0 ) {
+#ifdef MCBSP_THREAD_POOL
+			//hand the process to a parked worker, which is pinned on the way. A
+			//pooled process returns from bsp_end into its SPMD entry point, which
+			//must then return as well; an implied bsp_init would instead continue
+			//with the remainder of main, so then spawn a dedicated thread
+			init->workers[ s ] = NULL;
+			if( init->spmd != NULL ) {
+				init->workers[ s ] = mcbsp_internal_pool_acquire( thread_data, pinning[ s ] );
+				init->threads[ s ] = init->workers[ s ]->thread;
+				continue;
+			}
+#endif
 			//create POSIX threads attributes
 			//(currently for pinning, if supported)
 			pthread_attr_init( &attr );
@@ -319,6 +338,17 @@ void MCBSP_FUNCTION_PREFIX(end)( void ) {
 		mcbsp_util_fatal();
 	}
 
+#ifndef MCBSP_NO_CHECKS
+	if( data->sync_begun ) {
+		bsp_abort( "Error: bsp_end called after bsp_sync_begin without a matching bsp_sync_end!\n" );
+	}
+#endif
+
+	//a process still communicating the last superstep checks for mismatched sync/end first
+	for( size_t s = 0; s < data->init->P; ++s ) {
+		mcbsp_internal_wait_delivered( data->init, s, data->superstep );
+	}
+
 	//record end
 	data->init->ended = true;
 
@@ -366,6 +396,14 @@ void MCBSP_FUNCTION_PREFIX(end)( void ) {
 
 	//free data and exit if not master thread
 	if( data->bsp_id != 0 ) {
+#ifdef MCBSP_THREAD_POOL
+		if( data->worker != NULL ) {
+			//retain our thread-local data for the next SPMD section, and return
+			//through the SPMD entry point to the worker loop, where we park
+			mcbsp_internal_pool_release( data );
+			return;
+		}
+#endif
 		//free thread-local data
 		mcbsp_internal_destroy_thread_data( data );
 		//exit
@@ -380,11 +418,19 @@ void MCBSP_FUNCTION_PREFIX(end)( void ) {
 
 	//wait for other threads
 	for( size_t s = 1; s < init->P; ++s ) {
+#ifdef MCBSP_THREAD_POOL
+		if( init->workers[ s ] != NULL ) {
+			mcbsp_internal_pool_wait( init->workers[ s ] );
+			continue;
+		}
+#endif
 		pthread_join( init->threads[ s ], NULL );
 	}
 
 	//destroy mutex and conditions
 	pthread_mutex_destroy( &(init->mutex) );
+	mcbsp_internal_barrier_destroy( init );
+	free( init->loop_deques );
 #ifdef MCBSP_USE_SPINLOCK
 	free( init->    sl_condition );
 	free( init->sl_mid_condition );
@@ -402,6 +448,9 @@ void MCBSP_FUNCTION_PREFIX(end)( void ) {
 
 	//free threads array
 	free( init->threads );
+#ifdef MCBSP_THREAD_POOL
+	free( init->workers );
+#endif
 
 	//reset thread-local data, if applicable (hierarchical execution)
 	const int rc = pthread_setspecific( mcbsp_internal_thread_data, init->prev_data );
@@ -527,25 +576,183 @@ void MCBSP_FUNCTION_PREFIX(vabort)( const char * const error_message, va_list ar
 		pthread_cond_broadcast( &(data->init->condition) );
 	pthread_mutex_unlock( &( data->init->mutex) );
 #else
-	//in spinlock-loop abort-condition is busy-checked; no code necessary
+	//spinning threads busy-check the abort condition; wake up those that block
+	mcbsp_internal_barrier_wake( data->init );
+#endif
+
+#ifdef MCBSP_THREAD_POOL
+	//parked workers would otherwise keep the aborted program alive
+	mcbsp_internal_pool_dismiss( false );
 #endif
 	
 	//quit execution
 	pthread_exit( NULL );
 }
 
-void MCBSP_FUNCTION_PREFIX(sync)( void ) {
+/** Executes a bsp_hpput or bsp_hpget request. */
+static inline void mcbsp_internal_hp_copy( const struct mcbsp_hp_request * const request ) {
+	//invalidate any local copies of remote memory
+	mcbsp_nocc_invalidate( request->source, request->length );
+
+	//sanity checks
+	assert( request->destination != NULL );
+	assert( request->source      != NULL );
+	assert( request->length      != 0    );
+#ifndef NDEBUG
+	//execute HP communication, first check for overlap
+	if(
+		( (      (char *)request->destination) + request->length <= ((const char *)request->source)      ) ||
+		( ((const char *)request->source)      + request->length <= (      (char *)request->destination) )
+	) {
+		//no overlap, do copy
+		mcbsp_util_memcpy( request->destination, request->source, request->length );
+	} else {
+		//there is overlap, warn because this is undefined behaviour
+		fprintf( stderr, "Warning: overlapping DRMA communication detected by invalid calls to bsp_hpget or bsp_hpput. This results in undefined behaviour!\n" );
+		//ensure `correctness' by doing move instead of copy:
+		memmove( request->destination, request->source, request->length );
+	}
+#else
+	//directly execute HP communication;
+	//overlap results in undefined behaviour (BSPlib standard), so crashing is OK
+	mcbsp_util_memcpy( request->destination, request->source, request->length );
+#endif
+}
+
+/**
+ * Adds a message received during bsp_sync to the BSMP queue or, if messages
+ * are sorted into buckets, to the entries to be sorted.
+ */
+static inline void mcbsp_internal_receive_message( struct mcbsp_thread_data * const data,
+	const struct bsp_message * const message, const size_t source ) {
+	if( data->bsmp_buckets == 0 ) {
+		mcbsp_util_stack_push( &(data->bsmp), message );
+		return;
+	}
+	struct mcbsp_bsmp_entry entry;
+	entry.message = *message;
+	entry.source  = source;
+	entry.bucket  = data->bsmp_bucket == NULL ? source :
+		(size_t) data->bsmp_bucket( message->tag, (bsp_pid_t) source );
+#ifndef MCBSP_NO_CHECKS
+	if( entry.bucket >= data->bsmp_buckets ) {
+		bsp_abort( "Error: BSMP bucket function returned bucket %zd, while there are only %zd buckets!\n",
+			entry.bucket, data->bsmp_buckets );
+	}
+#endif
+	mcbsp_util_stack_push( &(data->bsmp_entries[ 0 ]), &entry );
+}
+
+/**
+ * Stable counting sort of n BSMP entries on their source or bucket, such
+ * that key 0 ends up at the top of the output. Afterwards, key k occupies
+ * the output from starts[ k + 1 ] up to starts[ k ].
+ * Exactly one of out and messages is used as output.
+ */
+static void mcbsp_internal_bucket_sort( size_t * const starts, const size_t range,
+	const struct mcbsp_bsmp_entry * const in, const size_t n, const bool by_source,
+	struct mcbsp_bsmp_entry * const out, struct bsp_message * const messages ) {
+	//count the occurrences of key k in starts[ k + 1 ]
+	memset( starts, 0, (range + 1) * sizeof( size_t ) );
+	for( size_t i = 0; i < n; ++i ) {
+		++(starts[ (by_source ? in[ i ].source : in[ i ].bucket) + 1 ]);
+	}
+	//turn counts into the end of each key range, shifted by one
+	starts[ 0 ] = n;
+	for( size_t k = 1; k <= range; ++k ) {
+		starts[ k ] = starts[ k - 1 ] - starts[ k ];
+	}
+	//place from the top down, so that entries keep their relative order;
+	//this moves the end of each key range down to its start
+	for( size_t i = n; i > 0; --i ) {
+		const size_t key = by_source ? in[ i - 1 ].source : in[ i - 1 ].bucket;
+		const size_t target = --(starts[ key ]);
+		if( out != NULL ) {
+			out[ target ] = in[ i - 1 ];
+		} else {
+			messages[ target ] = in[ i - 1 ].message;
+		}
+	}
+	//shift back, so that starts[ k ] again is where key k - 1 starts
+	for( size_t k = range; k > 0; --k ) {
+		starts[ k ] = starts[ k - 1 ];
+	}
+	starts[ 0 ] = n;
+}
+
+/** Grows a stack such that it holds n items. */
+static void mcbsp_internal_resize_stack( struct mcbsp_util_stack * const stack, const size_t n ) {
+	while( stack->cap < n ) {
+		mcbsp_util_stack_grow( stack );
+	}
+	stack->top = n;
+}
+
+/**
+ * Sorts the BSMP messages received during bsp_sync into the BSMP queue,
+ * such that they are read by increasing bucket, then by increasing
+ * source, and then in the order they were sent.
+ *
+ * The messages of each source were received one after the other, each
+ * in reverse order of sending. Stable sorts on source and then bucket
+ * that put key 0 on top thus yield the above order.
+ */
+static void mcbsp_internal_sort_messages( struct mcbsp_thread_data * const data ) {
+	struct mcbsp_util_stack * const entries = data->bsmp_entries;
+	const size_t n = entries[ 0 ].top;
+	mcbsp_internal_resize_stack( &(data->bsmp), n );
+	if( data->bsmp_bucket == NULL ) {
+		//buckets are sources
+		mcbsp_internal_bucket_sort( data->bsmp_starts, data->bsmp_buckets,
+			entries[ 0 ].array, n, true, NULL, data->bsmp.array );
+	} else {
+		mcbsp_internal_resize_stack( &(entries[ 1 ]), n );
+		mcbsp_internal_bucket_sort( data->bsmp_starts, data->init->P,
+			entries[ 0 ].array, n, true, entries[ 1 ].array, NULL );
+		mcbsp_internal_bucket_sort( data->bsmp_starts, data->bsmp_buckets,
+			entries[ 1 ].array, n, false, NULL, data->bsmp.array );
+		entries[ 1 ].top = 0;
+	}
+	entries[ 0 ].top = 0;
+}
+
+/**
+ * Performs the first half of a bsp_sync: executes the hp requests, and
+ * announces our arrival at the synchronisation. Does not wait for the
+ * other processes if the barrier in use allows for this.
+ */
+static void mcbsp_internal_sync_begin( struct mcbsp_thread_data * const data ) {
+
+#ifndef MCBSP_NO_CHECKS
+	if( data->sync_begun ) {
+		bsp_abort( "Error: bsp_sync or bsp_sync_begin called after bsp_sync_begin without a matching bsp_sync_end!\n" );
+	}
+#endif
+	data->sync_begun = true;
 
-	//get local data
-	struct mcbsp_thread_data * const data = pthread_getspecific( mcbsp_internal_thread_data );
-	
 #if MCBSP_MODE == 3
-	const double comm_start = mcbsp_internal_time( data );
-	data->superstep_stats.computation = comm_start - data->superstep_start_time;
+	data->sync_start = mcbsp_internal_time( data );
+	data->superstep_stats.computation = data->sync_start - data->superstep_start_time;
 #endif
 
-	//clear local BSMP queue
+	//clear local BSMP queue; the messages it referred to may now be overwritten
 	data->bsmp.top = 0;
+	++(data->bsmp_generation);
+	mcbsp_util_arena_reset( &(data->bsmp_copies) );
+
+	//apply the bucket settings for the messages delivered by this sync
+	if( data->new_bsmp_buckets != data->bsmp_buckets ) {
+		if( data->bsmp_starts != NULL ) {
+			free( data->bsmp_starts );
+			data->bsmp_starts = NULL;
+		}
+		if( data->new_bsmp_buckets > 0 ) {
+			const size_t range = data->new_bsmp_buckets > data->init->P ? data->new_bsmp_buckets : data->init->P;
+			data->bsmp_starts = mcbsp_util_malloc( (range + 1) * sizeof( size_t ), "bsp_sync BSMP bucket offsets" );
+		}
+		data->bsmp_buckets = data->new_bsmp_buckets;
+	}
+	data->bsmp_bucket = data->new_bsmp_bucket;
 
 	//update superstep counts
 	if( data->bsp_id == 0 ) {
@@ -575,6 +782,13 @@ void MCBSP_FUNCTION_PREFIX(sync)( void ) {
 	//invalidate local copies of this queue data
 	mcbsp_nocc_invalidate( hpdrmaqueue, sizeof(struct mcbsp_util_stack) );
 
+	//hp requests touch remote memory, which may still be receiving the communication of the previous superstep
+	if( !mcbsp_util_stack_empty( hpdrmaqueue ) ) {
+		for( size_t s = 0; s < data->init->P; ++s ) {
+			mcbsp_internal_wait_delivered( data->init, s, data->superstep );
+		}
+	}
+
 	//handle each message in this queue
 	while( !mcbsp_util_stack_empty( hpdrmaqueue ) ) {
 
@@ -588,32 +802,8 @@ void MCBSP_FUNCTION_PREFIX(sync)( void ) {
 		const struct mcbsp_hp_request request =
 			* (struct mcbsp_hp_request *) mcbsp_util_stack_pop( hpdrmaqueue );
 
-		//invalidate any local copies of remote memory
-		mcbsp_nocc_invalidate( request.source, request.length );
-
-		//sanity checks
-		assert( request.destination != NULL );
-		assert( request.source      != NULL );
-		assert( request.length      != 0    );
-#ifndef NDEBUG
-		//execute HP communication, first check for overlap
-		if(
-			( (      (char *)request.destination) + request.length <= ((const char *)request.source)      ) ||
-			( ((const char *)request.source)      + request.length <= (      (char *)request.destination) )
-		) {
-			//no overlap, do copy
-			mcbsp_util_memcpy( request.destination, request.source, request.length );
-		} else {
-			//there is overlap, warn because this is undefined behaviour
-			fprintf( stderr, "Warning: overlapping DRMA communication detected by invalid calls to bsp_hpget or bsp_hpput. This results in undefined behaviour!\n" );
-			//ensure `correctness' by doing move instead of copy:
-			memmove( request.destination, request.source, request.length );
-		}
-#else
-		//directly execute HP communication;
-		//overlap results in undefined behaviour (BSPlib standard), so crashing is OK
-		mcbsp_util_memcpy( request.destination, request.source, request.length );
-#endif
+		//execute it
+		mcbsp_internal_hp_copy( &request );
 #if MCBSP_MODE == 3
 		const size_t metadata = sizeof(struct mcbsp_hp_request);
 		if( request.source_is_remote ) {
@@ -628,12 +818,207 @@ void MCBSP_FUNCTION_PREFIX(sync)( void ) {
 #endif
 	} //go to next hp drma request
 
+	//check whether this process requires the full synchronisation: (de-)registrations, tag size changes,
+	//and gets all need a barrier before communication starts
+#ifdef MCBSP_WITH_DMTCP
+	const bool local_full = true;
+#else
+	const bool local_full =
+		!mcbsp_util_stack_empty( &(data->localsToPush) ) ||
+		!mcbsp_util_stack_empty( &(data->localsToRemove) ) ||
+		!mcbsp_util_stack_empty( &(data->request_queue) ) ||
+		!mcbsp_util_stack_empty( &(data->strided_gets) ) ||
+		data->newTagSize != data->init->tagSize;
+#endif
+	if( local_full ) {
+		__atomic_add_fetch( &(data->init->sync_pending[ data->superstep % 3 ]), 1, __ATOMIC_RELAXED );
+	}
+	//unbuffered communication is received in a phase of its own
+	if( data->sources_pending ) {
+		__atomic_add_fetch( &(data->init->unbuffered_pending[ data->superstep % 3 ]), 1, __ATOMIC_RELAXED );
+	}
+
+	//announce our arrival; the central spinlock barrier lets us leave before the others arrive
+#ifdef MCBSP_USE_SPINLOCK
+	data->arrived = mcbsp_internal_spinlock_arrive( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
+#endif
+}
+
+/**
+ * Retrieves the outbox towards pid for the current superstep, allocating it
+ * on first use. The first call of a superstep adds the outbox to the senders
+ * list of pid, which only this process and pid modify, and pid only during
+ * bsp_sync.
+ *
+ * @return The outbox towards pid.
+ */
+static inline struct mcbsp_outbox * mcbsp_internal_outbox( struct mcbsp_thread_data * const data, const size_t pid ) {
+	const size_t parity = data->superstep % 2;
+	const size_t index  = parity * data->init->P + pid;
+	struct mcbsp_outbox * const box = data->outboxes[ index ] == NULL ?
+		mcbsp_internal_create_outbox( data, index ) :
+		data->outboxes[ index ];
+	if( !box->listed ) {
+		//other senders may add themselves concurrently
+		box->listed = true;
+		struct mcbsp_outbox ** const head = &(data->init->threadData[ pid ]->senders[ parity ]);
+		box->next = __atomic_load_n( head, __ATOMIC_RELAXED );
+		while( !__atomic_compare_exchange_n( head, &(box->next), box, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) ) {}
+	}
+	return box;
+}
+
+/** Orders outboxes on the ID of their sending process. */
+static int mcbsp_internal_outbox_compare( const void * a, const void * b ) {
+	const size_t x = (*(struct mcbsp_outbox * const *)a)->source;
+	const size_t y = (*(struct mcbsp_outbox * const *)b)->source;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Handles all communication the sender of the given outbox queued for us
+ * during the superstep that is ending and that reads directly from the
+ * memory of the sender: hp-BSMP messages, the puts of executed communication
+ * plans, and deferred puts.
+ */
+static void mcbsp_internal_receive_unbuffered( struct mcbsp_thread_data * const data, struct mcbsp_outbox * const box, const size_t parity ) {
+	const size_t s = box->source;
+	//handle queue for hp-BSMP items
+	struct mcbsp_util_stack * const hpqueue = &(box->hpsends);
+	//each message in this queue is directed at us; handle them
+	while( !mcbsp_util_stack_empty( hpqueue ) ) {
+		//pop hpsend request from outgoing stack
+		const struct mcbsp_hpsend_request * const request =
+			(struct mcbsp_hpsend_request *) mcbsp_util_stack_pop( hpqueue );
+		//the sender may change its tag and payload after this sync; copy them
+		char * const copy = mcbsp_util_arena_reserve( &(data->bsmp_copies), data->init->tagSize + request->payload_size );
+		mcbsp_util_memcpy( copy, request->tag, data->init->tagSize );
+		mcbsp_util_memcpy( copy + data->init->tagSize, request->payload, request->payload_size );
+		//add message to bsmp queue
+		const struct bsp_message message = { copy, copy + data->init->tagSize, request->payload_size };
+		mcbsp_internal_receive_message( data, &message, s );
+#if MCBSP_MODE == 3
+		//record profile
+		const size_t metadata = sizeof(struct mcbsp_hpsend_request);
+		data->superstep_stats.bytes_received     += request->payload_size + metadata;
+		data->superstep_stats.metabytes_received += metadata;
+#endif
+	} //go to next hpsend request
+
+	//puts of the communication plans executed by s are copied directly from
+	//the memory of s, following the recorded address lists
+	const struct mcbsp_util_stack * const plans = &(data->init->threadData[ s ]->plan_sets[ parity ]);
+	for( size_t i = 0; i < plans->top; ++i ) {
+		const struct mcbsp_plan * const plan = ((struct mcbsp_plan * const *)(plans->array))[ i ];
+		const struct mcbsp_hp_request * const list = plan->puts[ data->bsp_id ].array;
+		const size_t length = plan->puts[ data->bsp_id ].top;
+		for( size_t j = 0; j < length; ++j ) {
+			//invalidate any local copies of remote memory
+			mcbsp_nocc_invalidate( list[ j ].source, list[ j ].length );
+			mcbsp_util_memcpy( list[ j ].destination, list[ j ].source, list[ j ].length );
+#if MCBSP_MODE == 3
+			data->superstep_stats.bytes_received += list[ j ].length;
+#endif
+		}
+	}
+
+	//deferred puts are copied directly from the memory of s
+	struct mcbsp_util_stack * const deferred = &(box->deferred);
+	while( !mcbsp_util_stack_empty( deferred ) ) {
+		const struct mcbsp_hp_request * const request =
+			(struct mcbsp_hp_request *) mcbsp_util_stack_pop( deferred );
+		//invalidate any local copies of remote memory
+		mcbsp_nocc_invalidate( request->source, request->length );
+		mcbsp_util_memcpy( request->destination, request->source, request->length );
+#if MCBSP_MODE == 3
+		const size_t metadata = sizeof(struct mcbsp_hp_request);
+		data->superstep_stats.bytes_received     += request->length + metadata;
+		data->superstep_stats.metabytes_received += metadata;
+#endif
+	}
+}
+
+/**
+ * Handles all communication the sender of the given outbox buffered for us
+ * during the superstep that is ending.
+ */
+static void mcbsp_internal_receive_from( struct mcbsp_thread_data * const data, struct mcbsp_outbox * const box ) {
+	const size_t s = box->source;
+	//put and get requests handled here
+	struct mcbsp_util_arena * const queue = &(box->queue);
+	//each request in queue is directed to us. Handle all of them.
+	while( !mcbsp_util_arena_empty( queue ) ) {
+		struct mcbsp_message * const request = (struct mcbsp_message*) mcbsp_util_arena_regpop( queue );
+		if( request->length == MCBSP_PATTERN_LENGTH ) {
+			//strided or indexed put: scatter the packed payload in one pass
+			const struct mcbsp_pattern * const pattern =
+				(struct mcbsp_pattern *) mcbsp_util_arena_pop( queue, sizeof(struct mcbsp_pattern) );
+			const size_t * offsets = NULL;
+			if( pattern->stride == SIZE_MAX ) {
+				offsets = (size_t *) mcbsp_util_arena_pop( queue, pattern->count * sizeof(size_t) );
+			}
+			const void * const payload = mcbsp_util_arena_pop( queue, pattern->count * pattern->block );
+			if( offsets == NULL ) {
+				mcbsp_util_memcpy_strided( request->destination, pattern->stride,
+					payload, pattern->block, pattern->block, pattern->count );
+			} else {
+				mcbsp_util_memcpy_indexed( request->destination, offsets,
+					payload, pattern->block, pattern->count );
+			}
+#if MCBSP_MODE == 3
+			//record profile
+			const size_t metadata = sizeof(struct mcbsp_message) + sizeof(struct mcbsp_pattern) +
+				(offsets == NULL ? 0 : pattern->count * sizeof(size_t));
+			data->superstep_stats.bytes_received     += pattern->count * pattern->block + metadata;
+			data->superstep_stats.metabytes_received += metadata;
+#endif
+			continue;
+		}
+		if( request->destination == NULL ) {
+			//get tag and payload from queue
+			const void * const tag     = mcbsp_util_arena_pop( queue, data->init->tagSize );
+			const void * const payload = mcbsp_util_arena_pop( queue, request->length );
+			//the message stays in the queue of s until the superstep after next,
+			//so the bsmp queue refers to it in place
+			const struct bsp_message message = { tag, payload, request->length };
+			mcbsp_internal_receive_message( data, &message, s );
+		} else {
+			//copy payload to destination
+			mcbsp_util_memcpy(
+				request->destination,
+				mcbsp_util_arena_pop( queue, request->length ),
+				request->length
+			);
+		}
+#if MCBSP_MODE == 3
+		//record profile
+		const size_t metadata = sizeof(struct mcbsp_message);
+		data->superstep_stats.bytes_received     += request->length + data->init->tagSize + metadata;
+		data->superstep_stats.metabytes_received += metadata;
+#endif
+	}
+}
+
+/**
+ * Performs the second half of a bsp_sync: waits for all processes to arrive,
+ * and then executes all communication of the superstep.
+ */
+static void mcbsp_internal_sync_end( struct mcbsp_thread_data * const data ) {
+
+	//the queues of this superstep
+	const size_t parity = data->superstep % 2;
+
 	//see if synchronisation is complete (after this synch we perform non-hp DRMA communication, as well as hp BSMP communication)
 #ifdef MCBSP_USE_SPINLOCK
-	mcbsp_internal_spinlock( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
+	if( data->arrived ) {
+		mcbsp_internal_spinlock_complete( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
+	} else {
+		mcbsp_internal_spinlock( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
+	}
 #else
 	mcbsp_internal_sync( data->init, &(data->init->condition) );
 #endif
+	data->sync_begun = false;
 
 	//wait for earlier data cache purge to finish (__builtin_k1_dpurge);
 	//after that the code can continue as though we were cache-coherent,
@@ -653,41 +1038,63 @@ void MCBSP_FUNCTION_PREFIX(sync)( void ) {
 	}
 #endif
 
-	//handle the various BSP requests
-	
-	//update tagSize, phase 1
-	if( data->bsp_id == 0 && data->newTagSize != data->init->tagSize ) {
-		data->init->tagSize = data->newTagSize;
+	//the above barrier made all contributions to the global flag visible; the slot used two
+	//supersteps ago is no longer read by anyone, so recycle it
+	const bool full = __atomic_load_n( &(data->init->sync_pending[ data->superstep % 3 ]), __ATOMIC_RELAXED ) > 0;
+	const bool unbuffered = __atomic_load_n( &(data->init->unbuffered_pending[ data->superstep % 3 ]), __ATOMIC_RELAXED ) > 0;
+	if( data->bsp_id == 0 ) {
+		__atomic_store_n( &(data->init->sync_pending[ (data->superstep + 2) % 3 ]), 0, __ATOMIC_RELAXED );
+		__atomic_store_n( &(data->init->unbuffered_pending[ (data->superstep + 2) % 3 ]), 0, __ATOMIC_RELAXED );
 	}
 
-	//look for requests with destination us, first cache get-requests
-	//since they should not be polluted by incoming put requests
-	for( size_t k = 0; k < data->init->P; ++k ) {
-#ifdef MCBSP_CA_SYNC
-		//do round-robin sync
-		const size_t s = (k + data->bsp_id) % data->init->P;
-#else
-		const size_t s = k;
-#endif
-		//get remote get request queue
-		struct mcbsp_util_stack * const queue = &(data->init->threadData[ s ]->request_queues[ data->bsp_id ]);
-		//each request in queue is directed to us. Handle all of them.
-		while( !mcbsp_util_stack_empty( queue ) ) {
+	//handle the various BSP requests
+
+	if( full ) {
+
+		//update tagSize, phase 1
+		if( data->bsp_id == 0 && data->newTagSize != data->init->tagSize ) {
+			data->init->tagSize = data->newTagSize;
+		}
+
+		//handle get-requests first, since they should not be polluted by incoming
+		//put requests. A bsp_get is always queued at the requesting process, which
+		//serves it itself by copying directly from the remote source: no process
+		//delivers any put before the next barrier, so the source still holds its
+		//value from the end of the computation phase. Only when the source may be
+		//overwritten by a get of its owner, the data is first buffered as a put to
+		//ourselves
+		struct mcbsp_util_stack * const get_queue = &(data->request_queue);
+		while( !mcbsp_util_stack_empty( get_queue ) ) {
 			//get get-request
-			const struct mcbsp_get_request * const request = (struct mcbsp_get_request *) mcbsp_util_stack_pop( queue );
+			const struct mcbsp_get_request * const request = (struct mcbsp_get_request *) mcbsp_util_stack_pop( get_queue );
 			//check if source address is destination address
 			if( request->source == request->destination ) {
 				//then communication here is useless, regardless of length;
 				//ignore this request
 				continue;
 			}
-			//the top part is actually the BSP message header
-			const struct mcbsp_message * const message = (const struct mcbsp_message * const) ((const char * const)request + sizeof( void * ));
-			//put data in our local bsp_put communication queue
-			struct mcbsp_util_stack * const comm_queue = &(data->queues[ s ]);
-			mcbsp_util_varstack_push( comm_queue, request->source, request->length );
+			//check whether the source overlaps with memory written by gets at its owner
+			const struct mcbsp_thread_data * const owner = data->init->threadData[ request->pid ];
+			const char * const low  = (const char *)(request->source);
+			const char * const high = low + request->length;
+			if( high <= owner->get_low || owner->get_high <= low ) {
+				//invalidate any local copies of remote memory
+				mcbsp_nocc_invalidate( request->source, request->length );
+				//copy payload to destination
+				mcbsp_util_memcpy( request->destination, request->source, request->length );
+#if MCBSP_MODE == 3
+				data->superstep_stats.bytes_received     += request->length;
+				data->superstep_stats.metabytes_received += sizeof(struct mcbsp_get_request);
+#endif
+				continue;
+			}
+			//put data in our local bsp_put communication queue; the served
+			//gets are delivered during this sync
+			const struct mcbsp_message message = { request->destination, request->length };
+			struct mcbsp_util_arena * const comm_queue = &(mcbsp_internal_outbox( data, data->bsp_id )->queue);
+			mcbsp_util_arena_push( comm_queue, request->source, request->length );
 			//put BSP message header
-			mcbsp_util_varstack_regpush( comm_queue, message );
+			mcbsp_util_arena_regpush( comm_queue, &message );
 #if MCBSP_MODE == 3
 			const size_t metadata = sizeof(struct mcbsp_message);
 			data->superstep_stats.bytes_buffered += request->length;
@@ -695,315 +1102,393 @@ void MCBSP_FUNCTION_PREFIX(sync)( void ) {
 			data->superstep_stats.metabytes_sent += metadata;
 #endif
 		}
-	}
 
-	//handle pop_regs: loop over all locals, without destroying the stacks
-	//FIXME the handling of (de-)registration is probably the next thing on the list of internal improvements for MulticoreBSP
-	for( size_t i = 0; i < data->localsToRemove.top; ++i ) {
-		void * const * const array = (void **)(data->localsToRemove.array);
-		void * const toRemove = array[ i ];
-		void * search_address = toRemove;
-		const struct mcbsp_util_address_map * search_map = &(data->local2global);
-		if( toRemove == NULL ) {
-			//use other process' logic to process this pop_reg
-			size_t s;
-			void * const * array2 = NULL;
-			//find processor with non-NULL entry at this point
-			for( s = 0; s < data->init->P; ++s ) {
-				array2 = (void**)(data->init->threadData[ s ]->localsToRemove.array);
-				if( array2[ i ] != NULL )
-					break;
+		//strided gets are served the same way; an overlapping source is packed
+		//and delivered to ourselves as a strided put
+		while( !mcbsp_util_stack_empty( &(data->strided_gets) ) ) {
+			const struct mcbsp_strided_get_request * const request =
+				(struct mcbsp_strided_get_request *) mcbsp_util_stack_pop( &(data->strided_gets) );
+			const struct mcbsp_thread_data * const owner = data->init->threadData[ request->pid ];
+			const size_t extent = (request->count - 1) * request->source_stride + request->block;
+			const char * const low  = (const char *)(request->source);
+			const char * const high = low + extent;
+			//invalidate any local copies of remote memory
+			mcbsp_nocc_invalidate( request->source, extent );
+#if MCBSP_MODE == 3
+			data->superstep_stats.bytes_received     += request->count * request->block;
+			data->superstep_stats.metabytes_received += sizeof(struct mcbsp_strided_get_request);
+#endif
+			if( high <= owner->get_low || owner->get_high <= low ) {
+				mcbsp_util_memcpy_strided( request->destination, request->destination_stride,
+					request->source, request->source_stride, request->block, request->count );
+				continue;
 			}
-			//check if we found an entry
+			struct mcbsp_util_arena * const comm_queue = &(mcbsp_internal_outbox( data, data->bsp_id )->queue);
+			mcbsp_util_memcpy_strided( mcbsp_util_arena_reserve( comm_queue, request->count * request->block ), request->block,
+				request->source, request->source_stride, request->block, request->count );
+			const struct mcbsp_pattern pattern = { request->block, request->count, request->destination_stride };
+			mcbsp_util_arena_push( comm_queue, &pattern, sizeof(struct mcbsp_pattern) );
+			const struct mcbsp_message message = { request->destination, MCBSP_PATTERN_LENGTH };
+			mcbsp_util_arena_regpush( comm_queue, &message );
+		}
+
+		//handle pop_regs: loop over all locals, without destroying the stacks
+		//FIXME the handling of (de-)registration is probably the next thing on the list of internal improvements for MulticoreBSP
+		for( size_t i = 0; i < data->localsToRemove.top; ++i ) {
+			void * const * const array = (void **)(data->localsToRemove.array);
+			void * const toRemove = array[ i ];
+			void * search_address = toRemove;
+			const struct mcbsp_util_address_map * search_map = &(data->local2global);
+			if( toRemove == NULL ) {
+				//use other process' logic to process this pop_reg
+				size_t s;
+				void * const * array2 = NULL;
+				//find processor with non-NULL entry at this point
+				for( s = 0; s < data->init->P; ++s ) {
+					array2 = (void**)(data->init->threadData[ s ]->localsToRemove.array);
+					if( array2[ i ] != NULL )
+						break;
+				}
+				//check if we found an entry
 #ifndef MCBSP_NO_CHECKS
-			if( s == data->init->P ) {
-				fprintf( stderr, "Warning: tried to de-register a NULL address at all processes!\n" );
-				continue; //ignore
-			}
+				if( s == data->init->P ) {
+					fprintf( stderr, "Warning: tried to de-register a NULL address at all processes!\n" );
+					continue; //ignore
+				}
 #endif
-			//use this processor's logic
-			search_address = array2[ i ];
-			search_map = &(data->init->threadData[ s ]->local2global);
-		}
+				//use this processor's logic
+				search_address = array2[ i ];
+				search_map = &(data->init->threadData[ s ]->local2global);
+			}
 
-		//get global key. Note we may be searching in other processors' map, thus:
-		// -this should happen after a barrier to ensure all processors have all pop_regs.
-		// -this function cannot change the local local2global map
-		const size_t globalIndex = mcbsp_util_address_map_get( search_map, search_address );
+			//get global key. Note we may be searching in other processors' map, thus:
+			// -this should happen after a barrier to ensure all processors have all pop_regs.
+			// -this function cannot change the local local2global map
+			const size_t globalIndex = mcbsp_util_address_map_get( search_map, search_address );
 
 #ifdef MCBSP_DEBUG_REGS
-		fprintf( stderr, "Debug: %d removes address %p (global table entry %lu).\n", data->bsp_id, search_address, globalIndex );
+			fprintf( stderr, "Debug: %d removes address %p (global table entry %lu).\n", data->bsp_id, search_address, globalIndex );
 #endif
 
-		//sanity check
-		if( globalIndex == SIZE_MAX ) {
-			fprintf( stderr, "Warning: tried to de-register a non-registered variable. The corresponding call to bsp_pop_reg will have no effect.\n" );
-		} else {
-			//delete entry from table
-			if( !mcbsp_util_address_table_delete( &(data->init->global2local), globalIndex, data->bsp_id ) ) {
-				//there are still other registrations active. Do not delete from map later on.
-				((void **)(data->localsToRemove.array))[ i ] = NULL;
-			} //otherwise we should delete, but after the next barrier
-
-			//register globalIndex now is free
-			if( data->localC == globalIndex + 1 ) {
-				--(data->localC);
+			//sanity check
+			if( globalIndex == SIZE_MAX ) {
+				fprintf( stderr, "Warning: tried to de-register a non-registered variable. The corresponding call to bsp_pop_reg will have no effect.\n" );
 			} else {
-				mcbsp_util_stack_push( &(data->removedGlobals), (const void *)(&globalIndex) );
+				//delete entry from table
+				if( !mcbsp_util_address_table_delete( &(data->init->global2local), globalIndex, data->bsp_id ) ) {
+					//there are still other registrations active. Do not delete from map later on.
+					((void **)(data->localsToRemove.array))[ i ] = NULL;
+				} //otherwise we should delete, but after the next barrier
+
+				//register globalIndex now is free
+				if( data->localC == globalIndex + 1 ) {
+					--(data->localC);
+				} else {
+					mcbsp_util_stack_push( &(data->removedGlobals), (const void *)(&globalIndex) );
+				}
 			}
-		}
 
 #ifdef MCBSP_DEBUG_REGS
-		fprintf( stderr, "Debug: %d has local registration count %ld and a removedGlobals stack size of %ld.\n", data->bsp_id, data->localC, data->removedGlobals.top );
+			fprintf( stderr, "Debug: %d has local registration count %ld and a removedGlobals stack size of %ld.\n", data->bsp_id, data->localC, data->removedGlobals.top );
 #endif
-	}
+		}
 
-	//coordinate exit using the same mutex (but not same condition!)
+		//coordinate exit using the same mutex (but not same condition!)
 #ifdef MCBSP_USE_SPINLOCK
-	mcbsp_internal_spinlock( data->init, data->init->sl_mid_condition, (size_t)(data->bsp_id) );
+		mcbsp_internal_spinlock( data->init, data->init->sl_mid_condition, (size_t)(data->bsp_id) );
 #else
-	mcbsp_internal_sync( data->init, &(data->init->mid_condition) );
+		mcbsp_internal_sync( data->init, &(data->init->mid_condition) );
 #endif
 
-	//hard invalidate / barrier, although invalidation targeting the
-	//variable registration as well as the communication request
-	//queue (get translation into put) should be enough. A rewrite
-	//of the global variable registration may make this issue a lot
-	//more transparent than it is currently; FIXME.
-	mcbsp_nocc_purge_all();
-	mcbsp_nocc_wait_for_flush();
+		//hard invalidate / barrier, although invalidation targeting the
+		//variable registration should be enough. A rewrite of the global
+		//variable registration may make this issue a lot more transparent
+		//than it is currently; FIXME.
+		mcbsp_nocc_purge_all();
+		mcbsp_nocc_wait_for_flush();
+
+		//no one inspects our get ranges anymore
+		data->get_low = data->get_high = NULL;
 
-	//handle pop_regs: loop over all locals, without destroying the stacks
-	while( !mcbsp_util_stack_empty( &(data->localsToRemove) ) ) {
-		void * const toRemove = *(void**)mcbsp_util_stack_pop( &(data->localsToRemove) );
-		//NOTE: this is safe, since it is guaranteed that this address table entry
-		//	will not change during synchronisation.
+		//handle pop_regs: loop over all locals, without destroying the stacks
+		while( !mcbsp_util_stack_empty( &(data->localsToRemove) ) ) {
+			void * const toRemove = *(void**)mcbsp_util_stack_pop( &(data->localsToRemove) );
+			//NOTE: this is safe, since it is guaranteed that this address table entry
+			//	will not change during synchronisation.
 
-		//delete from map, if address was not NULL
-		if( toRemove != NULL ) {
+			//delete from map, if address was not NULL
+			if( toRemove != NULL ) {
 
 #ifdef MCBSP_DEBUG_REGS
-		fprintf( stderr, "Debug: %d removes address %p from local2global map.\n", data->bsp_id, toRemove );
+			fprintf( stderr, "Debug: %d removes address %p from local2global map.\n", data->bsp_id, toRemove );
 #endif
 
-			mcbsp_util_address_map_remove( &(data->local2global), toRemove );
+				mcbsp_util_address_map_remove( &(data->local2global), toRemove );
+			}
 		}
-	}
 
-	//handle push_reg after sync to avoid races on the internal table when NULL pointers exist
-	for( size_t i = 0; i < data->localsToPush.top; ++i ) {
-		//get array
-		const struct mcbsp_push_request * const array = 
-			(struct mcbsp_push_request *)data->localsToPush.array;
-		//get address
-		const struct mcbsp_push_request request = array[ i ];
-		void * const address = request.address;
-
-		//get size
-		const size_t size = ((size_t)request.size);
-
-		//set initial search targets
-		void * search_address = address;
-		const struct mcbsp_util_address_map * search_map = &(data->local2global);
-
-		//check for NULL-pointers; if found, change search targets
-		if( address == NULL ) {
-			//search for a neighbour with a non-NULL entry
-			size_t s;
-			const struct mcbsp_push_request * array2 = NULL;
-			for( s = 0; s < data->init->P; ++s ) {
-				array2 = (struct mcbsp_push_request *)data->init->threadData[ s ]->localsToPush.array;
-				if( array2[ i ].address != NULL ) //bingo!
-					break;
-			}
-			//check if we did find a neighbour
+		//handle push_reg after sync to avoid races on the internal table when NULL pointers exist
+		for( size_t i = 0; i < data->localsToPush.top; ++i ) {
+			//get array
+			const struct mcbsp_push_request * const array = 
+				(struct mcbsp_push_request *)data->localsToPush.array;
+			//get address
+			const struct mcbsp_push_request request = array[ i ];
+			void * const address = request.address;
+
+			//get size
+			const size_t size = ((size_t)request.size);
+
+			//set initial search targets
+			void * search_address = address;
+			const struct mcbsp_util_address_map * search_map = &(data->local2global);
+
+			//check for NULL-pointers; if found, change search targets
+			if( address == NULL ) {
+				//search for a neighbour with a non-NULL entry
+				size_t s;
+				const struct mcbsp_push_request * array2 = NULL;
+				for( s = 0; s < data->init->P; ++s ) {
+					array2 = (struct mcbsp_push_request *)data->init->threadData[ s ]->localsToPush.array;
+					if( array2[ i ].address != NULL ) //bingo!
+						break;
+				}
+				//check if we did find a neighbour
 #ifndef MCBSP_NO_CHECKS
-			if( s == data->init->P ) {
-				//this is an all-NULL registration. Ignore
-				fprintf( stderr, "Warning: tried to register a NULL-address on all processes!\n" );
-				continue;
-			}
+				if( s == data->init->P ) {
+					//this is an all-NULL registration. Ignore
+					fprintf( stderr, "Warning: tried to register a NULL-address on all processes!\n" );
+					continue;
+				}
 #endif
-			//do logic using data from process s instead of local process
-			search_address = array2[ i ].address;
-			search_map     = &(data->init->threadData[ s ]->local2global);
-		}
+				//do logic using data from process s instead of local process
+				search_address = array2[ i ].address;
+				search_map     = &(data->init->threadData[ s ]->local2global);
+			}
 
-		//get global index of this registration. First check map if the key already existed
-		const unsigned long int mapSearch = mcbsp_util_address_map_get( search_map, search_address );
+			//get global index of this registration. First check map if the key already existed
+			const unsigned long int mapSearch = mcbsp_util_address_map_get( search_map, search_address );
 
-		//if the key was not found, create a new global entry
-		const unsigned long int global_number = mapSearch != ULONG_MAX ? mapSearch :
-								mcbsp_util_stack_empty( &(data->removedGlobals) ) ?
-								data->localC++ :
-								*(unsigned long int*)mcbsp_util_stack_pop( &(data->removedGlobals) );
+			//if the key was not found, create a new global entry
+			const unsigned long int global_number = mapSearch != ULONG_MAX ? mapSearch :
+									mcbsp_util_stack_empty( &(data->removedGlobals) ) ?
+									data->localC++ :
+									*(unsigned long int*)mcbsp_util_stack_pop( &(data->removedGlobals) );
 
-		//insert value, global2local map (false sharing is possible here, but effects should be negligable)
-		mcbsp_util_address_table_set( &(data->init->global2local), global_number, data->bsp_id, address, size );
+			//hand out the global index as memory slot, if requested
+			if( request.slot != NULL ) {
+				*(request.slot) = (bsp_memslot_t)global_number;
+			}
+
+			//insert value, global2local map (false sharing is possible here, but effects should be negligable)
+			mcbsp_util_address_table_set( &(data->init->global2local), global_number, data->bsp_id, address, size );
 
 #ifdef MCBSP_DEBUG_REGS
-		fprintf( stderr, "Debug: %d adds %p to global ID %lu in address table.\n", data->bsp_id, address, global_number );
+			fprintf( stderr, "Debug: %d adds %p to global ID %lu in address table.\n", data->bsp_id, address, global_number );
 #endif
 
-		//insert value in local2global map (if this is a new global entry), but not if NULL pointer
-		//the actual insertion happens after the next barrier, since the above code may consult
-		//other processor's local2global map (see also handling of the bsp_pop_reg requests).
-		if( mapSearch == ULONG_MAX && address != NULL ) {
-			mcbsp_util_stack_push( &(data->globalsToPush), &global_number );
-		} else {
-			((struct mcbsp_push_request *)data->localsToPush.array)[ i ].address = NULL;
-		}
+			//insert value in local2global map (if this is a new global entry), but not if NULL pointer
+			//the actual insertion happens after the next barrier, since the above code may consult
+			//other processor's local2global map (see also handling of the bsp_pop_reg requests).
+			if( mapSearch == ULONG_MAX && address != NULL ) {
+				mcbsp_util_stack_push( &(data->globalsToPush), &global_number );
+			} else {
+				((struct mcbsp_push_request *)data->localsToPush.array)[ i ].address = NULL;
+			}
 
-	}
+		}
 
-	//update tagsize, phase 2 (check)
+		//update tagsize, phase 2 (check)
 #ifndef MCBSP_NO_CHECKS
-	if( data->newTagSize != data->init->tagSize ) {
-		fprintf( stderr, "Different tag sizes requested from different processes (%lu requested while process 0 requested %lu)!\n",
-			(unsigned long int)(data->newTagSize),
-			(unsigned long int)(data->init->tagSize)
-		);
-		mcbsp_util_fatal();
-	}
+		if( data->newTagSize != data->init->tagSize ) {
+			fprintf( stderr, "Different tag sizes requested from different processes (%lu requested while process 0 requested %lu)!\n",
+				(unsigned long int)(data->newTagSize),
+				(unsigned long int)(data->init->tagSize)
+			);
+			mcbsp_util_fatal();
+		}
 #endif
+
+	} //end of the synchronisation of (de-)registrations, tag sizes, and gets
 	
-	//now process requests to local destination
-	for( size_t k = 0; k < data->init->P; ++k ) {
+	//take over the outboxes of the processes that queued anything for us; no one
+	//adds to this list before the superstep after next. Handle them in the order
+	//of their senders, so that the outcome of conflicting puts does not depend
+	//on timing
+	struct mcbsp_util_stack * const active = &(data->active);
+	for( struct mcbsp_outbox * box = data->senders[ parity ]; box != NULL; box = box->next ) {
+		mcbsp_util_stack_push( active, &box );
+	}
+	data->senders[ parity ] = NULL;
+	struct mcbsp_outbox * const * const boxes = active->array;
+	const size_t senders = active->top;
+	if( senders > 1 ) {
+		qsort( active->array, senders, sizeof( struct mcbsp_outbox * ), mcbsp_internal_outbox_compare );
+	}
 #ifdef MCBSP_CA_SYNC
-		//do round-robin sync
-		const size_t s = (k + data->bsp_id) % data->init->P;
+	//do round-robin sync, starting from our own process ID
+	size_t first = 0;
+	while( first < senders && boxes[ first ]->source < data->bsp_id ) {
+		++first;
+	}
 #else
-		const size_t s = k;
-#endif
-		//handle queue for hp-BSMP items
-		struct mcbsp_util_stack * const hpqueue =
-			&(data->init->threadData[ s ]->hpsend_queues[ data->bsp_id ]);
-		//each message in this queue is directed at us; handle them
-		while( !mcbsp_util_stack_empty( hpqueue ) ) {
-			//pop hpsend request from outgoing stack
-			const struct mcbsp_hpsend_request * const request =
-				(struct mcbsp_hpsend_request *) mcbsp_util_stack_pop( hpqueue );
-			//add payload to bsmp queue
-			mcbsp_util_varstack_push( &(data->bsmp), request->payload, request->payload_size );
-			//add tag to bsmp queue
-			mcbsp_util_varstack_push( &(data->bsmp), request->tag, data->init->tagSize );
-			//record length of payload
-			mcbsp_util_varstack_regpush( &(data->bsmp), &(request->payload_size) );
-#if MCBSP_MODE == 3
-			//record profile
-			const size_t metadata = sizeof(struct mcbsp_hpsend_request);
-			data->superstep_stats.bytes_received     += request->payload_size + metadata;
-			data->superstep_stats.metabytes_received += metadata;
-#endif
-		} //go to next hpsend request
-
-		//put and get requests handled here
-		struct mcbsp_util_stack * const queue = &(data->init->threadData[ s ]->queues[ data->bsp_id ]);
-		//each request in queue is directed to us. Handle all of them.
-		while( !mcbsp_util_stack_empty( queue ) ) {
-			struct mcbsp_message * const request = (struct mcbsp_message*) mcbsp_util_varstack_regpop( queue );
-			if( request->destination == NULL ) {
-				//get tag and payload from queue
-				const void * const tag     = mcbsp_util_varstack_pop( queue, data->init->tagSize );
-				const void * const payload = mcbsp_util_varstack_pop( queue, request->length );
-				//push payload
-				mcbsp_util_varstack_push( &(data->bsmp), payload, request->length );
-				//push tag
-				mcbsp_util_varstack_push( &(data->bsmp), tag, data->init->tagSize );
-				//push payload size
-				mcbsp_util_varstack_regpush( &(data->bsmp), &(request->length) );
-			} else {
-				//copy payload to destination
-				mcbsp_util_memcpy(
-					request->destination,
-					mcbsp_util_varstack_pop( queue, request->length ),
-					request->length
-				);
-			}
-#if MCBSP_MODE == 3
-			//record profile
-			const size_t metadata = sizeof(struct mcbsp_message);
-			data->superstep_stats.bytes_received     += request->length + data->init->tagSize + metadata;
-			data->superstep_stats.metabytes_received += metadata;
+	const size_t first = 0;
 #endif
+
+	//communication that reads straight from the memory of its source goes first:
+	//that memory may itself be the destination of a buffered put, which must
+	//not land before every unbuffered read of the old value completed
+	if( unbuffered ) {
+		for( size_t k = 0; k < senders; ++k ) {
+			mcbsp_internal_receive_unbuffered( data, boxes[ (first + k) % senders ], parity );
 		}
+#ifdef MCBSP_USE_SPINLOCK
+		mcbsp_internal_spinlock( data->init, data->init->sl_mid_condition, (size_t)(data->bsp_id) );
+#else
+		mcbsp_internal_sync( data->init, &(data->init->mid_condition) );
+#endif
+	}
+
+	//now process requests to local destination
+	for( size_t k = 0; k < senders; ++k ) {
+		struct mcbsp_outbox * const box = boxes[ (first + k) % senders ];
+		//all requests in box are handled below; its sender only uses it
+		//again in the superstep after next
+		box->listed = false;
+		mcbsp_internal_receive_from( data, box );
 	} //go to next processors' outgoing queues
+	active->top = 0;
+
+	//order the received messages, if requested
+	if( data->bsmp_buckets > 0 ) {
+		mcbsp_internal_sort_messages( data );
+	}
+
+	//our memory is now in its final state for this superstep; since senders
+	//buffer their data, they may already be computing the next superstep and
+	//switch to the other set of queues
+	__atomic_store_n( &(data->delivered), data->superstep + 1, __ATOMIC_RELEASE );
+	++(data->superstep);
+
+	//unbuffered sources may only change after their receivers copied them,
+	//which the barrier that closed the unbuffered phase guarantees
+	data->sources_pending = false;
+
+	if( full ) {
 
 #ifdef MCBSP_WITH_DMTCP
-	//get currently active checkpoint frequency
-	const size_t cp_frequency = data->init->safe_cp ? 
-		data->init->safe_cp_f : 
-		data->init->cp_f;
-	//if (automatic) checkpoiting was not disabled
-	if( data->init->no_cp == false && cp_frequency > 0 ) {
-		//check if we need to do automatic checkpointing
-		if( data->init->skipped_checkpoints >= cp_frequency ) {
-			//wait until everyone's communication is done
- #ifdef MCBSP_USE_SPINLOCK
-			mcbsp_internal_spinlock( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
- #else
-			mcbsp_internal_sync( data->init, &(data->init->condition) );
- #endif
-			//then checkpoint
-			if( data->bsp_id == 0 ) {
-				data->init->skipped_checkpoints = 0;
-				mcbsp_internal_call_checkpoint();
+		//get currently active checkpoint frequency
+		const size_t cp_frequency = data->init->safe_cp ? 
+			data->init->safe_cp_f : 
+			data->init->cp_f;
+		//if (automatic) checkpoiting was not disabled
+		if( data->init->no_cp == false && cp_frequency > 0 ) {
+			//check if we need to do automatic checkpointing
+			if( data->init->skipped_checkpoints >= cp_frequency ) {
+				//wait until everyone's communication is done
+	 #ifdef MCBSP_USE_SPINLOCK
+				mcbsp_internal_spinlock( data->init, data->init->sl_condition, (size_t)(data->bsp_id) );
+	 #else
+				mcbsp_internal_sync( data->init, &(data->init->condition) );
+	 #endif
+				//then checkpoint
+				if( data->bsp_id == 0 ) {
+					data->init->skipped_checkpoints = 0;
+					mcbsp_internal_call_checkpoint();
+				}
+				//leave exit sync to regular bsp_sync code, below
 			}
-			//leave exit sync to regular bsp_sync code, below
 		}
-	}
 #endif
 
-	//final sync
+		//final sync
 #ifdef MCBSP_USE_SPINLOCK
-	mcbsp_internal_spinlock( data->init, data->init->sl_end_condition, (size_t)(data->bsp_id) );
+		mcbsp_internal_spinlock( data->init, data->init->sl_end_condition, (size_t)(data->bsp_id) );
 #else
-	mcbsp_internal_sync( data->init, &(data->init->end_condition) );
+		mcbsp_internal_sync( data->init, &(data->init->end_condition) );
 #endif
 
-	//hard invalidate / barrier, although invalidation targeting only the
-	//variable registration should be enough
-	mcbsp_nocc_purge_all();
-	mcbsp_nocc_wait_for_flush();
+		//hard invalidate / barrier, although invalidation targeting only the
+		//variable registration should be enough
+		mcbsp_nocc_purge_all();
+		mcbsp_nocc_wait_for_flush();
 
-	//final processing of push_regs
-	while( !mcbsp_util_stack_empty( &(data->localsToPush) ) ) {
+		//final processing of push_regs
+		while( !mcbsp_util_stack_empty( &(data->localsToPush) ) ) {
 
-		//get push request
-		const struct mcbsp_push_request request =
-			*(struct mcbsp_push_request *) mcbsp_util_stack_pop( &(data->localsToPush ) );
+			//get push request
+			const struct mcbsp_push_request request =
+				*(struct mcbsp_push_request *) mcbsp_util_stack_pop( &(data->localsToPush ) );
 
-		//get address
-		void * const address = request.address;
+			//get address
+			void * const address = request.address;
 
-		//ignore NULL addresses
-		if( address == NULL ) {
-			continue;
-		}
+			//ignore NULL addresses
+			if( address == NULL ) {
+				continue;
+			}
 
-		//get global number as derived earlier
-		assert( !mcbsp_util_stack_empty( &(data->globalsToPush ) ) );
-		const unsigned long int global_number = *(unsigned long int*)mcbsp_util_stack_pop( &(data->globalsToPush) );
+			//get global number as derived earlier
+			assert( !mcbsp_util_stack_empty( &(data->globalsToPush ) ) );
+			const unsigned long int global_number = *(unsigned long int*)mcbsp_util_stack_pop( &(data->globalsToPush) );
 
 #ifdef MCBSP_DEBUG_REGS
-		fprintf( stderr, "Debug: %d maps address %p to global ID %lu.\n", data->bsp_id, address, global_number );
+			fprintf( stderr, "Debug: %d maps address %p to global ID %lu.\n", data->bsp_id, address, global_number );
+#endif
+
+			//add to address and corresponding global index to local2global map
+			mcbsp_util_address_map_insert( &(data->local2global), address, global_number );
+
+#ifdef MCBSP_NUMA_BIND_REGISTERED
+			//the area is mostly accessed by ourselves, so keep it on our node
+			mcbsp_util_numa_bind( address, request.size, data->numa_node );
 #endif
+		} //go to next address to register
 
-		//add to address and corresponding global index to local2global map
-		mcbsp_util_address_map_insert( &(data->local2global), address, global_number );
-	} //go to next address to register
+	} //end of the second synchronisation
+
+	//all receivers are done with the plans executed during the superstep just ended
+	data->plan_sets[ parity ].top = 0;
 
 #if MCBSP_MODE == 3
 	//end communication phase timing
-	data->superstep_stats.communication = mcbsp_internal_time( data ) - comm_start;
+	data->superstep_stats.communication = mcbsp_internal_time( data ) - data->sync_start;
 	//push current profile data
 	mcbsp_util_stack_push( &(data->profile), &(data->superstep_stats) );
 	//record new time for compute phase start
 	data->superstep_start_time = mcbsp_internal_time( data );
 	mcbsp_internal_init_superstep_stats( &(data->superstep_stats), data->init->current_superstep );
 #endif
+}
+
+void MCBSP_FUNCTION_PREFIX(sync)( void ) {
+	//get local data
+	struct mcbsp_thread_data * const data = pthread_getspecific( mcbsp_internal_thread_data );
+
+	//do both halves at once
+	mcbsp_internal_sync_begin( data );
+	mcbsp_internal_sync_end( data );
 } //end synchronisation
 
+void MCBSP_FUNCTION_PREFIX(sync_begin)( void ) {
+	//get local data
+	struct mcbsp_thread_data * const data = pthread_getspecific( mcbsp_internal_thread_data );
+
+	mcbsp_internal_sync_begin( data );
+}
+
+void MCBSP_FUNCTION_PREFIX(sync_end)( void ) {
+	//get local data
+	struct mcbsp_thread_data * const data = pthread_getspecific( mcbsp_internal_thread_data );
+
+#ifndef MCBSP_NO_CHECKS
+	if( !data->sync_begun ) {
+		bsp_abort( "Error: bsp_sync_end called without a matching bsp_sync_begin!\n" );
+	}
+#endif
+	mcbsp_internal_sync_end( data );
+}
+
 double MCBSP_FUNCTION_PREFIX(time)( void ) {
 	//get init data
 	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
@@ -1035,22 +1520,149 @@ void MCBSP_FUNCTION_PREFIX(push_reg)( void * const address, const bsp_size_t siz
 	toPush.address = address;
 	toPush.size    = size;
 
+	toPush.slot    = NULL;
+
 	//push the request
 	mcbsp_util_stack_push( &(data->localsToPush), (void*)(&toPush) );
 }
 
-void MCBSP_FUNCTION_PREFIX(pop_reg)( void * const address ) {
+void MCBSP_FUNCTION_PREFIX(push_reg_slot)( void * const address, const bsp_size_t size_in, bsp_memslot_t * const slot ) {
 	//get init data
 	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
 
-#ifdef MCBSP_DEBUG_REGS
-	fprintf( stderr, "Debug: %d de-registers address %p.\n", data->bsp_id, address );
+#if MCBSP_MODE == 3
+	++(data->superstep_stats.bookkeeping);
+#endif
+
+#ifdef MCBSP_DEBUG_REGS
+	fprintf( stderr, "Debug: %d registers address %p with size %lu and a memory slot.\n", data->bsp_id, address, (unsigned long int)(size_in) );
+#endif
+
+	//construct the push request; the slot is filled in during the next bsp_sync
+	struct mcbsp_push_request toPush;
+	toPush.address = address;
+	toPush.size    = (size_t) size_in;
+	toPush.slot    = slot;
+
+	//push the request
+	mcbsp_util_stack_push( &(data->localsToPush), (void*)(&toPush) );
+}
+
+void MCBSP_FUNCTION_PREFIX(pop_reg)( void * const address ) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifdef MCBSP_DEBUG_REGS
+	fprintf( stderr, "Debug: %d de-registers address %p.\n", data->bsp_id, address );
 #endif
 
 	//register for removal
 	mcbsp_util_stack_push( &(data->localsToRemove), (const void *)(&address) );
 }
 
+/**
+ * Buffers a put with a resolved destination into the queue towards pid.
+ * Shared by bsp_put and the replay of recorded bsp_puts.
+ */
+static inline void mcbsp_internal_buffer_put( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const void * const source, const struct mcbsp_message * const request
+) {
+#if MCBSP_MODE == 3
+	const size_t metadata_size  = sizeof( struct mcbsp_message );
+	++(data->superstep_stats.put);
+	data->superstep_stats.bytes_buffered += request->length;
+	data->superstep_stats.bytes_sent     += request->length + metadata_size;
+	data->superstep_stats.metabytes_sent += metadata_size;
+	const double buffer_start = mcbsp_internal_time( data );
+#endif
+
+	//the first request to pid this superstep adds us to the senders of pid
+	struct mcbsp_util_arena * const queue = &(mcbsp_internal_outbox( data, (size_t)pid )->queue);
+
+	//record payload
+	mcbsp_util_arena_push( queue, source, request->length );
+
+#if MCBSP_MODE == 3
+	data->superstep_stats.buffering += mcbsp_internal_time( data ) - buffer_start;
+#endif
+
+	//record request header
+	mcbsp_util_arena_regpush( queue, request );
+}
+
+/**
+ * Records a put with resolved addresses into a communication plan. Buffered
+ * puts are buffered again on every execution of the plan; all others are
+ * copied by their receivers straight from the source.
+ */
+static void mcbsp_internal_record_put( struct mcbsp_plan * const plan, const bsp_pid_t pid,
+	const void * const source, void * const destination, const size_t size, const bool buffered
+) {
+	if( buffered ) {
+		const struct mcbsp_plan_put put = { (size_t)pid, source, destination, size };
+		mcbsp_util_stack_push( &(plan->buffered), &put );
+		return;
+	}
+	const struct mcbsp_hp_request request = { source, destination, size, false };
+	if( mcbsp_util_stack_empty( &(plan->puts[ pid ]) ) ) {
+		const size_t target = (size_t)pid;
+		mcbsp_util_stack_push( &(plan->targets), &target );
+	}
+	mcbsp_util_stack_push( &(plan->puts[ pid ]), &request );
+}
+
+/**
+ * Queues a bsp_put, after the destination has been resolved to a global
+ * registration index. Shared by bsp_put and bsp_put_slot.
+ */
+static inline void mcbsp_internal_put( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const void * const source, const size_t globalIndex,
+	const size_t offset, const size_t size
+) {
+	//build request
+	struct mcbsp_message request;
+
+	//sanity checks
+	assert( (size_t)pid < data->init->P );
+
+	//get entry from address table
+	const struct mcbsp_util_address_table_entry * const entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
+
+	//sanity checks
+#ifndef MCBSP_NO_CHECKS
+	if( entry == NULL ) {
+		fprintf( stderr, "Error: bsp_put called with an erroneously registered destination variable!\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+	if( offset + size > entry->size ) {
+		fprintf( stderr, "Error: bsp_put would go out of bounds at destination processor (offset=%lu, size=%lu, while registered memory area is %lu bytes)!\n", (unsigned long int)offset, (unsigned long int)size, (unsigned long int)(entry->size) );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+	if( entry->address == NULL ) {
+		fprintf( stderr, "Error: communication attempted on NULL-registered variable!\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+	if( source == NULL ) {
+		fprintf( stderr, "Error: communication of NULL memory address requested.\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+
+	//record final destination address
+	request.destination = ((char*)(entry->address)) + offset;
+
+	//record length
+	request.length = size;
+
+	//add to the communication plan being recorded, if any
+	if( data->recording != NULL ) {
+		mcbsp_internal_record_put( data->recording, pid, source, request.destination, size, true );
+	}
+
+	//copy payload and header into the queue
+	mcbsp_internal_buffer_put( data, pid, source, &request );
+}
+
 void MCBSP_FUNCTION_PREFIX(put)(
 	const bsp_pid_t pid, const void * const source,
 	const void * const destination, const bsp_size_t offset_in,
@@ -1077,8 +1689,258 @@ void MCBSP_FUNCTION_PREFIX(put)(
 	}
 #endif
 
+	//record destination; get global index from local map
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), destination );
+
+	//sanity checks
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		fprintf( stderr, "Error: bsp_put into unregistered memory area (%p) requested!\n", destination );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}	
+#endif
+
+	//queue the request
+	mcbsp_internal_put( data, pid, source, globalIndex, offset, size );
+}
+
+void MCBSP_FUNCTION_PREFIX(put_slot)(
+	const bsp_pid_t pid, const void * const source,
+	const bsp_memslot_t slot, const bsp_size_t offset_in,
+	const bsp_size_t size_in
+) {
+	//catch border cases
+	if( size_in == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	//sanity checks
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: bsp_put_slot called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+			(size_t)pid, data->init->P );
+	}
+	if( (size_t)slot >= data->init->global2local.cap ) {
+		bsp_abort( "Error: bsp_put_slot called with an invalid memory slot (%zd)!\n", (size_t)slot );
+	}
+#endif
+
+	//the slot is the global registration index
+	mcbsp_internal_put( data, pid, source, (size_t)slot, (size_t)offset_in, (size_t)size_in );
+}
+
+void MCBSP_FUNCTION_PREFIX(put_many)(
+	const void * const source, const void * const destination,
+	const struct bsp_transfer * const transfers, const size_t count
+) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+	//get global index from local map, once for all transfers
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), destination );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		fprintf( stderr, "Error: bsp_put_many into unregistered memory area (%p) requested!\n", destination );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+
+	//queue each transfer
+	for( size_t i = 0; i < count; ++i ) {
+		const struct bsp_transfer * const transfer = transfers + i;
+		if( transfer->size == 0 ) {
+			continue;
+		}
+#ifndef MCBSP_NO_CHECKS
+		if( (size_t)(transfer->pid) >= data->init->P ) {
+			bsp_abort( "Error: bsp_put_many called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+				(size_t)(transfer->pid), data->init->P );
+		}
+#endif
+		mcbsp_internal_put( data, transfer->pid, ((const char *)source) + transfer->local_offset,
+			globalIndex, (size_t)(transfer->remote_offset), (size_t)(transfer->size) );
+	}
+}
+
+/**
+ * Resolves the destination of a strided or indexed put at the given process.
+ * Shared by bsp_put_strided and bsp_put_indexed.
+ */
+static inline const struct mcbsp_util_address_table_entry * mcbsp_internal_pattern_destination(
+	const struct mcbsp_thread_data * const data, const bsp_pid_t pid,
+	const void * const destination, const char * const name
+) {
+#ifndef MCBSP_NO_CHECKS
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: %s called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+			name, (size_t)pid, data->init->P );
+	}
+#endif
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), destination );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		fprintf( stderr, "Error: %s into unregistered memory area (%p) requested!\n", name, destination );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+	const struct mcbsp_util_address_table_entry * const entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
+#ifndef MCBSP_NO_CHECKS
+	if( entry == NULL || entry->address == NULL ) {
+		fprintf( stderr, "Error: %s called with an erroneously registered destination variable!\n", name );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+	return entry;
+}
+
+/**
+ * Queues the header of a strided or indexed put whose payload (and offsets)
+ * have already been pushed to the given queue.
+ */
+static inline void mcbsp_internal_pattern_header( struct mcbsp_util_arena * const queue,
+	void * const destination, const struct mcbsp_pattern * const pattern
+) {
+	const struct mcbsp_message request = { destination, MCBSP_PATTERN_LENGTH };
+	mcbsp_util_arena_push( queue, pattern, sizeof(struct mcbsp_pattern) );
+	mcbsp_util_arena_regpush( queue, &request );
+}
+
+void MCBSP_FUNCTION_PREFIX(put_strided)(
+	const bsp_pid_t pid, const void * const source, const bsp_size_t source_stride,
+	const void * const destination, const bsp_size_t offset, const bsp_size_t destination_stride,
+	const bsp_size_t block, const bsp_size_t count
+) {
+	//catch border cases
+	if( block == 0 || count == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
+	//get init data and the remote registration
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	const struct mcbsp_util_address_table_entry * const entry =
+		mcbsp_internal_pattern_destination( data, pid, destination, "bsp_put_strided" );
+
+#ifndef MCBSP_NO_CHECKS
+	if( data->recording != NULL ) {
+		bsp_abort( "Error: bsp_put_strided cannot be recorded in a communication plan!\n" );
+	}
+	if( offset + (count - 1) * destination_stride + block > entry->size ) {
+		fprintf( stderr, "Error: bsp_put_strided would go out of bounds at destination processor (offset=%zd, stride=%zd, block=%zd, count=%zd, while registered memory area is %zd bytes)!\n",
+			(size_t)offset, (size_t)destination_stride, (size_t)block, (size_t)count, entry->size );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+	if( source == NULL ) {
+		fprintf( stderr, "Error: communication of NULL memory address requested.\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+
+#if MCBSP_MODE == 3
+	const size_t metadata_size = sizeof( struct mcbsp_message ) + sizeof( struct mcbsp_pattern );
+	++(data->superstep_stats.put);
+	data->superstep_stats.bytes_buffered += count * block;
+	data->superstep_stats.bytes_sent     += count * block + metadata_size;
+	data->superstep_stats.metabytes_sent += metadata_size;
+#endif
+
+	//the first request to pid this superstep adds us to the senders of pid
+	struct mcbsp_util_arena * const queue = &(mcbsp_internal_outbox( data, (size_t)pid )->queue);
+
+	//pack the blocks into the queue
+	mcbsp_util_memcpy_strided( mcbsp_util_arena_reserve( queue, count * block ), block,
+		source, source_stride, block, count );
+
+	//record how to unpack them; a single block needs no stride, which keeps the indexed marker free
+	const struct mcbsp_pattern pattern = { block, count, count == 1 ? block : destination_stride };
+	mcbsp_internal_pattern_header( queue, ((char*)(entry->address)) + offset, &pattern );
+}
+
+void MCBSP_FUNCTION_PREFIX(put_indexed)(
+	const bsp_pid_t pid, const void * const source, const void * const destination,
+	const bsp_size_t * const offsets, const bsp_size_t block, const bsp_size_t count
+) {
+	//catch border cases
+	if( block == 0 || count == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
+	//get init data and the remote registration
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	const struct mcbsp_util_address_table_entry * const entry =
+		mcbsp_internal_pattern_destination( data, pid, destination, "bsp_put_indexed" );
+
+#ifndef MCBSP_NO_CHECKS
+	if( data->recording != NULL ) {
+		bsp_abort( "Error: bsp_put_indexed cannot be recorded in a communication plan!\n" );
+	}
+	for( size_t i = 0; i < count; ++i ) {
+		if( offsets[ i ] + block > entry->size ) {
+			fprintf( stderr, "Error: bsp_put_indexed would go out of bounds at destination processor (offsets[%zd]=%zd, block=%zd, while registered memory area is %zd bytes)!\n",
+				i, (size_t)(offsets[ i ]), (size_t)block, entry->size );
+			bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+		}
+	}
+	if( source == NULL ) {
+		fprintf( stderr, "Error: communication of NULL memory address requested.\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#endif
+
+#if MCBSP_MODE == 3
+	const size_t metadata_size = sizeof( struct mcbsp_message ) + sizeof( struct mcbsp_pattern ) + count * sizeof( size_t );
+	++(data->superstep_stats.put);
+	data->superstep_stats.bytes_buffered += count * block;
+	data->superstep_stats.bytes_sent     += count * block + metadata_size;
+	data->superstep_stats.metabytes_sent += metadata_size;
+#endif
+
+	//the first request to pid this superstep adds us to the senders of pid
+	struct mcbsp_util_arena * const queue = &(mcbsp_internal_outbox( data, (size_t)pid )->queue);
+
+	//record payload and offsets
+	mcbsp_util_arena_push( queue, source, count * block );
+	mcbsp_util_arena_push( queue, offsets, count * sizeof( size_t ) );
+
+	//record how to unpack them
+	const struct mcbsp_pattern pattern = { block, count, SIZE_MAX };
+	mcbsp_internal_pattern_header( queue, entry->address, &pattern );
+}
+
+void MCBSP_FUNCTION_PREFIX(put_deferred)(
+	const bsp_pid_t pid, const void * const source,
+	const void * const destination, const bsp_size_t offset_in,
+	const bsp_size_t size_in
+) {
+	//catch border cases
+	if( size_in == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
+	//library internals work with size_t only; convert if necessary
+	const size_t offset = (size_t) offset_in;
+	const size_t size   = (size_t) size_in;
+
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	//sanity check
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: bsp_put_deferred called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+			(size_t)pid, data->init->P );
+	}
+#endif
+
 	//build request
-	struct mcbsp_message request;
+	struct mcbsp_hp_request request;
+	request.source_is_remote = false;
 
 	//record destination; get global index from local map
 	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), destination );
@@ -1087,7 +1949,7 @@ void MCBSP_FUNCTION_PREFIX(put)(
 	assert( (size_t)pid < data->init->P );
 #ifndef MCBSP_NO_CHECKS
 	if( globalIndex == ULONG_MAX ) {
-		fprintf( stderr, "Error: bsp_put into unregistered memory area (%p) requested!\n", destination );
+		fprintf( stderr, "Error: bsp_put_deferred into unregistered memory area (%p) requested!\n", destination );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
 	}	
 #endif
@@ -1098,11 +1960,11 @@ void MCBSP_FUNCTION_PREFIX(put)(
 	//sanity checks
 #ifndef MCBSP_NO_CHECKS
 	if( entry == NULL ) {
-		fprintf( stderr, "Error: bsp_put called with an erroneously registered destination variable!\n" );
+		fprintf( stderr, "Error: bsp_put_deferred called with an erroneously registered destination variable!\n" );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
 	}
 	if( offset + size > entry->size ) {
-		fprintf( stderr, "Error: bsp_put would go out of bounds at destination processor (offset=%lu, size=%lu, while registered memory area is %lu bytes)!\n", (unsigned long int)offset, (unsigned long int)size, (unsigned long int)(entry->size) );
+		fprintf( stderr, "Error: bsp_put_deferred would go out of bounds at destination processor (offset=%lu, size=%lu, while registered memory area is %lu bytes)!\n", (unsigned long int)offset, (unsigned long int)size, (unsigned long int)(entry->size) );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
 	}
 	if( entry->address == NULL ) {
@@ -1115,30 +1977,92 @@ void MCBSP_FUNCTION_PREFIX(put)(
 	}
 #endif
 
+	//record source address; its contents are only read during the next bsp_sync
+	request.source = source;
+
 	//record final destination address
 	request.destination = ((char*)(entry->address)) + offset;
 
 	//record length
 	request.length = size;
 
+	//add to the communication plan being recorded, if any
+	if( data->recording != NULL ) {
+		mcbsp_internal_record_put( data->recording, pid, source, request.destination, size, false );
+	}
+
 #if MCBSP_MODE == 3
-	const size_t metadata_size  = sizeof( struct mcbsp_message );
+	const size_t metadata_size  = sizeof( struct mcbsp_hp_request );
 	++(data->superstep_stats.put);
-	data->superstep_stats.bytes_buffered += size;
 	data->superstep_stats.bytes_sent     += size + metadata_size;
 	data->superstep_stats.metabytes_sent += metadata_size;
-	const double buffer_start = mcbsp_internal_time( data );
 #endif
 
-	//record payload
-	mcbsp_util_varstack_push( &(data->queues[ pid ]), source, size );
+	//the first request to pid this superstep adds us to the senders of pid;
+	//record request, the receiver copies from our memory at the end of the superstep
+	mcbsp_util_stack_push( &(mcbsp_internal_outbox( data, (size_t)pid )->deferred), &request );
+	data->sources_pending = true;
+}
 
-#if MCBSP_MODE == 3
-	data->superstep_stats.buffering += mcbsp_internal_time( data ) - buffer_start;
+/**
+ * Queues a bsp_get, after the source has been resolved to a global
+ * registration index. Shared by bsp_get and bsp_get_slot.
+ */
+static inline void mcbsp_internal_get( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const size_t globalIndex, const size_t offset,
+	void * const destination, const size_t size
+) {
+	//build request
+	struct mcbsp_get_request request;
+
+	//get entry from address table, plus sanity checks
+	const struct mcbsp_util_address_table_entry * entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
+#ifndef MCBSP_NO_CHECKS
+	if( entry == NULL ) {
+		fprintf( stderr, "Error: bsp_get called with an erroneously registered source variable!\n" );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
+	}
+	if( offset + size > entry->size ) {
+		fprintf( stderr, "Error: bsp_get would go out of bounds at source processor (offset=%lu, size=%lu, while registered memory area is %lu bytes)!\n", (unsigned long int)offset, (unsigned long int)size, (unsigned long int)(entry->size) );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
+	}
 #endif
+	//record source
+	request.source = ((char*)(entry->address)) + offset;
 
-	//record request header
-	mcbsp_util_varstack_regpush( &(data->queues[ pid ]), &request );
+	//record destination
+	request.destination = destination;
+
+	//record length
+	request.length = size;
+
+	//record source process
+	request.pid = (size_t)pid;
+
+	//track the memory range written by our gets
+	char * const low  = (char*)destination;
+	char * const high = low + size;
+	if( data->get_low == NULL || low < data->get_low ) {
+		data->get_low = low;
+	}
+	if( high > data->get_high ) {
+		data->get_high = high;
+	}
+
+	//record request
+	mcbsp_util_stack_push( &(data->request_queue), &request );
+
+	//add to the communication plan being recorded, if any
+	struct mcbsp_plan * const plan = data->recording;
+	if( plan != NULL ) {
+		mcbsp_util_stack_push( &(plan->gets), &request );
+		if( plan->get_low == NULL || low < plan->get_low ) {
+			plan->get_low = low;
+		}
+		if( high > plan->get_high ) {
+			plan->get_high = high;
+		}
+	}
 }
 
 void MCBSP_FUNCTION_PREFIX(get)( const bsp_pid_t pid, const void * const source,
@@ -1170,9 +2094,6 @@ void MCBSP_FUNCTION_PREFIX(get)( const bsp_pid_t pid, const void * const source,
 	}
 #endif
 
-	//build request
-	struct mcbsp_get_request request;
-
 	//record source address, plus sanity checks
 	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), source );
 #ifndef MCBSP_NO_CHECKS
@@ -1181,59 +2102,170 @@ void MCBSP_FUNCTION_PREFIX(get)( const bsp_pid_t pid, const void * const source,
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
 	}	
 #endif
-	const struct mcbsp_util_address_table_entry * entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
+
+	//queue the request
+	mcbsp_internal_get( data, pid, globalIndex, offset, destination, size );
+}
+
+void MCBSP_FUNCTION_PREFIX(get_many)(
+	const void * const source, void * const destination,
+	const struct bsp_transfer * const transfers, const size_t count
+) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+	//get global index from local map, once for all transfers
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), source );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		fprintf( stderr, "Error: bsp_get_many from unregistered memory area (%p) requested!\n", source );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
+	}
+#endif
+
+	//queue each transfer
+	for( size_t i = 0; i < count; ++i ) {
+		const struct bsp_transfer * const transfer = transfers + i;
+		if( transfer->size == 0 ) {
+			continue;
+		}
+#if MCBSP_MODE == 3
+		++(data->superstep_stats.get);
+#endif
+#ifndef MCBSP_NO_CHECKS
+		if( (size_t)(transfer->pid) >= data->init->P ) {
+			bsp_abort( "Error: bsp_get_many called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+				(size_t)(transfer->pid), data->init->P );
+		}
+#endif
+		mcbsp_internal_get( data, transfer->pid, globalIndex, (size_t)(transfer->remote_offset),
+			((char *)destination) + transfer->local_offset, (size_t)(transfer->size) );
+	}
+}
+
+void MCBSP_FUNCTION_PREFIX(get_strided)(
+	const bsp_pid_t pid, const void * const source, const bsp_size_t offset, const bsp_size_t source_stride,
+	void * const destination, const bsp_size_t destination_stride,
+	const bsp_size_t block, const bsp_size_t count
+) {
+	//catch border cases
+	if( block == 0 || count == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#if MCBSP_MODE == 3
+	++(data->superstep_stats.get);
+#endif
+
+#ifndef MCBSP_NO_CHECKS
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: bsp_get_strided called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+			(size_t)pid, data->init->P );
+	}
+#endif
+
+	//get source registration
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), source );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		fprintf( stderr, "Error: bsp_get_strided from unregistered memory area (%p) requested!\n", source );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
+	}
+#endif
+	const struct mcbsp_util_address_table_entry * const entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
 #ifndef MCBSP_NO_CHECKS
 	if( entry == NULL ) {
-		fprintf( stderr, "Error: bsp_get called with an erroneously registered source variable!\n" );
+		fprintf( stderr, "Error: bsp_get_strided called with an erroneously registered source variable!\n" );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
 	}
-	if( offset + size > entry->size ) {
-		fprintf( stderr, "Error: bsp_get would go out of bounds at source processor (offset=%lu, size=%lu, while registered memory area is %lu bytes)!\n", (unsigned long int)offset, (unsigned long int)size, (unsigned long int)(entry->size) );
+	if( offset + (count - 1) * source_stride + block > entry->size ) {
+		fprintf( stderr, "Error: bsp_get_strided would go out of bounds at source processor (offset=%zd, stride=%zd, block=%zd, count=%zd, while registered memory area is %zd bytes)!\n",
+			(size_t)offset, (size_t)source_stride, (size_t)block, (size_t)count, entry->size );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
 	}
 #endif
-	//record source
-	request.source = ((char*)(entry->address)) + offset;
 
-	//record destination
-	request.destination = destination;
-
-	//record length
-	request.length = size;
+	//build request
+	const struct mcbsp_strided_get_request request = {
+		((char*)(entry->address)) + offset, destination,
+		source_stride, destination_stride, block, count, (size_t)pid
+	};
+
+	//track the memory range written by our gets
+	char * const low  = (char*)destination;
+	char * const high = low + (count - 1) * destination_stride + block;
+	if( data->get_low == NULL || low < data->get_low ) {
+		data->get_low = low;
+	}
+	if( high > data->get_high ) {
+		data->get_high = high;
+	}
 
 	//record request
-	mcbsp_util_stack_push( &(data->request_queues[ data->bsp_id ]), &request );
+	mcbsp_util_stack_push( &(data->strided_gets), &request );
+
+	//add to the communication plan being recorded, if any
+	struct mcbsp_plan * const plan = data->recording;
+	if( plan != NULL ) {
+		mcbsp_util_stack_push( &(plan->strided_gets), &request );
+		if( plan->get_low == NULL || low < plan->get_low ) {
+			plan->get_low = low;
+		}
+		if( high > plan->get_high ) {
+			plan->get_high = high;
+		}
+	}
 }
 
-void MCBSP_FUNCTION_PREFIX(direct_get)( const bsp_pid_t pid, const void * const source,
-        const bsp_size_t offset_in, void * const destination,
-	const bsp_size_t size_in ) {
-	//library internals work with size_t only; convert if necessary
-	const size_t offset = (size_t) offset_in;
-	const size_t size   = (size_t) size_in;
-	
+void MCBSP_FUNCTION_PREFIX(get_slot)( const bsp_pid_t pid, const bsp_memslot_t slot,
+	const bsp_size_t offset_in, void * const destination,
+	const bsp_size_t size_in ) {
+
+	//catch border cases
+	if( size_in == 0 ) {
+		//simply ignore empty communication requests
+		return;
+	}
+
 	//get init data
 	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
 
+#if MCBSP_MODE == 3
+	++(data->superstep_stats.get);
+#endif
+
 #ifndef MCBSP_NO_CHECKS
-	//sanity check
+	//sanity checks
 	if( (size_t)pid >= data->init->P ) {
-		bsp_abort( "Error: bsp_direct_get called with an out-of-range PID argument (%ld, while bsp_nprocs()==%zd)!\n",
+		bsp_abort( "Error: bsp_get_slot called with an out-of-range PID argument (%ld, while bsp_nprocs()==%zd)!\n",
 			(long int)pid, data->init->P );
 	}
-#endif
-
-	//get source address
-	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), source );
-#ifndef MCBSP_NO_CHECKS
-	if( globalIndex == ULONG_MAX ) {
-		bsp_abort( "Error: bsp_direct_get called with unregistered remote address!\n" );
+	if( (size_t)slot >= data->init->global2local.cap ) {
+		bsp_abort( "Error: bsp_get_slot called with an invalid memory slot (%zd)!\n", (size_t)slot );
 	}
 #endif
+
+	//the slot is the global registration index
+	mcbsp_internal_get( data, pid, (size_t)slot, (size_t)offset_in, destination, (size_t)size_in );
+}
+
+/**
+ * Performs a bsp_direct_get, after the source has been resolved to a global
+ * registration index. Shared by bsp_direct_get and bsp_direct_get_slot.
+ */
+static inline void mcbsp_internal_direct_get( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const size_t globalIndex, const size_t offset,
+	void * const destination, const size_t size
+) {
+	//get entry from address table, plus sanity checks
 	const struct mcbsp_util_address_table_entry * entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
 #ifndef MCBSP_NO_CHECKS
 	if( entry == NULL ) {
-		fprintf( stderr, "Error: bsp_direct_get called with an erroneously registered source variable (address %p was never registered remotely)!\n", source );
+		fprintf( stderr, "Error: bsp_direct_get called with an erroneously registered source variable (global index %zd was never registered remotely)!\n", globalIndex );
 		bsp_abort( "Aborting due to BSP primitive call with invalid arguments." );
 	}
 	if( offset + size > entry->size ) {
@@ -1242,6 +2274,9 @@ void MCBSP_FUNCTION_PREFIX(direct_get)( const bsp_pid_t pid, const void * const
 	}
 #endif
 
+	//the remote process may still be handling the communication of the previous superstep
+	mcbsp_internal_wait_delivered( data->init, (size_t)pid, data->superstep );
+
 	//perform direct get, first derive target memory area
 	const char * const from = ((char*)entry->address) + offset;
 	//check if we need to do anything, which is when destination equals source
@@ -1273,6 +2308,246 @@ void MCBSP_FUNCTION_PREFIX(direct_get)( const bsp_pid_t pid, const void * const
 #endif
 }
 
+void MCBSP_FUNCTION_PREFIX(direct_get)( const bsp_pid_t pid, const void * const source,
+        const bsp_size_t offset_in, void * const destination,
+	const bsp_size_t size_in ) {
+	//library internals work with size_t only; convert if necessary
+	const size_t offset = (size_t) offset_in;
+	const size_t size   = (size_t) size_in;
+	
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	//sanity check
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: bsp_direct_get called with an out-of-range PID argument (%ld, while bsp_nprocs()==%zd)!\n",
+			(long int)pid, data->init->P );
+	}
+#endif
+
+	//get source address
+	const unsigned long int globalIndex = mcbsp_util_address_map_get( &(data->local2global), source );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == ULONG_MAX ) {
+		bsp_abort( "Error: bsp_direct_get called with unregistered remote address!\n" );
+	}
+#endif
+
+	//perform the get
+	mcbsp_internal_direct_get( data, pid, globalIndex, offset, destination, size );
+}
+
+void MCBSP_FUNCTION_PREFIX(direct_get_slot)( const bsp_pid_t pid, const bsp_memslot_t slot,
+	const bsp_size_t offset_in, void * const destination,
+	const bsp_size_t size_in ) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	//sanity checks
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: bsp_direct_get_slot called with an out-of-range PID argument (%ld, while bsp_nprocs()==%zd)!\n",
+			(long int)pid, data->init->P );
+	}
+	if( (size_t)slot >= data->init->global2local.cap ) {
+		bsp_abort( "Error: bsp_direct_get_slot called with an invalid memory slot (%zd)!\n", (size_t)slot );
+	}
+#endif
+
+	//the slot is the global registration index
+	mcbsp_internal_direct_get( data, pid, (size_t)slot, (size_t)offset_in, destination, (size_t)size_in );
+}
+
+/**
+ * Resolves the address of a 64-bit word in a memory area registered at
+ * process pid, for use by the one-sided atomics. Waits until that process
+ * has received all communication of the previous superstep.
+ */
+static int64_t * mcbsp_internal_atomic_address( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const void * const variable, const size_t offset,
+	const char * const name ) {
+#ifndef MCBSP_NO_CHECKS
+	if( (size_t)pid >= data->init->P ) {
+		bsp_abort( "Error: %s called with an out-of-range PID argument (%zd, while bsp_nprocs()==%zd)!\n",
+			name, (size_t)pid, (size_t)(data->init->P) );
+	}
+#else
+	(void)name;
+#endif
+
+	//get global index from local map
+	const size_t globalIndex = mcbsp_util_address_map_get( &(data->local2global), variable );
+#ifndef MCBSP_NO_CHECKS
+	if( globalIndex == SIZE_MAX ) {
+		bsp_abort( "Error: %s on unregistered memory area (%p) requested!\n", name, variable );
+	}
+#endif
+
+	//get entry from address table, plus sanity checks
+	const struct mcbsp_util_address_table_entry * const entry = mcbsp_util_address_table_get( &(data->init->global2local), globalIndex, ((size_t)pid) );
+#ifndef MCBSP_NO_CHECKS
+	if( entry == NULL || entry->address == NULL ) {
+		bsp_abort( "Error: %s called on a variable that is not registered at process %zd!\n", name, (size_t)pid );
+	}
+	if( offset + sizeof( int64_t ) > entry->size ) {
+		bsp_abort( "Error: %s would go out of bounds at process %zd (offset=%zd, while registered memory area is %zd bytes)!\n",
+			name, (size_t)pid, offset, (size_t)(entry->size) );
+	}
+#endif
+	char * const address = ((char*)(entry->address)) + offset;
+#ifndef MCBSP_NO_CHECKS
+	if( (uintptr_t)address % sizeof( int64_t ) != 0 ) {
+		bsp_abort( "Error: %s called on an address that is not aligned to %zd bytes!\n", name, sizeof( int64_t ) );
+	}
+#endif
+
+	//the remote process may still be handling the communication of the previous superstep
+	mcbsp_internal_wait_delivered( data->init, (size_t)pid, data->superstep );
+
+	return (int64_t *)address;
+}
+
+int64_t MCBSP_FUNCTION_PREFIX(atomic_fetch_add)( const bsp_pid_t pid, const void * const variable,
+	const bsp_size_t offset, const int64_t value ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	int64_t * const address = mcbsp_internal_atomic_address( data, pid, variable, (size_t)offset, "bsp_atomic_fetch_add" );
+	return __atomic_fetch_add( address, value, __ATOMIC_ACQ_REL );
+}
+
+int64_t MCBSP_FUNCTION_PREFIX(atomic_cas)( const bsp_pid_t pid, const void * const variable,
+	const bsp_size_t offset, const int64_t expected, const int64_t desired ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	int64_t * const address = mcbsp_internal_atomic_address( data, pid, variable, (size_t)offset, "bsp_atomic_cas" );
+	//on failure, the value found is written back into old
+	int64_t old = expected;
+	__atomic_compare_exchange_n( address, &old, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+	return old;
+}
+
+int64_t MCBSP_FUNCTION_PREFIX(atomic_min)( const bsp_pid_t pid, const void * const variable,
+	const bsp_size_t offset, const int64_t value ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	int64_t * const address = mcbsp_internal_atomic_address( data, pid, variable, (size_t)offset, "bsp_atomic_min" );
+	int64_t old = __atomic_load_n( address, __ATOMIC_ACQUIRE );
+	while( value < old && !__atomic_compare_exchange_n( address, &old, value, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) ) {}
+	return old;
+}
+
+int64_t MCBSP_FUNCTION_PREFIX(atomic_max)( const bsp_pid_t pid, const void * const variable,
+	const bsp_size_t offset, const int64_t value ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	int64_t * const address = mcbsp_internal_atomic_address( data, pid, variable, (size_t)offset, "bsp_atomic_max" );
+	int64_t old = __atomic_load_n( address, __ATOMIC_ACQUIRE );
+	while( value > old && !__atomic_compare_exchange_n( address, &old, value, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) ) {}
+	return old;
+}
+
+/** Returned by the work-stealing deque operations when no chunk was obtained. */
+#define MCBSP_LOOP_EMPTY SIZE_MAX
+
+/** Returned by mcbsp_internal_loop_steal when it lost a race and should retry. */
+#define MCBSP_LOOP_RETRY (SIZE_MAX - 1)
+
+/** Takes a chunk from the bottom of our own deque. */
+static size_t mcbsp_internal_loop_take( struct mcbsp_loop_deque * const deque ) {
+	//only we change bottom, and it never drops below top
+	size_t b = deque->bottom;
+	if( b == 0 ) {
+		return MCBSP_LOOP_EMPTY;
+	}
+	--b;
+	__atomic_store_n( &(deque->bottom), b, __ATOMIC_RELAXED );
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	size_t t = __atomic_load_n( &(deque->top), __ATOMIC_RELAXED );
+	if( t > b ) {
+		//the deque was empty already
+		__atomic_store_n( &(deque->bottom), b + 1, __ATOMIC_RELAXED );
+		return MCBSP_LOOP_EMPTY;
+	}
+	if( t < b ) {
+		//thieves cannot reach this chunk
+		return b;
+	}
+	//last chunk: race the thieves for it
+	const bool won = __atomic_compare_exchange_n( &(deque->top), &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED );
+	__atomic_store_n( &(deque->bottom), b + 1, __ATOMIC_RELAXED );
+	return won ? b : MCBSP_LOOP_EMPTY;
+}
+
+/** Steals a chunk from the top of the deque of another process. */
+static size_t mcbsp_internal_loop_steal( struct mcbsp_loop_deque * const deque ) {
+	size_t t = __atomic_load_n( &(deque->top), __ATOMIC_ACQUIRE );
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	const size_t b = __atomic_load_n( &(deque->bottom), __ATOMIC_ACQUIRE );
+	if( t >= b ) {
+		return MCBSP_LOOP_EMPTY;
+	}
+	if( !__atomic_compare_exchange_n( &(deque->top), &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED ) ) {
+		return MCBSP_LOOP_RETRY;
+	}
+	return t;
+}
+
+void MCBSP_FUNCTION_PREFIX(parallel_for)( const bsp_size_t begin, const bsp_size_t end,
+	const bsp_size_t grain_in, const bsp_loop_body_t body, void * const arg ) {
+	//get thread data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	if( body == NULL ) {
+		bsp_abort( "Error: bsp_parallel_for called without a loop body!\n" );
+	}
+#endif
+
+	//derive the chunk size if not given, aiming at a couple of chunks per process
+	const size_t P = data->init->P;
+	const size_t s = data->bsp_id;
+	const size_t n = end > begin ? (size_t)(end - begin) : 0;
+	const size_t grain = grain_in > 0 ? (size_t)grain_in : (n / (8 * P) > 0 ? n / (8 * P) : 1);
+
+	//start out with a static block distribution
+	struct mcbsp_loop_deque * const deques = data->init->loop_deques;
+	struct mcbsp_loop_deque * const own = &(deques[ s ]);
+	const size_t block = n / P;
+	const size_t rest  = n % P;
+	own->begin  = (size_t)begin + s * block + (s < rest ? s : rest);
+	own->end    = own->begin + block + (s < rest ? 1 : 0);
+	own->top    = 0;
+	own->bottom = (own->end - own->begin + grain - 1) / grain;
+
+	//no one steals before all deques are filled
+#ifdef MCBSP_USE_SPINLOCK
+	mcbsp_internal_spinlock( data->init, data->init->sl_condition, s );
+#else
+	mcbsp_internal_sync( data->init, &(data->init->condition) );
+#endif
+
+	//work off our own chunks, then steal from the others until all deques are empty;
+	//no chunks are added after the above barrier, so empty deques remain empty
+	size_t victim = s;
+	size_t empty  = 0;
+	while( empty < P ) {
+		struct mcbsp_loop_deque * const deque = &(deques[ victim ]);
+		const size_t chunk = victim == s ? mcbsp_internal_loop_take( deque ) : mcbsp_internal_loop_steal( deque );
+		if( chunk == MCBSP_LOOP_RETRY ) {
+			continue;
+		}
+		if( chunk == MCBSP_LOOP_EMPTY ) {
+			victim = (victim + 1) % P;
+			++empty;
+			continue;
+		}
+		const size_t lo = deque->begin + chunk * grain;
+		const size_t hi = deque->end - lo > grain ? lo + grain : deque->end;
+		body( (bsp_size_t)lo, (bsp_size_t)hi, arg );
+		empty = 0;
+	}
+
+	//all iterations are done once everyone gets here
+	MCBSP_FUNCTION_PREFIX(sync)();
+}
+
 void MCBSP_FUNCTION_PREFIX(set_tagsize)( bsp_size_t * const size_in ) {
 	//library internals work with size_t only; convert if necessary
 	const size_t size = (size_t) *size_in;
@@ -1291,6 +2566,26 @@ void MCBSP_FUNCTION_PREFIX(set_tagsize)( bsp_size_t * const size_in ) {
 	*size_in = (bsp_size_t) (data->init->tagSize);
 }
 
+void MCBSP_FUNCTION_PREFIX(set_message_buckets)( const bsp_size_t buckets, const bsp_bucket_function_t bucket ) {
+	//get thread data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#if MCBSP_MODE == 3
+	++(data->superstep_stats.bookkeeping);
+#endif
+
+#ifndef MCBSP_NO_CHECKS
+	if( buckets > 0 && bucket == NULL && (size_t)buckets != (size_t)(data->init->P) ) {
+		bsp_abort( "Error: bsp_set_message_buckets without a bucket function requires one bucket per process (%zd buckets requested, while bsp_nprocs()==%zd)!\n",
+			(size_t)buckets, (size_t)(data->init->P) );
+	}
+#endif
+
+	//record new settings; these take effect at the next sync
+	data->new_bsmp_buckets = (size_t) buckets;
+	data->new_bsmp_bucket  = bucket;
+}
+
 void MCBSP_FUNCTION_PREFIX(send)( const bsp_pid_t pid, const void * const tag,
 	const void * const payload, const bsp_size_t size_in ) {
 	//library internals work with size_t only; convert if necessary
@@ -1321,8 +2616,11 @@ void MCBSP_FUNCTION_PREFIX(send)( const bsp_pid_t pid, const void * const tag,
 	const double buffer_start = mcbsp_internal_time( data );
 #endif
 
+	//the first request to pid this superstep adds us to the senders of pid
+	struct mcbsp_util_arena * const queue = &(mcbsp_internal_outbox( data, (size_t)pid )->queue);
+
 	//record payload
-	mcbsp_util_varstack_push( &(data->queues[ pid ]), payload, size );
+	mcbsp_util_arena_push( queue, payload, size );
 
 #if MCBSP_MODE == 3
 	data->superstep_stats.buffering += mcbsp_internal_time( data ) - buffer_start;
@@ -1334,11 +2632,21 @@ void MCBSP_FUNCTION_PREFIX(send)( const bsp_pid_t pid, const void * const tag,
 
 	//record tag
 	if( data->init->tagSize != 0 ) {
-		mcbsp_util_varstack_push( &(data->queues[ pid ]), tag, data->init->tagSize );
+		mcbsp_util_arena_push( queue, tag, data->init->tagSize );
 	}
 
 	//record message header
-	mcbsp_util_varstack_regpush( &(data->queues[ pid ]), &request );	
+	mcbsp_util_arena_regpush( queue, &request );
+
+	//add to the communication plan being recorded, if any
+	struct mcbsp_plan * const plan = data->recording;
+	if( plan != NULL ) {
+		const struct mcbsp_plan_send send = { (size_t)pid, payload, size, plan->tags.top };
+		if( data->init->tagSize != 0 ) {
+			mcbsp_util_varstack_push( &(plan->tags), tag, data->init->tagSize );
+		}
+		mcbsp_util_stack_push( &(plan->sends), &send );
+	}
 }
 
 #ifdef MCBSP_ENABLE_HP_DIRECTIVES
@@ -1368,8 +2676,10 @@ void MCBSP_FUNCTION_PREFIX(hpsend)( const bsp_pid_t pid, const void * const tag,
 	//record length
 	request.payload_size = size;
 
-	//record request
-	mcbsp_util_stack_push( &(data->hpsend_queues[ pid ]), &request );
+	//the first request to pid this superstep adds us to the senders of pid;
+	//record request, the receiver copies from our memory at the end of the superstep
+	mcbsp_util_stack_push( &(mcbsp_internal_outbox( data, (size_t)pid )->hpsends), &request );
+	data->sources_pending = true;
 
 #if MCBSP_MODE == 3
 	++(data->superstep_stats.hpsend);
@@ -1379,6 +2689,24 @@ void MCBSP_FUNCTION_PREFIX(hpsend)( const bsp_pid_t pid, const void * const tag,
 #endif
 }
 
+/**
+ * Handles a bsp_hpput or bsp_hpget request involving the memory of process pid.
+ * BSPlib allows these to complete at any time before the next bsp_sync ends; as
+ * all processes share a single address space, the copy is done right away, unless
+ * MCBSP_NO_IMMEDIATE_HP is defined.
+ */
+static inline void mcbsp_internal_hp_request( struct mcbsp_thread_data * const data,
+	const bsp_pid_t pid, const struct mcbsp_hp_request * const request ) {
+#ifdef MCBSP_IMMEDIATE_HP
+	//the remote process may still be handling the communication of the previous superstep
+	mcbsp_internal_wait_delivered( data->init, (size_t)pid, data->superstep );
+	mcbsp_internal_hp_copy( request );
+#else
+	(void)pid;
+	mcbsp_util_stack_push( &(data->hpdrma_queue), request );
+#endif
+}
+
 void MCBSP_FUNCTION_PREFIX(hpput)( const bsp_pid_t pid, const void * const source,
 	const void * const destination, const bsp_size_t offset_in,
 	const bsp_size_t size_in ) {
@@ -1446,8 +2774,8 @@ void MCBSP_FUNCTION_PREFIX(hpput)( const bsp_pid_t pid, const void * const sourc
 	//record length
 	request.length = size;
 
-	//record payload
-	mcbsp_util_stack_push( &(data->hpdrma_queue), &request );
+	//execute or record request
+	mcbsp_internal_hp_request( data, pid, &request );
 
 #if MCBSP_MODE == 3
 	//record profile
@@ -1531,8 +2859,8 @@ void MCBSP_FUNCTION_PREFIX(hpget)(
 	assert( request.destination != NULL );
 	assert( request.length != 0 );
 
-	//record request
-	mcbsp_util_stack_push( &(data->hpdrma_queue), &request );
+	//execute or record request
+	mcbsp_internal_hp_request( data, pid, &request );
 
 #if MCBSP_MODE == 3
 	//record profile
@@ -1556,34 +2884,52 @@ void MCBSP_FUNCTION_PREFIX(qsize)(
 	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
 #endif
 
-	//check no-messages case
-	if( mcbsp_util_stack_empty( &(data->bsmp) ) ) {
-		*packets = (bsp_nprocs_t) 0;
-		if( accumulated_size != NULL )
-			*accumulated_size = 0;
-		return;
+	//count messages and, if requested, their accumulated sizes
+	*packets = (bsp_nprocs_t) data->bsmp.top;
+	if( accumulated_size != NULL ) {
+		const struct bsp_message * const messages = (const struct bsp_message *) data->bsmp.array;
+		size_t total = 0;
+		for( size_t i = 0; i < data->bsmp.top; ++i ) {
+			total += messages[ i ].size;
+		}
+		*accumulated_size = (bsp_size_t) total;
+	}
+}
+
+void MCBSP_FUNCTION_PREFIX(bucket_qsize)(
+	const bsp_size_t bucket,
+	bsp_nprocs_t * const packets,
+	bsp_size_t * const accumulated_size
+) {
+#if MCBSP_MODE == 3
+	//get thread data, record profile
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	++(data->superstep_stats.non_communicating);
+#else
+	//get thread data
+	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
+#endif
+
+#ifndef MCBSP_NO_CHECKS
+	if( (size_t)bucket >= data->bsmp_buckets ) {
+		bsp_abort( "Error: bsp_bucket_qsize called for bucket %zd, while the last bsp_sync delivered messages into %zd buckets!\n",
+			(size_t)bucket, data->bsmp_buckets );
 	}
+#endif
 
-	//set initial values
-	*packets = 0;
-	if( accumulated_size != NULL )
-		*accumulated_size = 0;
-
-	//loop over all messages
-	const char * raw = (char*)(data->bsmp.array) + data->bsmp.top - sizeof( size_t );
-	do {
-		//if requested, count accumulated message sizes
-		const size_t curmsg_size = *(const size_t*)raw;
-		if( accumulated_size != NULL )
-			*accumulated_size += curmsg_size;
-		//skip payload size, tag size, and payload size fields
-		raw -= curmsg_size + data->init->tagSize + sizeof( size_t );
-		//we skipped one packet
-		++(*packets);
-		//sanity check
-		assert( raw + sizeof( size_t ) >= (char*)(data->bsmp.array) );
-		//continue loop if we did not go past the start of the bsmp array
-	} while( raw + sizeof( size_t ) != (char*)data->bsmp.array );
+	//messages already moved from the top of the queue no longer count
+	const size_t top   = data->bsmp.top;
+	const size_t end   = data->bsmp_starts[ bucket ] < top ? data->bsmp_starts[ bucket ] : top;
+	const size_t start = data->bsmp_starts[ bucket + 1 ] < end ? data->bsmp_starts[ bucket + 1 ] : end;
+	*packets = (bsp_nprocs_t)(end - start);
+	if( accumulated_size != NULL ) {
+		const struct bsp_message * const messages = (const struct bsp_message *) data->bsmp.array;
+		size_t total = 0;
+		for( size_t i = start; i < end; ++i ) {
+			total += messages[ i ].size;
+		}
+		*accumulated_size = (bsp_size_t) total;
+	}
 }
 
 void MCBSP_FUNCTION_PREFIX(move)( void * const payload, const bsp_size_t max_copy_size_in ) {
@@ -1598,11 +2944,10 @@ void MCBSP_FUNCTION_PREFIX(move)( void * const payload, const bsp_size_t max_cop
 		return;
 	}
 
-	//get payload size
-	const size_t size = *(size_t*) mcbsp_util_varstack_regpop( &(data->bsmp) );
-
-	//skip tag
-	mcbsp_util_varstack_pop( &(data->bsmp), data->init->tagSize );
+	//get message
+	const struct bsp_message * const message = (const struct bsp_message *) mcbsp_util_stack_pop( &(data->bsmp) );
+	const size_t size = message->size;
+	++(data->bsmp_generation);
 
 #if MCBSP_MODE == 3
 	const double buffer_start = mcbsp_internal_time( data );
@@ -1610,7 +2955,7 @@ void MCBSP_FUNCTION_PREFIX(move)( void * const payload, const bsp_size_t max_cop
 
 	//copy message
 	const size_t copy_size = size > max_copy_size ? max_copy_size : size;
-	memcpy( payload, mcbsp_util_varstack_pop( &(data->bsmp), size ), copy_size );
+	memcpy( payload, message->payload, copy_size );
 
 #if MCBSP_MODE == 3
 	//record profile
@@ -1638,15 +2983,14 @@ void MCBSP_FUNCTION_PREFIX(get_tag)( bsp_size_t * const status, void * const tag
 
 	} else {
 
-		//get size
-		const size_t size = *((size_t*) mcbsp_util_varstack_regpeek( &(data->bsmp) ));
+		//get message
+		const struct bsp_message * const message = (const struct bsp_message *) mcbsp_util_stack_peek( &(data->bsmp) );
 
 		//set status to payload size
-		*status = (bsp_size_t) size;
+		*status = message->size;
 
-		//copy tag into target memory area: location is the top of the bsmp stack minus the payload size field
-		//(note the last sizeof( size_t ) bytes are not copied; this was the payload length.)
-		memcpy( tag, mcbsp_util_varstack_peek( &(data->bsmp), data->init->tagSize + sizeof( size_t ) ), data->init->tagSize );
+		//copy tag into target memory area
+		memcpy( tag, message->tag, data->init->tagSize );
 
 	}
 }
@@ -1665,17 +3009,175 @@ bsp_size_t MCBSP_FUNCTION_PREFIX(hpmove)( void* * const p_tag, void* * const p_p
 		return ((bsp_size_t)-1);
 	}
 
-	//the data->bsmp stack contains, in this order, the following fields:
-	//-payload size
-	//-the BSMP tag
-	//-the BSMP payload
-	//we now retrieve those:
-	const size_t size = *((size_t*) mcbsp_util_varstack_regpop( &(data->bsmp) ));
-	*p_tag     = mcbsp_util_varstack_pop( &(data->bsmp), data->init->tagSize );
-	*p_payload = mcbsp_util_varstack_pop( &(data->bsmp), size );
+	//the message data stays where the bsmp queue refers to, until the next sync
+	const struct bsp_message * const message = (const struct bsp_message *) mcbsp_util_stack_pop( &(data->bsmp) );
+	++(data->bsmp_generation);
+	*p_tag     = (void*) message->tag;
+	*p_payload = (void*) message->payload;
 
 	//return the payload length, as per the specification
-	return (bsp_size_t) size;
+	return message->size;
+}
+
+void MCBSP_FUNCTION_PREFIX(message_iterator)( bsp_message_iterator_t * const iterator ) {
+	//get thread data
+	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
+
+	//walk in the same order as bsp_move and bsp_hpmove remove messages
+	iterator->remaining  = data->bsmp.top;
+	iterator->generation = data->bsmp_generation;
+}
+
+const struct bsp_message * MCBSP_FUNCTION_PREFIX(next_message)( bsp_message_iterator_t * const iterator ) {
+	//get thread data
+	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	if( iterator->generation != data->bsmp_generation ) {
+		bsp_abort( "Error: bsp_next_message called with an iterator that was invalidated by bsp_move, bsp_hpmove, or bsp_sync!\n" );
+	}
+#endif
+
+	//check for the end of the queue
+	if( iterator->remaining == 0 ) {
+		return NULL;
+	}
+
+	//return a view on the message, without copying anything
+	return ((const struct bsp_message *) data->bsmp.array) + --(iterator->remaining);
+}
+
+void MCBSP_FUNCTION_PREFIX(plan_begin)( void ) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	if( data->recording != NULL ) {
+		bsp_abort( "Error: bsp_plan_begin called while already recording a communication plan!\n" );
+	}
+#endif
+
+	//create an empty plan
+	struct mcbsp_plan * const plan = mcbsp_util_malloc( sizeof( struct mcbsp_plan ), "bsp_plan_begin plan" );
+	plan->P    = data->init->P;
+	plan->puts = mcbsp_util_malloc( plan->P * sizeof( struct mcbsp_util_stack ), "bsp_plan_begin put lists" );
+	for( size_t s = 0; s < plan->P; ++s ) {
+		mcbsp_util_stack_initialise_lazy( &(plan->puts[ s ]), sizeof( struct mcbsp_hp_request ) );
+	}
+	mcbsp_util_stack_initialise( &(plan->targets), sizeof( size_t ) );
+	mcbsp_util_stack_initialise( &(plan->buffered), sizeof( struct mcbsp_plan_put ) );
+	mcbsp_util_stack_initialise( &(plan->gets),    sizeof( struct mcbsp_get_request ) );
+	mcbsp_util_stack_initialise( &(plan->strided_gets), sizeof( struct mcbsp_strided_get_request ) );
+	mcbsp_util_stack_initialise( &(plan->sends),   sizeof( struct mcbsp_plan_send ) );
+	mcbsp_util_stack_initialise( &(plan->tags),    sizeof( char ) );
+	plan->get_low  = NULL;
+	plan->get_high = NULL;
+	plan->tagSize  = data->init->tagSize;
+
+	//start recording
+	data->recording = plan;
+}
+
+bsp_plan_t MCBSP_FUNCTION_PREFIX(plan_end)( void ) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	if( data->recording == NULL ) {
+		bsp_abort( "Error: bsp_plan_end called without a matching bsp_plan_begin!\n" );
+	}
+#endif
+
+	//stop recording
+	struct mcbsp_plan * const ret = data->recording;
+	data->recording = NULL;
+	return ret;
+}
+
+void MCBSP_FUNCTION_PREFIX(execute_plan)( const bsp_plan_t plan ) {
+	//get init data
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+
+#ifndef MCBSP_NO_CHECKS
+	if( plan == NULL ) {
+		bsp_abort( "Error: bsp_execute_plan called with a NULL plan!\n" );
+	}
+	if( plan->P != data->init->P ) {
+		bsp_abort( "Error: bsp_execute_plan called with a plan recorded for %zd processes, while bsp_nprocs()==%zd!\n",
+			plan->P, data->init->P );
+	}
+	if( !mcbsp_util_stack_empty( &(plan->sends) ) && plan->tagSize != data->init->tagSize ) {
+		bsp_abort( "Error: bsp_execute_plan called with a plan recorded under a different tag size!\n" );
+	}
+#endif
+
+	//recorded bsp_puts buffer their sources now, as bsp_put itself does
+	const struct mcbsp_plan_put * const buffered = plan->buffered.array;
+	for( size_t k = 0; k < plan->buffered.top; ++k ) {
+		const struct mcbsp_message request = { buffered[ k ].destination, buffered[ k ].size };
+		mcbsp_internal_buffer_put( data, (bsp_pid_t)(buffered[ k ].pid), buffered[ k ].source, &request );
+	}
+
+	//other puts are not queued at all; their receivers walk the recorded lists,
+	//and only need to find us amongst their senders
+	if( !mcbsp_util_stack_empty( &(plan->targets) ) ) {
+		const size_t * const targets = plan->targets.array;
+		for( size_t k = 0; k < plan->targets.top; ++k ) {
+			(void)mcbsp_internal_outbox( data, targets[ k ] );
+		}
+		mcbsp_util_stack_push( &(data->plan_sets[ data->superstep % 2 ]), &plan );
+		data->sources_pending = true;
+#if MCBSP_MODE == 3
+		for( size_t k = 0; k < plan->targets.top; ++k ) {
+			data->superstep_stats.put += plan->puts[ targets[ k ] ].top;
+		}
+#endif
+	}
+
+	//gets are queued with their addresses resolved
+	if( !mcbsp_util_stack_empty( &(plan->gets) ) || !mcbsp_util_stack_empty( &(plan->strided_gets) ) ) {
+		const struct mcbsp_get_request * const gets = plan->gets.array;
+		for( size_t k = 0; k < plan->gets.top; ++k ) {
+			mcbsp_util_stack_push( &(data->request_queue), gets + k );
+		}
+		const struct mcbsp_strided_get_request * const strided = plan->strided_gets.array;
+		for( size_t k = 0; k < plan->strided_gets.top; ++k ) {
+			mcbsp_util_stack_push( &(data->strided_gets), strided + k );
+		}
+		if( data->get_low == NULL || plan->get_low < data->get_low ) {
+			data->get_low = plan->get_low;
+		}
+		if( plan->get_high > data->get_high ) {
+			data->get_high = plan->get_high;
+		}
+#if MCBSP_MODE == 3
+		data->superstep_stats.get += plan->gets.top + plan->strided_gets.top;
+#endif
+	}
+
+	//sends buffer their payloads as usual
+	const struct mcbsp_plan_send * const sends = plan->sends.array;
+	for( size_t k = 0; k < plan->sends.top; ++k ) {
+		MCBSP_FUNCTION_PREFIX(send)( (bsp_pid_t)(sends[ k ].pid), ((char*)(plan->tags.array)) + sends[ k ].tag_offset,
+			sends[ k ].payload, sends[ k ].size );
+	}
+}
+
+void MCBSP_FUNCTION_PREFIX(plan_destroy)( const bsp_plan_t plan ) {
+	if( plan == NULL ) {
+		return;
+	}
+	for( size_t s = 0; s < plan->P; ++s ) {
+		mcbsp_util_stack_destroy( &(plan->puts[ s ]) );
+	}
+	free( plan->puts );
+	mcbsp_util_stack_destroy( &(plan->targets) );
+	mcbsp_util_stack_destroy( &(plan->buffered) );
+	mcbsp_util_stack_destroy( &(plan->gets) );
+	mcbsp_util_stack_destroy( &(plan->strided_gets) );
+	mcbsp_util_stack_destroy( &(plan->sends) );
+	mcbsp_util_stack_destroy( &(plan->tags) );
+	free( plan );
 }
 
 #ifdef MCBSP_ENABLE_FAKE_HP_DIRECTIVES
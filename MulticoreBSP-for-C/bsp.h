@@ -140,6 +140,12 @@
  *  <li>bsp_sync</li>
  * </ul>
  *
+ * To share the iterations of a loop dynamically between all processes within
+ * a single superstep:
+ * <ul>
+ *  <li>bsp_parallel_for</li>
+ * </ul>
+ *
  * In BSPlib, an SPMD program is given by a function wherein the first
  * executable statement is bsp_begin, and the last executable statement is
  * bsp_end. If the SPMD function is not `int main()', the SPMD section must
@@ -177,6 +183,12 @@
  *                local memory area.</li>
  * </ul>
  *
+ * To coordinate via remote memory within a superstep:
+ * <ul>
+ *  <li>bsp_atomic_fetch_add, bsp_atomic_cas, bsp_atomic_min, and
+ *      bsp_atomic_max Blocking atomic operations on remote 64-bit integers.</li>
+ * </ul>
+ *
  * The bsp_put and bsp_get are considered safe primitives, while the
  * bsp_hpget and bsp_hpput should be used with care.
  */
@@ -205,6 +217,10 @@
  * To inspect the queue of received messages:
  * <ul>
  *  <li>bsp_qsize</li>
+ *  <li>bsp_message_iterator and bsp_next_message Walk over the received
+ *                  messages in place, without removing or copying them.</li>
+ *  <li>bsp_set_message_buckets and bsp_bucket_qsize Sort received messages
+ *                  by sender or by tag, and count them per bucket.</li>
  * </ul>
  *
  * To receive a message:
@@ -265,6 +281,46 @@ typedef unsigned int bsp_pid_t;
 typedef unsigned int bsp_nprocs_t;
 /** Data type used to refer to memory region sizes. */
 typedef size_t bsp_size_t;
+/** Data type used for handles to registered memory regions. */
+typedef size_t bsp_memslot_t;
+/** Handle to a recorded communication plan; see bsp_plan_begin. */
+typedef struct mcbsp_plan * bsp_plan_t;
+
+/** A single transfer of a batched DRMA request; see bsp_put_many and bsp_get_many. */
+struct bsp_transfer {
+	/** The remote thread. */
+	bsp_pid_t pid;
+	/** Offset (in bytes) in the local memory area. */
+	bsp_size_t local_offset;
+	/** Offset (in bytes) in the remotely registered memory area. */
+	bsp_size_t remote_offset;
+	/** Size (in bytes) of the transfer. */
+	bsp_size_t size;
+};
+
+/** A received BSMP message, viewed in place; see bsp_next_message. */
+struct bsp_message {
+	/** Pointer to the message tag. */
+	const void * tag;
+	/** Pointer to the message payload. */
+	const void * payload;
+	/** Size (in bytes) of the payload. */
+	bsp_size_t size;
+};
+
+/** Position in the incoming BSMP queue; see bsp_message_iterator. */
+typedef struct {
+	/** Number of messages not yet visited. */
+	size_t remaining;
+	/** Identifies the state of the queue the walk started on. */
+	size_t generation;
+} bsp_message_iterator_t;
+
+/** Assigns a received BSMP message to a bucket; see bsp_set_message_buckets. */
+typedef bsp_size_t (*bsp_bucket_function_t)( const void * tag, bsp_pid_t source );
+
+/** Executes the iterations [begin, end) of a loop; see bsp_parallel_for. */
+typedef void (*bsp_loop_body_t)( bsp_size_t begin, bsp_size_t end, void * arg );
 
 //set forced defines
 #ifdef MCBSP_COMPATIBILITY_MODE
@@ -335,8 +391,83 @@ bsp_pid_t MCBSP_FUNCTION_PREFIX(nprocs)( void );
 bsp_pid_t MCBSP_FUNCTION_PREFIX(pid)( void );
 double MCBSP_FUNCTION_PREFIX(time)( void );
 void MCBSP_FUNCTION_PREFIX(sync)( void );
+void MCBSP_FUNCTION_PREFIX(sync_begin)( void );
+void MCBSP_FUNCTION_PREFIX(sync_end)( void );
+void MCBSP_FUNCTION_PREFIX(parallel_for)(
+	const bsp_size_t begin,
+	const bsp_size_t end,
+	const bsp_size_t grain,
+	const bsp_loop_body_t body,
+	void * const arg
+);
 void MCBSP_FUNCTION_PREFIX(push_reg)( void * const address, const bsp_size_t size );
 void MCBSP_FUNCTION_PREFIX(pop_reg)( void * const address );
+void MCBSP_FUNCTION_PREFIX(push_reg_slot)( void * const address, const bsp_size_t size, bsp_memslot_t * const slot );
+void MCBSP_FUNCTION_PREFIX(put_slot)(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	const bsp_size_t size
+);
+void MCBSP_FUNCTION_PREFIX(get_slot)(
+	const bsp_pid_t pid,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	void * const destination,
+	const bsp_size_t size
+);
+void MCBSP_FUNCTION_PREFIX(direct_get_slot)(
+	const bsp_pid_t pid,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	void * const destination,
+	const bsp_size_t size
+);
+void MCBSP_FUNCTION_PREFIX(put_many)(
+	const void * const source,
+	const void * const destination,
+	const struct bsp_transfer * const transfers,
+	const size_t count
+);
+void MCBSP_FUNCTION_PREFIX(get_many)(
+	const void * const source,
+	void * const destination,
+	const struct bsp_transfer * const transfers,
+	const size_t count
+);
+void MCBSP_FUNCTION_PREFIX(put_strided)(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_size_t source_stride,
+	const void * const destination,
+	const bsp_size_t offset,
+	const bsp_size_t destination_stride,
+	const bsp_size_t block,
+	const bsp_size_t count
+);
+void MCBSP_FUNCTION_PREFIX(put_indexed)(
+	const bsp_pid_t pid,
+	const void * const source,
+	const void * const destination,
+	const bsp_size_t * const offsets,
+	const bsp_size_t block,
+	const bsp_size_t count
+);
+void MCBSP_FUNCTION_PREFIX(get_strided)(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_size_t offset,
+	const bsp_size_t source_stride,
+	void * const destination,
+	const bsp_size_t destination_stride,
+	const bsp_size_t block,
+	const bsp_size_t count
+);
+void MCBSP_FUNCTION_PREFIX(plan_begin)( void );
+bsp_plan_t MCBSP_FUNCTION_PREFIX(plan_end)( void );
+void MCBSP_FUNCTION_PREFIX(execute_plan)( const bsp_plan_t plan );
+void MCBSP_FUNCTION_PREFIX(plan_destroy)( const bsp_plan_t plan );
 void MCBSP_FUNCTION_PREFIX(put)(
 	const bsp_pid_t pid,
 	const void * const source,
@@ -344,6 +475,13 @@ void MCBSP_FUNCTION_PREFIX(put)(
 	const bsp_size_t offset,
 	const bsp_size_t size
 );
+void MCBSP_FUNCTION_PREFIX(put_deferred)(
+	const bsp_pid_t pid,
+	const void * const source,
+	const void * const destination,
+	const bsp_size_t offset,
+	const bsp_size_t size
+);
 void MCBSP_FUNCTION_PREFIX(get)(
 	const bsp_pid_t pid,
 	const void * const source,
@@ -358,6 +496,31 @@ void MCBSP_FUNCTION_PREFIX(direct_get)(
 	void * const destination,
 	const bsp_size_t size
 );
+int64_t MCBSP_FUNCTION_PREFIX(atomic_fetch_add)(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+);
+int64_t MCBSP_FUNCTION_PREFIX(atomic_cas)(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t expected,
+	const int64_t desired
+);
+int64_t MCBSP_FUNCTION_PREFIX(atomic_min)(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+);
+int64_t MCBSP_FUNCTION_PREFIX(atomic_max)(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+);
 void MCBSP_FUNCTION_PREFIX(set_tagsize)( bsp_size_t * const size );
 void MCBSP_FUNCTION_PREFIX(send)(
 	const bsp_pid_t pid,
@@ -381,6 +544,14 @@ bsp_size_t MCBSP_FUNCTION_PREFIX(hpmove)(
 	void* * const p_tag,
 	void* * const p_payload
 );
+void MCBSP_FUNCTION_PREFIX(message_iterator)( bsp_message_iterator_t * const iterator );
+const struct bsp_message * MCBSP_FUNCTION_PREFIX(next_message)( bsp_message_iterator_t * const iterator );
+void MCBSP_FUNCTION_PREFIX(set_message_buckets)( const bsp_size_t buckets, const bsp_bucket_function_t bucket );
+void MCBSP_FUNCTION_PREFIX(bucket_qsize)(
+	const bsp_size_t bucket,
+	bsp_nprocs_t * const packets,
+	bsp_size_t * const accumulated_size
+);
 void MCBSP_FUNCTION_PREFIX(hpput)(
 	const bsp_pid_t pid,
 	const void * const source,
@@ -414,6 +585,8 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
  #define mcbsp_pid         mcbsp_debug_pid
  #define mcbsp_time        mcbsp_debug_time
  #define mcbsp_sync        mcbsp_debug_sync
+ #define mcbsp_sync_begin  mcbsp_debug_sync_begin
+ #define mcbsp_sync_end    mcbsp_debug_sync_end
  #define mcbsp_push_reg    mcbsp_debug_push_reg
  #define mcbsp_pop_reg     mcbsp_debug_pop_reg
  #define mcbsp_put         mcbsp_debug_put
@@ -429,6 +602,29 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
 
  #define mcbsp_hpsend      mcbsp_debug_hpsend
  #define mcbsp_direct_get  mcbsp_debug_direct_get
+ #define mcbsp_put_deferred mcbsp_debug_put_deferred
+ #define mcbsp_push_reg_slot mcbsp_debug_push_reg_slot
+ #define mcbsp_put_slot    mcbsp_debug_put_slot
+ #define mcbsp_get_slot    mcbsp_debug_get_slot
+ #define mcbsp_direct_get_slot mcbsp_debug_direct_get_slot
+ #define mcbsp_put_many    mcbsp_debug_put_many
+ #define mcbsp_get_many    mcbsp_debug_get_many
+ #define mcbsp_put_strided mcbsp_debug_put_strided
+ #define mcbsp_put_indexed mcbsp_debug_put_indexed
+ #define mcbsp_get_strided mcbsp_debug_get_strided
+ #define mcbsp_plan_begin  mcbsp_debug_plan_begin
+ #define mcbsp_plan_end    mcbsp_debug_plan_end
+ #define mcbsp_execute_plan mcbsp_debug_execute_plan
+ #define mcbsp_plan_destroy mcbsp_debug_plan_destroy
+ #define mcbsp_message_iterator mcbsp_debug_message_iterator
+ #define mcbsp_next_message mcbsp_debug_next_message
+ #define mcbsp_set_message_buckets mcbsp_debug_set_message_buckets
+ #define mcbsp_bucket_qsize mcbsp_debug_bucket_qsize
+ #define mcbsp_atomic_fetch_add mcbsp_debug_atomic_fetch_add
+ #define mcbsp_atomic_cas mcbsp_debug_atomic_cas
+ #define mcbsp_atomic_min mcbsp_debug_atomic_min
+ #define mcbsp_atomic_max mcbsp_debug_atomic_max
+ #define mcbsp_parallel_for mcbsp_debug_parallel_for
 #elif MCBSP_MODE == 3
  #define mcbsp_begin       mcbsp_profile_begin
  #define mcbsp_end         mcbsp_profile_end
@@ -439,6 +635,8 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
  #define mcbsp_pid         mcbsp_profile_pid
  #define mcbsp_time        mcbsp_profile_time
  #define mcbsp_sync        mcbsp_profile_sync
+ #define mcbsp_sync_begin  mcbsp_profile_sync_begin
+ #define mcbsp_sync_end    mcbsp_profile_sync_end
  #define mcbsp_push_reg    mcbsp_profile_push_reg
  #define mcbsp_pop_reg     mcbsp_profile_pop_reg
  #define mcbsp_put         mcbsp_profile_put
@@ -454,6 +652,29 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
 
  #define mcbsp_hpsend      mcbsp_profile_hpsend
  #define mcbsp_direct_get  mcbsp_profile_direct_get
+ #define mcbsp_put_deferred mcbsp_profile_put_deferred
+ #define mcbsp_push_reg_slot mcbsp_profile_push_reg_slot
+ #define mcbsp_put_slot    mcbsp_profile_put_slot
+ #define mcbsp_get_slot    mcbsp_profile_get_slot
+ #define mcbsp_direct_get_slot mcbsp_profile_direct_get_slot
+ #define mcbsp_put_many    mcbsp_profile_put_many
+ #define mcbsp_get_many    mcbsp_profile_get_many
+ #define mcbsp_put_strided mcbsp_profile_put_strided
+ #define mcbsp_put_indexed mcbsp_profile_put_indexed
+ #define mcbsp_get_strided mcbsp_profile_get_strided
+ #define mcbsp_plan_begin  mcbsp_profile_plan_begin
+ #define mcbsp_plan_end    mcbsp_profile_plan_end
+ #define mcbsp_execute_plan mcbsp_profile_execute_plan
+ #define mcbsp_plan_destroy mcbsp_profile_plan_destroy
+ #define mcbsp_message_iterator mcbsp_profile_message_iterator
+ #define mcbsp_next_message mcbsp_profile_next_message
+ #define mcbsp_set_message_buckets mcbsp_profile_set_message_buckets
+ #define mcbsp_bucket_qsize mcbsp_profile_bucket_qsize
+ #define mcbsp_atomic_fetch_add mcbsp_profile_atomic_fetch_add
+ #define mcbsp_atomic_cas mcbsp_profile_atomic_cas
+ #define mcbsp_atomic_min mcbsp_profile_atomic_min
+ #define mcbsp_atomic_max mcbsp_profile_atomic_max
+ #define mcbsp_parallel_for mcbsp_profile_parallel_for
 #else
  #define mcbsp_begin       mcbsp_perf_begin
  #define mcbsp_end         mcbsp_perf_end
@@ -464,6 +685,8 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
  #define mcbsp_pid         mcbsp_perf_pid
  #define mcbsp_time        mcbsp_perf_time
  #define mcbsp_sync        mcbsp_perf_sync
+ #define mcbsp_sync_begin  mcbsp_perf_sync_begin
+ #define mcbsp_sync_end    mcbsp_perf_sync_end
  #define mcbsp_push_reg    mcbsp_perf_push_reg
  #define mcbsp_pop_reg     mcbsp_perf_pop_reg
  #define mcbsp_put         mcbsp_perf_put
@@ -479,6 +702,29 @@ void MCBSP_FUNCTION_PREFIX(hpsend)(
 
  #define mcbsp_hpsend      mcbsp_perf_hpsend
  #define mcbsp_direct_get  mcbsp_perf_direct_get
+ #define mcbsp_put_deferred mcbsp_perf_put_deferred
+ #define mcbsp_push_reg_slot mcbsp_perf_push_reg_slot
+ #define mcbsp_put_slot    mcbsp_perf_put_slot
+ #define mcbsp_get_slot    mcbsp_perf_get_slot
+ #define mcbsp_direct_get_slot mcbsp_perf_direct_get_slot
+ #define mcbsp_put_many    mcbsp_perf_put_many
+ #define mcbsp_get_many    mcbsp_perf_get_many
+ #define mcbsp_put_strided mcbsp_perf_put_strided
+ #define mcbsp_put_indexed mcbsp_perf_put_indexed
+ #define mcbsp_get_strided mcbsp_perf_get_strided
+ #define mcbsp_plan_begin  mcbsp_perf_plan_begin
+ #define mcbsp_plan_end    mcbsp_perf_plan_end
+ #define mcbsp_execute_plan mcbsp_perf_execute_plan
+ #define mcbsp_plan_destroy mcbsp_perf_plan_destroy
+ #define mcbsp_message_iterator mcbsp_perf_message_iterator
+ #define mcbsp_next_message mcbsp_perf_next_message
+ #define mcbsp_set_message_buckets mcbsp_perf_set_message_buckets
+ #define mcbsp_bucket_qsize mcbsp_perf_bucket_qsize
+ #define mcbsp_atomic_fetch_add mcbsp_perf_atomic_fetch_add
+ #define mcbsp_atomic_cas mcbsp_perf_atomic_cas
+ #define mcbsp_atomic_min mcbsp_perf_atomic_min
+ #define mcbsp_atomic_max mcbsp_perf_atomic_max
+ #define mcbsp_parallel_for mcbsp_perf_parallel_for
 #endif
 
 //now account for possible compatibility mode translations
@@ -644,6 +890,11 @@ static inline void bsp_hpget(
  * using bsp_init. This entry-point is a function wherein the
  * first executable statement is this bsp_begin primitive.
  *
+ * The communication queues between two processes are only
+ * allocated once the first of them communicates with the
+ * other. Until then, the pair costs two pointers; on 64-bit
+ * machines, that is 16 bytes per ordered pair of processes.
+ *
  * Note: with MCBSP_COMPATIBILITY_MODE defined, P is of type int.
  *
  * @param P The number of threads requested for the SPMD program.
@@ -663,6 +914,12 @@ static inline void bsp_begin( const bsp_pid_t P ) {
  * Only that original thread will resume with any remaining
  * sequential code.
  *
+ * When the SPMD entry point was given to bsp_init, the other
+ * threads are kept for later SPMD sections instead: there,
+ * bsp_end returns, and the entry point must return right
+ * after. This unwinds their stacks normally, so that C++
+ * destructors and cleanup handlers run as usual.
+ *
  * @ingroup SPMD
  */
 static inline void bsp_end( void ) {
@@ -826,6 +1083,96 @@ static inline void bsp_sync( void ) {
 	mcbsp_sync();
 }
 
+/**
+ * Starts a split-phase synchronisation.
+ *
+ * Calling bsp_sync_begin followed by bsp_sync_end is
+ * equivalent to calling bsp_sync. The calling process,
+ * however, may continue with local computations in
+ * between the two calls, while the other processes
+ * proceed with the communication as soon as all have
+ * arrived. The waiting for slower processes at the
+ * barrier is thus overlapped with useful work.
+ *
+ * In between both calls, a process may not touch any
+ * memory involved in the communication of the ending
+ * superstep, and may call no BSP primitives other than
+ * bsp_pid, bsp_nprocs, and bsp_time.
+ *
+ * Only the default central barrier lets processes leave
+ * bsp_sync_begin before all others arrived. With other
+ * barrier algorithms, all waiting happens in
+ * bsp_sync_end instead.
+ *
+ * @ingroup SPMD
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_sync_begin( void ) {
+	mcbsp_sync_begin();
+}
+
+/**
+ * Completes a split-phase synchronisation started by
+ * bsp_sync_begin. When this function returns, all
+ * communication of the superstep has finished and the
+ * next superstep starts.
+ *
+ * @ingroup SPMD
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_sync_end( void ) {
+	mcbsp_sync_end();
+}
+
+/**
+ * Executes the iterations [begin, end) of a loop using
+ * all processes, balancing the load dynamically.
+ *
+ * The iterations are first divided evenly over the
+ * processes, in chunks of grain consecutive iterations.
+ * Each process executes the chunks it owns, and when it
+ * runs out, steals chunks from other processes. For each
+ * chunk, body is called with the iterations of the chunk
+ * and the arg of the calling process. Which process
+ * executes which chunk, and in what order, is undefined.
+ *
+ * This is a collective call: all processes must call it
+ * in the same superstep, with the same begin, end, grain,
+ * and body. The arg may differ between processes, and
+ * may be used to, e.g., accumulate partial results. The
+ * call ends with a bsp_sync, after which all iterations
+ * have been executed.
+ *
+ * The body may not call BSP primitives other than
+ * bsp_pid, bsp_nprocs, and bsp_time.
+ *
+ * @param begin The first iteration of the loop.
+ * @param end   One past the last iteration of the loop.
+ * @param grain The number of iterations per chunk. If 0,
+ *              a chunk size is chosen that gives each
+ *              process about eight chunks.
+ * @param body  The function executing a chunk.
+ * @param arg   Passed to body unchanged.
+ *
+ * @ingroup SPMD
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_parallel_for(
+	const bsp_size_t begin,
+	const bsp_size_t end,
+	const bsp_size_t grain,
+	const bsp_loop_body_t body,
+	void * const arg
+) {
+	mcbsp_parallel_for( begin, end, grain, body, arg );
+}
+
 /**
  * Registers a memory area for communication.
  *
@@ -844,16 +1191,10 @@ static inline void bsp_sync( void ) {
  * Issuing a push_reg counts as a p-relation during
  * the next bsp_sync, worst case.
  *
- * @bug Due to an implementation choice, the overhead
- * of pushing k variables across all SPMD processes
- * is k^2. This is no issue if k is small, and scales
- * in a realistic sense if \f$ k^2 \leq P \f$.
- * An alternative implementation could reduce this
- * overhead cost to \f$ k\log k \f$ (red/black tree,
- * worst case) or k (hashmap, average case) albeit
- * at the cost of using (increasingly) more memory.
- * Contact the maintainers if this variant is indeed
- * preferable.
+ * Communication primitives look up registered
+ * addresses in a hash map, at constant cost on
+ * average. See bsp_push_reg_slot to avoid even
+ * that lookup.
  *
  * Note: if MCBSP_COMPATIBILITY_MODE is defined, size
  *       will be of type `int'. Otherwise, it is of
@@ -945,6 +1286,59 @@ static inline void bsp_put(
 	mcbsp_put( pid, source, destination, offset, size );
 }
 
+/**
+ * Put data in a remote memory location, without
+ * buffering the source.
+ *
+ * This behaves as bsp_put, except that the data is not
+ * copied at the time of the request. Instead, the remote
+ * thread copies directly from the source memory during
+ * the next synchronisation. The source memory area must
+ * therefore not change until the next bsp_sync returns;
+ * the communicated data will reflect the source as it is
+ * at that bsp_sync.
+ *
+ * During that bsp_sync, all unbuffered communication is
+ * received before any buffered put or message, so the
+ * source may safely be the destination of a bsp_put in
+ * the same superstep; e.g., a ring shift may read and
+ * write the same array. The source must not, however,
+ * be the destination of a bsp_get, bsp_hpput, another
+ * bsp_put_deferred, or a put of an executed plan in the
+ * same superstep.
+ *
+ * This halves the memory traffic of a put, which pays
+ * off for large payloads that are not modified before
+ * the end of the superstep.
+ *
+ * @param pid         The ID number of the remote thread.
+ * @param source      Pointer to the source data, which
+ *                    must remain unchanged until the
+ *                    next bsp_sync returns.
+ * @param destination Pointer to the registered remote
+ *                    memory area to send data to.
+ * @param offset      Offset (in bytes) of the memory
+ *                    area. Offset must be positive and
+ *                    less than the remotely registered
+ *                    memory size.
+ * @param size        Size (in bytes) of the data to be
+ *                    communicated.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_put_deferred(
+	const bsp_pid_t pid,
+	const void * const source,
+	const void * const destination,
+	const bsp_size_t offset,
+	const bsp_size_t size
+) {
+	mcbsp_put_deferred( pid, source, destination, offset, size );
+}
+
 /**
  * Get data from a remote memory location.
  *
@@ -1063,6 +1457,512 @@ static inline void bsp_direct_get(
 	mcbsp_direct_get( pid, source, offset, destination, size );
 }
 
+/**
+ * Registers a memory area for communication, and
+ * returns a handle to the registration.
+ *
+ * This behaves as bsp_push_reg. In addition, during
+ * the next synchronisation, slot is set to a memory
+ * slot that identifies the registration on all
+ * threads. From the next superstep on, bsp_put_slot,
+ * bsp_get_slot, and bsp_direct_get_slot use this
+ * handle directly, instead of looking up the local
+ * address of the registered area.
+ *
+ * The slot remains valid until the area is
+ * deregistered using bsp_pop_reg.
+ *
+ * @param address Pointer to the memory area to register.
+ * @param size    Size, in bytes, of the area to register.
+ * @param slot    Where to store the memory slot. This
+ *                location must remain valid until the
+ *                next bsp_sync returns.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998);
+ *         it follows the memory slots of BSPlib v2
+ *         and LPF.
+ */
+static inline void bsp_push_reg_slot( void * const address, const bsp_size_t size, bsp_memslot_t * const slot ) {
+	mcbsp_push_reg_slot( address, size, slot );
+}
+
+/**
+ * Put data in a remote memory location identified by
+ * a memory slot.
+ *
+ * This behaves as bsp_put, with the destination given
+ * by a memory slot obtained from bsp_push_reg_slot.
+ *
+ * @param pid         The ID number of the remote thread.
+ * @param source      Pointer to the source data.
+ * @param slot        Memory slot of the destination area.
+ * @param offset      Offset (in bytes) of the memory
+ *                    area.
+ * @param size        Size (in bytes) of the data to be
+ *                    communicated.
+ *
+ * @ingroup DRMA
+ */
+static inline void bsp_put_slot(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	const bsp_size_t size
+) {
+	mcbsp_put_slot( pid, source, slot, offset, size );
+}
+
+/**
+ * Get data from a remote memory location identified
+ * by a memory slot.
+ *
+ * This behaves as bsp_get, with the source given by a
+ * memory slot obtained from bsp_push_reg_slot.
+ *
+ * @param pid         The ID number of the remote thread.
+ * @param slot        Memory slot of the source area.
+ * @param offset      Offset (in bytes) of the remote
+ *                    memory area.
+ * @param destination Pointer to the local destination
+ *                    memory area.
+ * @param size        Size (in bytes) of the data to be
+ *                    communicated.
+ *
+ * @ingroup DRMA
+ */
+static inline void bsp_get_slot(
+	const bsp_pid_t pid,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	void * const destination,
+	const bsp_size_t size
+) {
+	mcbsp_get_slot( pid, slot, offset, destination, size );
+}
+
+/**
+ * Get data from a remote memory location identified
+ * by a memory slot, immediately.
+ *
+ * This behaves as bsp_direct_get, with the source
+ * given by a memory slot obtained from
+ * bsp_push_reg_slot.
+ *
+ * @param pid         The ID number of the remote thread.
+ * @param slot        Memory slot of the source area.
+ * @param offset      Offset (in bytes) of the remote
+ *                    memory area.
+ * @param destination Pointer to the local destination
+ *                    memory area.
+ * @param size        Size (in bytes) of the data to be
+ *                    communicated.
+ *
+ * @ingroup DRMA
+ */
+static inline void bsp_direct_get_slot(
+	const bsp_pid_t pid,
+	const bsp_memslot_t slot,
+	const bsp_size_t offset,
+	void * const destination,
+	const bsp_size_t size
+) {
+	mcbsp_direct_get_slot( pid, slot, offset, destination, size );
+}
+
+/**
+ * Puts multiple pieces of a local memory area into a
+ * remotely registered memory area.
+ *
+ * This is equivalent to calling, for each transfer t,
+ * bsp_put( t.pid, source + t.local_offset, destination,
+ * t.remote_offset, t.size ), but looks up the
+ * registration of destination only once.
+ * Fine-grained communication patterns hence pay the
+ * overhead of a primitive call only once per batch.
+ *
+ * @param source      Pointer to the local source area.
+ * @param destination Pointer to the registered memory
+ *                    area to send data to.
+ * @param transfers   Array of the transfers to perform.
+ * @param count       Number of transfers.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_put_many(
+	const void * const source,
+	const void * const destination,
+	const struct bsp_transfer * const transfers,
+	const size_t count
+) {
+	mcbsp_put_many( source, destination, transfers, count );
+}
+
+/**
+ * Gets multiple pieces of remotely registered memory
+ * areas into a local memory area.
+ *
+ * This is equivalent to calling, for each transfer t,
+ * bsp_get( t.pid, source, t.remote_offset,
+ * destination + t.local_offset, t.size ), but looks up
+ * the registration of source only once.
+ *
+ * @param source      Pointer to the registered memory
+ *                    area to get data from.
+ * @param destination Pointer to the local destination
+ *                    area.
+ * @param transfers   Array of the transfers to perform.
+ * @param count       Number of transfers.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_get_many(
+	const void * const source,
+	void * const destination,
+	const struct bsp_transfer * const transfers,
+	const size_t count
+) {
+	mcbsp_get_many( source, destination, transfers, count );
+}
+
+/**
+ * Puts equally-sized blocks that lie at a fixed distance
+ * from one another into a remotely registered memory area,
+ * where they again lie at a fixed distance.
+ *
+ * This is equivalent to calling, for each 0 <= i < count,
+ * bsp_put( pid, source + i * source_stride, destination,
+ * offset + i * destination_stride, block ), but the blocks
+ * are packed into a single message that the destination
+ * scatters in one pass during the next bsp_sync.
+ * All strides and sizes are in bytes.
+ *
+ * @param pid                The ID of the remote process.
+ * @param source             Pointer to the first local block.
+ * @param source_stride      Distance between successive
+ *                           local blocks.
+ * @param destination        Pointer to the registered memory
+ *                           area to send data to.
+ * @param offset             Offset of the first remote block.
+ * @param destination_stride Distance between successive
+ *                           remote blocks.
+ * @param block              Size of a single block.
+ * @param count              Number of blocks.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_put_strided(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_size_t source_stride,
+	const void * const destination,
+	const bsp_size_t offset,
+	const bsp_size_t destination_stride,
+	const bsp_size_t block,
+	const bsp_size_t count
+) {
+	mcbsp_put_strided( pid, source, source_stride, destination, offset, destination_stride, block, count );
+}
+
+/**
+ * Puts contiguous local blocks at arbitrary offsets of a
+ * remotely registered memory area.
+ *
+ * This is equivalent to calling, for each 0 <= i < count,
+ * bsp_put( pid, source + i * block, destination,
+ * offsets[ i ], block ), but the blocks and offsets are
+ * sent as a single message that the destination scatters
+ * in one pass during the next bsp_sync. The offsets array
+ * may be reused immediately after this call.
+ *
+ * @param pid         The ID of the remote process.
+ * @param source      Pointer to the local blocks.
+ * @param destination Pointer to the registered memory
+ *                    area to send data to.
+ * @param offsets     Byte offsets of the remote blocks.
+ * @param block       Size of a single block (in bytes).
+ * @param count       Number of blocks.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_put_indexed(
+	const bsp_pid_t pid,
+	const void * const source,
+	const void * const destination,
+	const bsp_size_t * const offsets,
+	const bsp_size_t block,
+	const bsp_size_t count
+) {
+	mcbsp_put_indexed( pid, source, destination, offsets, block, count );
+}
+
+/**
+ * Gets equally-sized blocks that lie at a fixed distance
+ * from one another from a remotely registered memory area.
+ *
+ * This is equivalent to calling, for each 0 <= i < count,
+ * bsp_get( pid, source, offset + i * source_stride,
+ * destination + i * destination_stride, block ), but
+ * queues only a single request that is served in one
+ * pass during the next bsp_sync.
+ * All strides and sizes are in bytes.
+ *
+ * @param pid                The ID of the remote process.
+ * @param source             Pointer to the registered memory
+ *                           area to get data from.
+ * @param offset             Offset of the first remote block.
+ * @param source_stride      Distance between successive
+ *                           remote blocks.
+ * @param destination        Pointer to the first local block.
+ * @param destination_stride Distance between successive
+ *                           local blocks.
+ * @param block              Size of a single block.
+ * @param count              Number of blocks.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_get_strided(
+	const bsp_pid_t pid,
+	const void * const source,
+	const bsp_size_t offset,
+	const bsp_size_t source_stride,
+	void * const destination,
+	const bsp_size_t destination_stride,
+	const bsp_size_t block,
+	const bsp_size_t count
+) {
+	mcbsp_get_strided( pid, source, offset, source_stride, destination, destination_stride, block, count );
+}
+
+/**
+ * Atomically adds a value to a 64-bit integer in a
+ * registered memory area at another thread.
+ *
+ * Unlike bsp_put and bsp_get, this is a blocking, one-
+ * sided operation: it completes before returning, and
+ * all atomic operations on the same integer are applied
+ * in some order, whatever thread issues them. This lets
+ * threads coordinate within a superstep, for instance
+ * via shared counters or work queue heads.
+ *
+ * Atomics are not ordered with respect to bsp_put or
+ * bsp_get requests targeting the same memory, which
+ * complete during the next bsp_sync. The integer must
+ * be aligned to 8 bytes.
+ *
+ * @param pid      The ID of the thread holding the integer.
+ * @param variable Pointer to the locally registered
+ *                 counterpart of the memory area.
+ * @param offset   Offset (in bytes) of the integer in the
+ *                 memory area.
+ * @param value    The value to add.
+ *
+ * @return The value of the integer before the addition.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline int64_t bsp_atomic_fetch_add(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+) {
+	return mcbsp_atomic_fetch_add( pid, variable, offset, value );
+}
+
+/**
+ * Atomically replaces a 64-bit integer in a registered
+ * memory area at another thread, if it equals an expected
+ * value. See bsp_atomic_fetch_add for general remarks.
+ *
+ * @param pid      The ID of the thread holding the integer.
+ * @param variable Pointer to the locally registered
+ *                 counterpart of the memory area.
+ * @param offset   Offset (in bytes) of the integer in the
+ *                 memory area.
+ * @param expected The value the integer should have.
+ * @param desired  The value to store if it has.
+ *
+ * @return The value of the integer before the operation;
+ *         the integer was replaced if and only if this
+ *         equals expected.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline int64_t bsp_atomic_cas(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t expected,
+	const int64_t desired
+) {
+	return mcbsp_atomic_cas( pid, variable, offset, expected, desired );
+}
+
+/**
+ * Atomically lowers a 64-bit integer in a registered
+ * memory area at another thread to a given value, if it
+ * is larger. See bsp_atomic_fetch_add for general remarks.
+ *
+ * @param pid      The ID of the thread holding the integer.
+ * @param variable Pointer to the locally registered
+ *                 counterpart of the memory area.
+ * @param offset   Offset (in bytes) of the integer in the
+ *                 memory area.
+ * @param value    The value to compare with.
+ *
+ * @return The value of the integer before the operation.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline int64_t bsp_atomic_min(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+) {
+	return mcbsp_atomic_min( pid, variable, offset, value );
+}
+
+/**
+ * Atomically raises a 64-bit integer in a registered
+ * memory area at another thread to a given value, if it
+ * is smaller. See bsp_atomic_fetch_add for general remarks.
+ *
+ * @param pid      The ID of the thread holding the integer.
+ * @param variable Pointer to the locally registered
+ *                 counterpart of the memory area.
+ * @param offset   Offset (in bytes) of the integer in the
+ *                 memory area.
+ * @param value    The value to compare with.
+ *
+ * @return The value of the integer before the operation.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline int64_t bsp_atomic_max(
+	const bsp_pid_t pid,
+	const void * const variable,
+	const bsp_size_t offset,
+	const int64_t value
+) {
+	return mcbsp_atomic_max( pid, variable, offset, value );
+}
+
+/**
+ * Starts recording a communication plan.
+ *
+ * All bsp_put, bsp_put_deferred, bsp_get, bsp_get_strided,
+ * and bsp_send requests (including their slot and batched
+ * variants) this process issues until the matching bsp_plan_end
+ * are executed as usual, and are additionally recorded
+ * with their source and destination addresses resolved.
+ * The plan can then be replayed in later supersteps by
+ * bsp_execute_plan, at a fraction of the cost of issuing
+ * the same requests again.
+ *
+ * High-performance requests are not recorded. Calling
+ * bsp_put_strided or bsp_put_indexed while recording
+ * aborts the program.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_plan_begin( void ) {
+	mcbsp_plan_begin();
+}
+
+/**
+ * Stops recording a communication plan.
+ *
+ * @return The recorded plan. It remains valid until it is
+ *         passed to bsp_plan_destroy.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline bsp_plan_t bsp_plan_end( void ) {
+	return mcbsp_plan_end();
+}
+
+/**
+ * Replays a communication plan recorded by this process.
+ *
+ * The recorded puts, gets, and sends are queued as though
+ * they were issued again, with all addresses resolved; in
+ * particular, recorded bsp_puts buffer their sources when
+ * this function is called. Recorded bsp_put_deferred
+ * requests are not queued at all: during the next bsp_sync,
+ * each destination process copies its data straight from
+ * the recorded sources using the recorded address lists.
+ * As with bsp_put_deferred, those sources are hence read
+ * during that bsp_sync, and must not be changed between
+ * this call and the end of the sync.
+ *
+ * The plan must not be destroyed before that bsp_sync
+ * returns. The registrations it refers to must still be
+ * valid, and the tag size must equal the tag size at the
+ * time of recording if the plan contains sends.
+ *
+ * @param plan The plan to execute.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_execute_plan( const bsp_plan_t plan ) {
+	mcbsp_execute_plan( plan );
+}
+
+/**
+ * Frees a communication plan returned by bsp_plan_end.
+ *
+ * @param plan The plan to destroy.
+ *
+ * @ingroup DRMA
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_plan_destroy( const bsp_plan_t plan ) {
+	mcbsp_plan_destroy( plan );
+}
+
 /**
  * Sets the tag size of inter-thread messages.
  *
@@ -1326,6 +2226,117 @@ static inline bsp_size_t bsp_hpmove( void* * const p_tag, void* * const p_payloa
 	return mcbsp_hpmove( p_tag, p_payload );
 }
 
+/**
+ * Starts a walk over the incoming BSMP queue.
+ *
+ * Successive calls to bsp_next_message then return the
+ * waiting messages in the order bsp_move and bsp_hpmove
+ * would. Unlike those primitives, the walk does not
+ * remove messages from the queue, and nothing is copied:
+ * messages sent by bsp_send are read straight from the
+ * communication buffers of their senders.
+ *
+ * The iterator is invalidated by bsp_move, bsp_hpmove,
+ * and the next bsp_sync. Unless MCBSP_NO_CHECKS is
+ * defined, bsp_next_message aborts when passed an
+ * invalidated iterator.
+ *
+ * @param iterator The iterator to initialise.
+ *
+ * @ingroup BSMP
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_message_iterator( bsp_message_iterator_t * const iterator ) {
+	mcbsp_message_iterator( iterator );
+}
+
+/**
+ * Advances a walk over the incoming BSMP queue.
+ *
+ * Take care *not* to free or write to the memory the
+ * returned view refers to; like with bsp_hpmove, the
+ * data resides in MulticoreBSP-managed buffers and is
+ * only valid until the next bsp_sync.
+ *
+ * @param iterator An iterator initialised by
+ *                 bsp_message_iterator.
+ *
+ * @return A view on the tag, payload, and payload size
+ *         of the next message, or NULL if all messages
+ *         have been visited.
+ *
+ * @ingroup BSMP
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline const struct bsp_message * bsp_next_message( bsp_message_iterator_t * const iterator ) {
+	return mcbsp_next_message( iterator );
+}
+
+/**
+ * Sorts the BSMP messages delivered by subsequent bsp_syncs
+ * into buckets.
+ *
+ * Each incoming message is assigned to a bucket by calling
+ * bucket with its tag and the ID of its sending thread.
+ * bsp_move, bsp_hpmove, and bsp_next_message then return
+ * all messages of bucket 0 first, followed by those of
+ * bucket 1, and so on. Within a bucket, messages are
+ * ordered by the ID of their senders, and bsp_send messages
+ * of the same sender appear in the order they were sent.
+ * Use bsp_bucket_qsize to learn the size of each bucket
+ * before reading any message.
+ *
+ * If bucket is NULL, messages are grouped by sender only;
+ * buckets must then equal bsp_nprocs(). If buckets is 0,
+ * messages are delivered in arbitrary order, as is the
+ * default. This setting is local to the calling thread,
+ * and takes effect at the next bsp_sync.
+ *
+ * @param buckets The number of buckets.
+ * @param bucket  Maps a tag and a sender ID to a bucket
+ *                smaller than buckets. This function is
+ *                called during bsp_sync.
+ *
+ * @ingroup BSMP
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_set_message_buckets( const bsp_size_t buckets, const bsp_bucket_function_t bucket ) {
+	mcbsp_set_message_buckets( buckets, bucket );
+}
+
+/**
+ * Queries the size of a bucket of the incoming BSMP queue.
+ *
+ * Messages already removed by bsp_move or bsp_hpmove are
+ * not counted.
+ *
+ * @param bucket           The bucket to query; see
+ *                         bsp_set_message_buckets.
+ * @param packets          Where to store the number of
+ *                         messages in the bucket.
+ * @param accumulated_size Where to store the accumulated
+ *                         payload size of those messages
+ *                         (optional, can be NULL).
+ *
+ * @ingroup BSMP
+ *
+ * @remark This function is *not* an original BSPlib
+ *         primitive as defined by Hill et al. (1998).
+ */
+static inline void bsp_bucket_qsize(
+	const bsp_size_t bucket,
+	bsp_nprocs_t * const packets,
+	bsp_size_t * const accumulated_size
+) {
+	mcbsp_bucket_qsize( bucket, packets, accumulated_size );
+}
+
 /**
  * Put data in a remote memory location.
  *
@@ -1340,6 +2351,11 @@ static inline bsp_size_t bsp_hpmove( void* * const p_tag, void* * const p_payloa
  * communication and computation is the fundamental
  * difference with the standard bsp_put.
  *
+ * Unless MulticoreBSP was compiled with MCBSP_NO_IMMEDIATE_HP
+ * defined, the copy is performed before this function returns.
+ * It then only waits for the thread with ID pid to finish
+ * receiving the communication of the previous superstep.
+ *
  * It is not guaranteed this overlap results in faster 
  * execution time. You should think about if using these 
  * high-performance primitives makes sense on a 
@@ -1399,6 +2415,11 @@ static inline void bsp_hpput(
  * overlap of communication and computation is the
  * fundamental difference with the standard bsp_get.
  *
+ * Unless MulticoreBSP was compiled with MCBSP_NO_IMMEDIATE_HP
+ * defined, the copy is performed before this function returns.
+ * It then only waits for the thread with ID pid to finish
+ * receiving the communication of the previous superstep.
+ *
  * It is not guaranteed this overlap results in faster 
  * execution time. You should think about if using these 
  * high-performance primitives makes sense on a 
@@ -16,6 +16,8 @@ void inner_loop( double * const, const double );
 void sequential( void );
 void parallel_half( void );
 void parallel_full( void );
+void dynamic_body( bsp_size_t, bsp_size_t, void * );
+void parallel_dynamic( void );
 
 double f( const double x ) {
 	return 4 * sqrt( 1 - x * x );
@@ -114,6 +116,45 @@ void parallel_full( void ) {
 	bsp_end();
 }
 
+//executes a chunk of the inner loop handed out by bsp_parallel_for,
+//accumulating into the partial result of the executing thread
+void dynamic_body( const bsp_size_t begin, const bsp_size_t end, void * const arg ) {
+	const double h = 1.0 / ( (double)precision );
+	for( bsp_size_t i = begin; i < end; ++i ) {
+		inner_loop( (double*)arg, i * h );
+	}
+}
+
+//parallel code with dynamic load balancing. The runtime
+//divides the loop and lets idle threads steal iterations.
+void parallel_dynamic( void ) {
+	bsp_begin( bsp_nprocs() );
+
+	const bsp_pid_t s = bsp_pid();
+	double partial_work = s == 0 ? f( 0 ) + f( 1 ) : 0.0;
+	bsp_push_reg( &partial_work, sizeof(double) );
+	bsp_sync();
+
+	//this ends with a bsp_sync, so afterwards all partial results are final
+	bsp_parallel_for( 1, precision - 1, 0, &dynamic_body, &partial_work );
+
+	if( s == 0 ) {
+		double integral = partial_work;
+		for( bsp_pid_t k = 1; k < bsp_nprocs(); ++k ) {
+			double remote;
+			bsp_direct_get( k, &partial_work, 0, &remote, sizeof(double) );
+			integral += remote;
+		}
+		integral /= (double)(2*precision);
+		printf(
+			"Integral is %.14lf, time taken for dynamic parallel calculation using %d threads: %f\n(time taken as measured from PID 0 after reduction)\n",
+			integral, bsp_nprocs(), bsp_time()
+		);
+	}
+
+	bsp_end();
+}
+
 int main( int argc, char **argv ) {
 
 	bsp_init( &sequential, argc, argv );	
@@ -129,6 +170,9 @@ int main( int argc, char **argv ) {
 	bsp_init( &parallel_full, argc, argv );
 	parallel_full();
 
+	bsp_init( &parallel_dynamic, argc, argv );
+	parallel_dynamic();
+
 	return EXIT_SUCCESS;
 }
 
@@ -73,8 +73,8 @@ AR=ar
 #LFLAGS:=${RELPATH}${PTHREADS_WIN32_PATH}lib/x64/libpthreadGC2.a
 #AR=x86_64-w64-mingw32-ar
 
-OBJECTS=bsp-active-hooks.o mcutil.o mcbsp.o bsp.o bsp.cpp.o bsp.debug.o bsp.profile.o
-TESTOBJ=tests/internal.o tests/util.o tests/bsp.o tests/abort.o tests/spmd.o tests/hp.o
+OBJECTS=bsp-active-hooks.o mcutil.o mcbsp.o mcbsp-collectives.o bsp.o bsp.cpp.o bsp.debug.o bsp.profile.o
+TESTOBJ=tests/internal.o tests/util.o tests/bsp.o tests/abort.o tests/spmd.o tests/hp.o tests/collectives.o tests/team_abort.o
 CLEAN_OBJECTS=${OBJECTS} ${OBJECTS:%.o=%.shared.o} ${KROBJECTS} ${TESTOBJ}
 CLEAN_EXECS=
 
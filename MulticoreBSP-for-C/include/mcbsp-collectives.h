@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File created 18/10/2026.
+ *
+ * This file is part of MulticoreBSP in C --
+ *        a port of the original Java-based MulticoreBSP.
+ *
+ * MulticoreBSP for C is distributed as part of the original
+ * MulticoreBSP and is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU Lesser
+ * General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MulticoreBSP is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with MulticoreBSP. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+/*! \file mcbsp-collectives.h
+ *
+ * The MulticoreBSP for C interface for collective communication.
+ *
+ * The functions defined here implement the common collectives natively
+ * within the shared-memory runtime, instead of on top of bsp_put and
+ * bsp_sync. No memory registration is required.
+ */
+
+/**
+ * \defgroup collectives MulticoreBSP for C collective communication
+ *
+ * Native collective operations for use within an SPMD section.
+ *
+ * Each collective must be called by all BSP processes in the same order, with
+ * matching root, count, size, type, and operator arguments. A collective
+ * synchronises the participating processes, but it is not a bsp_sync: DRMA
+ * and BSMP requests issued before the collective remain queued until the next
+ * bsp_sync, and registrations do not take effect.
+ *
+ * Rather than copying data into communication queues, every process publishes
+ * the addresses of its buffers and waits for the other processes to do the
+ * same; processes then read directly from the buffers of their peers. A final
+ * barrier guarantees that all reads have completed once a collective returns,
+ * so that all buffers may be reused immediately afterwards.
+ *
+ * For small numbers of processes, each process reads all the data it needs
+ * from its peers in a single step. When more than
+ * MCBSP_COLLECTIVES_TREE_THRESHOLD processes participate, broadcasts and
+ * reductions follow binomial tree schedules and scans follow a recursive
+ * doubling schedule, which take a logarithmic number of steps. Large
+ * reductions are instead split in P slices that are reduced in parallel.
+ *
+ * Reductions are typed. The combine loops are written such that compilers
+ * vectorise them with the SIMD instructions of the target architecture.
+ *
+ * Unless noted otherwise, source and destination buffers may not overlap.
+ */
+
+#ifndef _H_MCBSP_COLLECTIVES
+#define _H_MCBSP_COLLECTIVES
+
+#include "bsp.h"
+
+/**
+ * Element types supported by the reducing collectives.
+ * @ingroup collectives
+ */
+enum mcbsp_collectives_type {
+
+	/** Elements are of type int. */
+	MCBSP_INT = 0,
+
+	/** Elements are of type unsigned int. */
+	MCBSP_UNSIGNED_INT,
+
+	/** Elements are of type long int. */
+	MCBSP_LONG,
+
+	/** Elements are of type size_t. */
+	MCBSP_SIZE_T,
+
+	/** Elements are of type float. */
+	MCBSP_FLOAT,
+
+	/** Elements are of type double. */
+	MCBSP_DOUBLE
+};
+
+/**
+ * Operators supported by the reducing collectives. All are associative and
+ * commutative; for floating point types, the order of evaluation depends on
+ * the schedule in use.
+ * @ingroup collectives
+ */
+enum mcbsp_collectives_operator {
+
+	/** Element-wise sum. */
+	MCBSP_SUM = 0,
+
+	/** Element-wise product. */
+	MCBSP_PROD,
+
+	/** Element-wise minimum. */
+	MCBSP_MIN,
+
+	/** Element-wise maximum. */
+	MCBSP_MAX
+};
+
+/**
+ * Copies size bytes from source at the root process into destination at all
+ * processes.
+ *
+ * At the root, source and destination may coincide. Only the root reads from
+ * source; other processes may pass NULL.
+ *
+ * @param root        The process that holds the data.
+ * @param source      Data to broadcast (only used at the root).
+ * @param destination Where to store the data; at least size bytes.
+ * @param size        The number of bytes to broadcast.
+ * @ingroup collectives
+ */
+void mcbsp_broadcast( const bsp_pid_t root, const void * const source, void * const destination, const size_t size );
+
+/**
+ * Combines count elements from every process element-wise, and stores the
+ * result at the root process.
+ *
+ * @param root        The process that receives the result.
+ * @param source      The count local elements to reduce.
+ * @param destination Where to store the result (only used at the root).
+ * @param count       The number of elements at each process.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_reduce( const bsp_pid_t root, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Combines count elements from every process element-wise, and stores the
+ * result at all processes.
+ *
+ * @param source      The count local elements to reduce.
+ * @param destination Where to store the result.
+ * @param count       The number of elements at each process.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_allreduce( const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Computes an inclusive element-wise prefix reduction: process s stores the
+ * combination of the source elements of processes 0, 1, ..., s.
+ *
+ * @param source      The count local elements.
+ * @param destination Where to store the prefix.
+ * @param count       The number of elements at each process.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_scan( const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Gathers size bytes from every process at every process. The data of
+ * process k is stored at destination + k * size.
+ *
+ * @param source      The size local bytes to share.
+ * @param destination Where to store the data; at least bsp_nprocs() * size
+ *                    bytes.
+ * @param size        The number of bytes contributed by each process.
+ * @ingroup collectives
+ */
+void mcbsp_allgather( const void * const source, void * const destination, const size_t size );
+
+/**
+ * Personalised all-to-all exchange. The bytes at source + k * size are sent
+ * to process k, which stores them at destination + s * size, with s the ID of
+ * the sending process.
+ *
+ * @param source      bsp_nprocs() blocks of size bytes, one for each process.
+ * @param destination Where to store the received blocks; at least
+ *                    bsp_nprocs() * size bytes.
+ * @param size        The number of bytes exchanged between every pair.
+ * @ingroup collectives
+ */
+void mcbsp_alltoall( const void * const source, void * const destination, const size_t size );
+
+
+/**
+ * A team: a subset of the BSP processes that communicates and synchronises
+ * independently of the other processes.
+ *
+ * Teams are created collectively by mcbsp_team_split. Each member has a rank
+ * within its team, from 0 up to the team size; ranks follow the order of the
+ * process IDs. All team collectives take ranks instead of process IDs, and
+ * only synchronise the members of the team. Different teams may thus proceed
+ * through their supersteps at different paces.
+ *
+ * Teams also support DRMA via mcbsp_team_push_reg, mcbsp_team_put,
+ * mcbsp_team_get, and mcbsp_team_sync, with the same semantics as their
+ * BSPlib counterparts. Team communication is independent of the global
+ * communication queues: a mcbsp_team_sync does not deliver bsp_put requests
+ * and vice versa, and team registrations only apply to team communication.
+ *
+ * @ingroup collectives
+ */
+typedef struct mcbsp_team * mcbsp_team_t;
+
+/**
+ * Splits the BSP processes into teams. Processes that pass the same color end
+ * up in the same team. Must be called by all BSP processes.
+ *
+ * @param color The team to join.
+ * @return A handle to the team of this process. It must be freed via
+ *         mcbsp_team_destroy.
+ * @ingroup collectives
+ */
+mcbsp_team_t mcbsp_team_split( const size_t color );
+
+/**
+ * Destroys a team. Must be called by all members of the team.
+ *
+ * @param team The team to destroy.
+ * @ingroup collectives
+ */
+void mcbsp_team_destroy( const mcbsp_team_t team );
+
+/**
+ * @param team The team to query.
+ * @return The number of members of the team.
+ * @ingroup collectives
+ */
+size_t mcbsp_team_size( const mcbsp_team_t team );
+
+/**
+ * @param team The team to query.
+ * @return The rank of this process within the team.
+ * @ingroup collectives
+ */
+size_t mcbsp_team_rank( const mcbsp_team_t team );
+
+/**
+ * @param team The team to query.
+ * @param rank A rank within the team.
+ * @return The process ID of the member with the given rank.
+ * @ingroup collectives
+ */
+bsp_pid_t mcbsp_team_pid( const mcbsp_team_t team, const size_t rank );
+
+/**
+ * Registers a memory area for team communication. All members must register
+ * the same number of areas in the same order; the registration takes effect
+ * after the next mcbsp_team_sync. Team registrations remain valid until the
+ * team is destroyed.
+ *
+ * @param team    The team to register with.
+ * @param address Start of the local memory area.
+ * @param size    Size of the local memory area, in bytes.
+ * @ingroup collectives
+ */
+void mcbsp_team_push_reg( const mcbsp_team_t team, void * const address, const size_t size );
+
+/**
+ * Buffered put to another team member; the data arrives after the next
+ * mcbsp_team_sync.
+ *
+ * @param team        The team to communicate within.
+ * @param rank        The rank of the destination member.
+ * @param source      The local data to send.
+ * @param destination A local memory area registered with the team.
+ * @param offset      Offset, in bytes, within the remote memory area.
+ * @param size        The number of bytes to send.
+ * @ingroup collectives
+ */
+void mcbsp_team_put( const mcbsp_team_t team, const size_t rank, const void * const source,
+	const void * const destination, const size_t offset, const size_t size );
+
+/**
+ * Buffered get from another team member; the data arrives after the next
+ * mcbsp_team_sync, and is read before any team put of the same superstep is
+ * delivered.
+ *
+ * @param team        The team to communicate within.
+ * @param rank        The rank of the source member.
+ * @param source      A local memory area registered with the team.
+ * @param offset      Offset, in bytes, within the remote memory area.
+ * @param destination Where to store the data locally.
+ * @param size        The number of bytes to get.
+ * @ingroup collectives
+ */
+void mcbsp_team_get( const mcbsp_team_t team, const size_t rank, const void * const source,
+	const size_t offset, void * const destination, const size_t size );
+
+/**
+ * Ends a team superstep: activates pending team registrations and executes
+ * all team puts and gets. Only synchronises the members of the team.
+ *
+ * @param team The team to synchronise.
+ * @ingroup collectives
+ */
+void mcbsp_team_sync( const mcbsp_team_t team );
+
+/**
+ * Team version of mcbsp_broadcast.
+ *
+ * @param team        The participating team.
+ * @param root        The rank of the member that holds the data.
+ * @param source      Data to broadcast (only used at the root).
+ * @param destination Where to store the data; at least size bytes.
+ * @param size        The number of bytes to broadcast.
+ * @ingroup collectives
+ */
+void mcbsp_team_broadcast( const mcbsp_team_t team, const size_t root, const void * const source, void * const destination, const size_t size );
+
+/**
+ * Team version of mcbsp_reduce.
+ *
+ * @param team        The participating team.
+ * @param root        The rank of the member that receives the result.
+ * @param source      The count local elements to reduce.
+ * @param destination Where to store the result (only used at the root).
+ * @param count       The number of elements at each member.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_team_reduce( const mcbsp_team_t team, const size_t root, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Team version of mcbsp_allreduce.
+ *
+ * @param team        The participating team.
+ * @param source      The count local elements to reduce.
+ * @param destination Where to store the result.
+ * @param count       The number of elements at each member.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_team_allreduce( const mcbsp_team_t team, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Team version of mcbsp_scan; prefixes follow the member ranks.
+ *
+ * @param team        The participating team.
+ * @param source      The count local elements.
+ * @param destination Where to store the prefix.
+ * @param count       The number of elements at each member.
+ * @param type        The element type.
+ * @param op          The reduction operator.
+ * @ingroup collectives
+ */
+void mcbsp_team_scan( const mcbsp_team_t team, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op );
+
+/**
+ * Team version of mcbsp_allgather. The data of the member with rank k is
+ * stored at destination + k * size.
+ *
+ * @param team        The participating team.
+ * @param source      The size local bytes to share.
+ * @param destination Where to store the data; at least team size * size bytes.
+ * @param size        The number of bytes contributed by each member.
+ * @ingroup collectives
+ */
+void mcbsp_team_allgather( const mcbsp_team_t team, const void * const source, void * const destination, const size_t size );
+
+/**
+ * Team version of mcbsp_alltoall; blocks are indexed by member rank.
+ *
+ * @param team        The participating team.
+ * @param source      One block of size bytes for each member.
+ * @param destination Where to store the received blocks; at least team size
+ *                    * size bytes.
+ * @param size        The number of bytes exchanged between every pair.
+ * @ingroup collectives
+ */
+void mcbsp_team_alltoall( const mcbsp_team_t team, const void * const source, void * const destination, const size_t size );
+
+#endif
+
@@ -43,8 +43,10 @@
  *
  * The default values can be changed by directly
  * setting the MCBSP_DEFAULT_AFFINITY,
- * MCBSP_DEFAULT_THREADS_PER_CORE, or
- * MCBSP_DEFAULT_THREAD_NUMBERING globals.
+ * MCBSP_DEFAULT_THREADS_PER_CORE,
+ * MCBSP_DEFAULT_THREAD_NUMBERING,
+ * MCBSP_DEFAULT_BARRIER, or
+ * MCBSP_DEFAULT_SPIN_WINDOW globals.
  *
  * All fields are thread-local. Setting values
  * manually should occur on each thread separately.
@@ -82,6 +84,8 @@
  *	-mcbsp_set_affinity_mode
  *      -mcbsp_set_pinning
  * 	-mcbsp_set_reserved_cores
+ * 	-mcbsp_set_barrier_mode
+ * 	-mcbsp_set_spin_window
  *
  *   See the documentation or the below file-based description for details on
  *   the different settings. To use these functions, the user should include
@@ -108,6 +112,8 @@
  * 		affinity manual
  * 		pinning 4 8 12 16
  * 		reserved_cores 0
+ * 		barrier dissemination
+ * 		spin_window 100
  * 	}
  * 
  *   -threads should be a positive integer, and equals the maximum number of
@@ -139,7 +145,8 @@
  *    On the other hand, the Intel Xeon Phi OS, for example, numbers its threads
  *    consecutively.
  *
- *   -affinity is either scatter, compact, or manual. Scatter will spread
+ *   -affinity is either scatter, compact, manual, numa-balanced, l3-compact, or
+ *    one-per-physical-core. Scatter will spread
  *    MulticoreBSP threads as much as possible over all available cores, thus
  *    maximising bandwidth use on NUMA systems.
  *    Compact will pin all MulticoreBSP threads as close to each other as
@@ -147,6 +154,13 @@
  *    Manual will let the i-th BSP thread be pinned to the hardware thread with
  *    OS number pinning[i], where `pinning' is a user-supplied array with length
  *    equal to the number of threads.
+ *    The remaining three schemes do not rely on cores, threads_per_core, or
+ *    thread_numbering; instead, they read the sockets, L3 caches, NUMA nodes,
+ *    and SMT siblings of the machine from /sys/devices/system. Numa-balanced
+ *    deals threads out over the NUMA nodes round-robin, l3-compact fills one
+ *    L3 domain after the other, and one-per-physical-core avoids SMT siblings
+ *    for as long as possible. Should the topology be unavailable, scatter is
+ *    used instead.
  *
  *   -pinning is a list of positive integers of length threads. Pinning is
  *    mandatory when affinity is manual, otherwise it will be ignored.
@@ -154,7 +168,31 @@
  *   -reserved_cores An array with elements i in the range 0 <= i < cores. These
  *    cores will not be used by BSP threads. Useful in situations where part of
  *    the machine is reserved for dedicated use, such as for OS-use or for
- *    communication handling.
+ *    communication handling. Under the three topology-based schemes, core i
+ *    is the i-th physical core of the whole machine, counting cores in the
+ *    order their first hardware threads appear in OS numbering.
+ *
+ *   -barrier is either central, dissemination, tournament, or tree, and
+ *    selects the barrier algorithm used during bsp_sync and the other
+ *    synchronising primitives. Central has every thread spin on a packed array
+ *    of all P flags; it is the fastest choice for small P. The other three
+ *    spin on cache-line padded flags and take O(log P) rounds: dissemination
+ *    has every thread signal one peer per round; tournament pairs threads up
+ *    by a static tree and releases them by walking that tree back down; tree
+ *    is a combining tree whose leaves group the threads that share a core
+ *    (under compact affinity). The barrier setting only has effect when
+ *    MulticoreBSP for C was compiled with spinlocks, the default for the
+ *    performance and profiling libraries.
+ *
+ *   -spin_window is a non-negative integer, and bounds the time (in
+ *    microseconds) a thread busy-waits at a barrier before it blocks and
+ *    yields its core. Spinning uses pause instructions with exponential
+ *    backoff; blocking threads are woken up via futexes (on Linux). Each
+ *    thread adapts its own window to the waiting times it observes: it spins
+ *    just long enough to cover the typical superstep imbalance, but blocks
+ *    almost immediately when that imbalance exceeds spin_window. A value of 0
+ *    makes threads block right away, while very large values restore pure
+ *    spinning.
  *
  * Code-based defaults:
  * ====================
@@ -164,6 +202,8 @@
  *   -MCBSP_DEFAULT_AFFINITY
  *   -MCBSP_DEFAULT_THREADS_PER_CORE
  *   -MCBSP_DEFAULT_THREAD_NUMBERING
+ *   -MCBSP_DEFAULT_BARRIER
+ *   -MCBSP_DEFAULT_SPIN_WINDOW
  *
  *   Other defaults are fixed to the below values.
  *
@@ -186,6 +226,8 @@
  *   	-thread_numbering: consecutive
  *   	-affinity: scatter
  *   	-reserved_cores: <empty array>
+ *   	-barrier: central
+ *   	-spin_window: 100
  *
  *    ***THESE DEFAULTS ARE NOT SUITABLE FOR HYPER-THREADING MACHINES***
  *  For machines with hyperthreads enabled, the following two lines should be
@@ -223,7 +265,34 @@ enum mcbsp_affinity_mode {
 	 * supplied definitions.
 	 * See also MCBSP_DEFAULT_MANUAL_AFFINITY
 	 */
-	MANUAL
+	MANUAL,
+
+	/**
+	 * A NUMA-balanced affinity deals P consecutive threads
+	 * out over the NUMA nodes in a round-robin fashion.
+	 * Within a node, each physical core receives a thread
+	 * before any SMT sibling is used.
+	 * The machine topology is read from sysfs (Linux only).
+	 */
+	NUMA_BALANCED,
+
+	/**
+	 * An L3-compact affinity fills the cores sharing an L3
+	 * cache one domain after the other, so that consecutive
+	 * threads share a cache. Within a domain, each physical
+	 * core receives a thread before any SMT sibling is used.
+	 * The machine topology is read from sysfs (Linux only).
+	 */
+	L3_COMPACT,
+
+	/**
+	 * Pins P consecutive threads to distinct physical cores,
+	 * in the order of their lowest hardware thread number.
+	 * SMT siblings are only used when P exceeds the number
+	 * of physical cores.
+	 * The machine topology is read from sysfs (Linux only).
+	 */
+	ONE_PER_PHYSICAL_CORE
 };
 
 /**
@@ -250,6 +319,41 @@ enum mcbsp_thread_numbering {
 	WRAPPED
 };
 
+/**
+ * Barrier algorithms MulticoreBSP can synchronise with.
+ *
+ * @ingroup affinity
+ */
+enum mcbsp_barrier_mode {
+
+	/**
+	 * Every thread increments its own entry in a packed array of P
+	 * flags, then waits until all entries caught up. This is the
+	 * default strategy.
+	 */
+	MCBSP_BARRIER_CENTRAL = 0,
+
+	/**
+	 * In round r, thread s signals thread s+2^r (modulo P) and waits
+	 * for the signal of thread s-2^r. Takes ceil(log2 P) rounds.
+	 */
+	MCBSP_BARRIER_DISSEMINATION,
+
+	/**
+	 * Threads are paired up in a static binary tournament; losers
+	 * signal their winner and wait, while the overall winner starts
+	 * waking up the losers in reverse order.
+	 */
+	MCBSP_BARRIER_TOURNAMENT,
+
+	/**
+	 * A combining tree: the last thread to arrive at a node proceeds to
+	 * the parent node, while the others wait on the node until it is
+	 * released. Leaves group threads sharing a core, when known.
+	 */
+	MCBSP_BARRIER_TREE
+};
+
 /**
  * Changes the maxmimum amount of threads MulticoreBSP can allocate. Setting
  * this higher than the (auto-detected) maximum of your machine will cause your
@@ -410,6 +514,53 @@ void mcbsp_set_pinning( const size_t * const pinning, const size_t length );
  */
 void mcbsp_set_reserved_cores( const size_t * const reserved, const size_t length );
 
+/**
+ * Changes the barrier algorithm used by new SPMD instances.
+ *
+ * Will override defaults, and will override values given in `machine.info'.
+ *
+ * This function is thread-safe in that upon exit, valid machine info is
+ * guaranteed. Concurrent calls with bsp_begin still constitutes a programming
+ * error, however (but will not result in crashes).
+ *
+ * @param mode The barrier algorithm to synchronise with.
+ *
+ * @ingroup affinity
+ */
+void mcbsp_set_barrier_mode( const enum mcbsp_barrier_mode mode );
+
+/**
+ * Changes the maximum time threads of new SPMD instances spin at a barrier,
+ * before they block.
+ *
+ * Will override defaults, and will override values given in `machine.info'.
+ *
+ * This function is thread-safe in that upon exit, valid machine info is
+ * guaranteed. Concurrent calls with bsp_begin still constitutes a programming
+ * error, however (but will not result in crashes).
+ *
+ * @param microseconds The spin window, in microseconds.
+ *
+ * @ingroup affinity
+ */
+void mcbsp_set_spin_window( const size_t microseconds );
+
+/**
+ * Terminates the worker threads that MulticoreBSP keeps parked between SPMD
+ * sections.
+ *
+ * Threads spawned by bsp_begin are not terminated by bsp_end; instead, they
+ * are kept pinned and parked, together with their communication queues, such
+ * that later calls to bsp_begin can reuse them. This makes starting short SPMD
+ * sections cheap. This function releases the parked threads and their memory;
+ * later SPMD sections then spawn new threads again.
+ *
+ * Must not be called concurrently with bsp_begin.
+ *
+ * @ingroup affinity
+ */
+void mcbsp_release_threads( void );
+
 /** 
  * @return The maximum number of hardware-supported threads.
  *
@@ -497,6 +648,25 @@ size_t mcbsp_get_reserved_cores_number( void );
  */
 size_t * mcbsp_get_reserved_cores( void );
 
+/**
+ * @return The barrier algorithm new SPMD instances synchronise with.
+ *
+ * @see mcbsp_set_barrier_mode
+ *
+ * @ingroup affinity
+ */
+enum mcbsp_barrier_mode mcbsp_get_barrier_mode( void );
+
+/**
+ * @return The maximum time (in microseconds) threads spin at a barrier before
+ *         they block.
+ *
+ * @see mcbsp_set_spin_window
+ *
+ * @ingroup affinity
+ */
+size_t mcbsp_get_spin_window( void );
+
 //Default values
 
 /**
@@ -520,5 +690,19 @@ extern size_t MCBSP_DEFAULT_THREADS_PER_CORE;
  */
 extern enum mcbsp_thread_numbering MCBSP_DEFAULT_THREAD_NUMBERING;
 
+/**
+ * Default barrier algorithm (MCBSP_BARRIER_CENTRAL).
+ *
+ * @ingroup affinity
+ */
+extern enum mcbsp_barrier_mode MCBSP_DEFAULT_BARRIER;
+
+/**
+ * Default spin window, in microseconds (100).
+ *
+ * @ingroup affinity
+ */
+extern size_t MCBSP_DEFAULT_SPIN_WINDOW;
+
 #endif
 
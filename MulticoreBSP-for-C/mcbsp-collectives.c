@@ -0,0 +1,849 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File created 18/10/2026.
+ *
+ * This file is part of MulticoreBSP in C --
+ *        a port of the original Java-based MulticoreBSP.
+ *
+ * MulticoreBSP for C is distributed as part of the original
+ * MulticoreBSP and is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU Lesser
+ * General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MulticoreBSP is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with MulticoreBSP. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "mcbsp.h"
+#include "mcbsp-collectives.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Generates the combine loops for a single element type. The restrict
+ * qualifiers allow the compiler to vectorise each loop.
+ */
+#define MCBSP_COLLECTIVES_COMBINE( T ) \
+	{ \
+		T * const restrict a = (T *)accumulator; \
+		const T * const restrict b = (const T *)operand; \
+		switch( op ) { \
+			case MCBSP_SUM: \
+				for( size_t i = 0; i < count; ++i ) a[ i ] += b[ i ]; \
+				break; \
+			case MCBSP_PROD: \
+				for( size_t i = 0; i < count; ++i ) a[ i ] *= b[ i ]; \
+				break; \
+			case MCBSP_MIN: \
+				for( size_t i = 0; i < count; ++i ) a[ i ] = b[ i ] < a[ i ] ? b[ i ] : a[ i ]; \
+				break; \
+			case MCBSP_MAX: \
+				for( size_t i = 0; i < count; ++i ) a[ i ] = b[ i ] > a[ i ] ? b[ i ] : a[ i ]; \
+				break; \
+			default: \
+				fprintf( stderr, "Error: unknown reduction operator (%d)!\n", (int)op ); \
+				bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" ); \
+		} \
+		break; \
+	}
+
+/** @return The size of a single element of the given type, in bytes. */
+static size_t mcbsp_collectives_type_size( const enum mcbsp_collectives_type type ) {
+	switch( type ) {
+		case MCBSP_INT:          return sizeof( int );
+		case MCBSP_UNSIGNED_INT: return sizeof( unsigned int );
+		case MCBSP_LONG:         return sizeof( long int );
+		case MCBSP_SIZE_T:       return sizeof( size_t );
+		case MCBSP_FLOAT:        return sizeof( float );
+		case MCBSP_DOUBLE:       return sizeof( double );
+		default:
+			fprintf( stderr, "Error: unknown element type (%d) in reducing collective!\n", (int)type );
+			bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+	return 0;
+}
+
+/** Computes accumulator[ i ] = accumulator[ i ] op operand[ i ], for all 0 <= i < count. */
+static void mcbsp_collectives_combine(
+	void * const accumulator, const void * const operand, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	switch( type ) {
+		case MCBSP_INT:          MCBSP_COLLECTIVES_COMBINE( int )
+		case MCBSP_UNSIGNED_INT: MCBSP_COLLECTIVES_COMBINE( unsigned int )
+		case MCBSP_LONG:         MCBSP_COLLECTIVES_COMBINE( long int )
+		case MCBSP_SIZE_T:       MCBSP_COLLECTIVES_COMBINE( size_t )
+		case MCBSP_FLOAT:        MCBSP_COLLECTIVES_COMBINE( float )
+		case MCBSP_DOUBLE:       MCBSP_COLLECTIVES_COMBINE( double )
+		default:
+			(void)mcbsp_collectives_type_size( type );
+	}
+}
+
+/** A registered memory area of a team member. */
+struct mcbsp_team_reg {
+
+	/** Start of the memory area. */
+	void * address;
+
+	/** Size of the memory area, in bytes. */
+	size_t size;
+};
+
+/** State of a team, shared by all its members. */
+struct mcbsp_team_shared {
+
+	/** Number of members. */
+	size_t size;
+
+	/** The process IDs of the members, ordered by rank. */
+	size_t * members;
+
+	/** Number of members that arrived at the current barrier. */
+	size_t count;
+
+	/** Number of completed barriers. */
+	size_t episode;
+
+	/** Number of members that did not yet destroy the team. */
+	size_t references;
+
+	/** The team put queues; queue src * size + dst holds messages from rank src to rank dst. */
+	struct mcbsp_util_stack * queues;
+
+	/** Registrations of the next team synchronisation, per rank. */
+	struct mcbsp_util_stack * pending;
+
+	/** Active registrations; entry slot * size + rank holds the area of rank for the given slot. */
+	struct mcbsp_team_reg * table;
+
+	/** Number of slots the table can hold. */
+	size_t cap;
+};
+
+/** A team handle, local to a single member. */
+struct mcbsp_team {
+
+	/** The shared team state. */
+	struct mcbsp_team_shared * shared;
+
+	/** Rank of this member within the team. */
+	size_t rank;
+
+	/** Maps local registered addresses to their slots. */
+	struct mcbsp_util_address_map slots;
+
+	/** Number of registrations issued. */
+	size_t registered;
+
+	/** Number of registrations that are active. */
+	size_t active;
+
+	/** The team get requests of the current superstep. */
+	struct mcbsp_util_stack gets;
+
+	/** Buffers the data of team gets during synchronisation. */
+	struct mcbsp_util_stack buffer;
+};
+
+/** The processes taking part in a collective. */
+struct mcbsp_collectives_group {
+
+	/** The thread-local data of the calling process. */
+	struct mcbsp_thread_data * data;
+
+	/** Number of processes in the group. */
+	size_t P;
+
+	/** Rank of the calling process within the group. */
+	size_t s;
+
+	/** The team, or NULL if all processes take part. */
+	struct mcbsp_team_shared * team;
+};
+
+/** @return The thread-local data of the process with the given rank within the group. */
+static inline struct mcbsp_thread_data * mcbsp_collectives_peer( const struct mcbsp_collectives_group * const group, const size_t k ) {
+	return group->data->init->threadData[ group->team == NULL ? k : group->team->members[ k ] ];
+}
+
+/** Argument of mcbsp_team_passed. */
+struct mcbsp_team_wait {
+
+	/** The SPMD group waiting. */
+	const struct mcbsp_init_data * init;
+
+	/** The team waiting. */
+	const struct mcbsp_team_shared * team;
+
+	/** The barrier episode we arrived at. */
+	size_t episode;
+};
+
+/** @return Whether all members reached the team barrier, or whether the run aborted. */
+static bool mcbsp_team_passed( const void * const arg ) {
+	const struct mcbsp_team_wait * const wait = (const struct mcbsp_team_wait *)arg;
+	return __atomic_load_n( &(wait->team->episode), __ATOMIC_ACQUIRE ) != wait->episode || wait->init->abort;
+}
+
+/** Barrier over the members of a team only. */
+static void mcbsp_team_barrier( struct mcbsp_thread_data * const data, struct mcbsp_team_shared * const team ) {
+	const size_t episode = __atomic_load_n( &(team->episode), __ATOMIC_ACQUIRE );
+	if( __atomic_add_fetch( &(team->count), 1, __ATOMIC_ACQ_REL ) == team->size ) {
+		//we are last: reset for the next barrier, then release everyone
+		__atomic_store_n( &(team->count), 0, __ATOMIC_RELAXED );
+		__atomic_store_n( &(team->episode), episode + 1, __ATOMIC_RELEASE );
+		mcbsp_internal_barrier_wake( data->init );
+	} else {
+		const struct mcbsp_team_wait wait = { data->init, team, episode };
+		mcbsp_internal_barrier_wait( data->init, data->bsp_id, &mcbsp_team_passed, &wait );
+	}
+	mcbsp_internal_check_aborted();
+}
+
+/** Barrier over all processes in the group. */
+static void mcbsp_collectives_barrier( const struct mcbsp_collectives_group * const group ) {
+	if( group->team != NULL ) {
+		mcbsp_team_barrier( group->data, group->team );
+		return;
+	}
+#ifdef MCBSP_USE_SPINLOCK
+	mcbsp_internal_spinlock( group->data->init, group->data->init->sl_condition, group->data->bsp_id );
+#else
+	mcbsp_internal_sync( group->data->init, &(group->data->init->condition) );
+#endif
+}
+
+/**
+ * Makes sure the scratch space of this process holds at least size bytes.
+ * Must be called before the scratch space is published to peers.
+ */
+static char * mcbsp_collectives_scratch( struct mcbsp_thread_data * const data, const size_t size ) {
+	if( data->coll_buffer_size < size ) {
+		if( data->coll_buffer != NULL ) {
+			free( data->coll_buffer );
+		}
+		data->coll_buffer = mcbsp_util_malloc( size, "mcbsp_collectives_scratch scratch space" );
+		data->coll_buffer_size = size;
+	}
+	return (char *)(data->coll_buffer);
+}
+
+/** Describes all processes of the current SPMD section. */
+static struct mcbsp_collectives_group mcbsp_collectives_all( void ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+	const struct mcbsp_collectives_group ret = { data, data->init->P, data->bsp_id, NULL };
+	return ret;
+}
+
+/** Describes the members of a team. */
+static struct mcbsp_collectives_group mcbsp_collectives_team( const mcbsp_team_t team ) {
+	struct mcbsp_thread_data * const data = mcbsp_internal_prefunction();
+#ifndef MCBSP_NO_CHECKS
+	if( team == NULL ) {
+		bsp_abort( "Error: team collective called with a NULL team!\n" );
+	}
+#endif
+	const struct mcbsp_collectives_group ret = { data, team->shared->size, team->rank, team->shared };
+	return ret;
+}
+
+/** Checks the root process ID. */
+static void mcbsp_collectives_check_root( const struct mcbsp_collectives_group * const group, const char * const name, const size_t root ) {
+#ifndef MCBSP_NO_CHECKS
+	if( root >= group->P ) {
+		fprintf( stderr, "Error: %s called with root %lu, while only %lu processes are active!\n",
+			name, (unsigned long int)root, (unsigned long int)(group->P) );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#else
+	(void)group;
+	(void)name;
+	(void)root;
+#endif
+}
+
+/** Checks that buffers used by this process are valid. */
+static void mcbsp_collectives_check_buffers( const char * const name, const size_t size,
+	const void * const source, const void * const destination
+) {
+#ifndef MCBSP_NO_CHECKS
+	if( size > 0 && ( source == NULL || destination == NULL ) ) {
+		fprintf( stderr, "Error: %s called with a NULL buffer.\n", name );
+		bsp_abort( "Aborting due to BSP primitive call with invalid arguments.\n" );
+	}
+#else
+	(void)name;
+	(void)size;
+	(void)source;
+	(void)destination;
+#endif
+}
+
+/**
+ * Reduces the source buffers of processes 0 up to and including last
+ * directly into destination, in process order.
+ */
+static void mcbsp_collectives_direct_reduce( const struct mcbsp_collectives_group * const group, void * const destination,
+	const size_t last, const size_t count, const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	memcpy( destination, mcbsp_collectives_peer( group, 0 )->coll_source, count * mcbsp_collectives_type_size( type ) );
+	for( size_t k = 1; k <= last; ++k ) {
+		mcbsp_collectives_combine( destination, mcbsp_collectives_peer( group, k )->coll_source, count, type, op );
+	}
+}
+
+/**
+ * Reduces all source buffers into the scratch space of process 0, following a
+ * binomial tree. Every process holds a partial result in its scratch space;
+ * in round d, each process with an ID that is a multiple of 2d absorbs the
+ * partial result of the process d places further.
+ * Must be called after the source buffers are published, but before the first
+ * barrier.
+ */
+static void mcbsp_collectives_tree_reduce( const struct mcbsp_collectives_group * const group, const void * const source,
+	const size_t count, const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const size_t P     = group->P;
+	const size_t s     = group->s;
+	const size_t bytes = count * mcbsp_collectives_type_size( type );
+	char * const partial = mcbsp_collectives_scratch( group->data, bytes );
+	memcpy( partial, source, bytes );
+	for( size_t d = 1; d < P; d *= 2 ) {
+		mcbsp_collectives_barrier( group );
+		if( s % (2 * d) == 0 && s + d < P ) {
+			mcbsp_collectives_combine( partial, mcbsp_collectives_peer( group, s + d )->coll_buffer, count, type, op );
+		}
+	}
+}
+
+/**
+ * Lets process s reduce slice s of all source buffers into its scratch space.
+ * Must be called after the source buffers are published.
+ * @return The number of elements in a full slice.
+ */
+static size_t mcbsp_collectives_slice_reduce( const struct mcbsp_collectives_group * const group, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const size_t P     = group->P;
+	const size_t s     = group->s;
+	const size_t tsize = mcbsp_collectives_type_size( type );
+	const size_t slice = (count + P - 1) / P;
+	const size_t lo    = s * slice < count ? s * slice : count;
+	const size_t hi    = lo + slice < count ? lo + slice : count;
+	char * const partial = mcbsp_collectives_scratch( group->data, slice * tsize );
+	mcbsp_collectives_barrier( group );
+	if( hi > lo ) {
+		memcpy( partial, (const char *)(mcbsp_collectives_peer( group, 0 )->coll_source) + lo * tsize, (hi - lo) * tsize );
+		for( size_t k = 1; k < P; ++k ) {
+			mcbsp_collectives_combine( partial, (const char *)(mcbsp_collectives_peer( group, k )->coll_source) + lo * tsize, hi - lo, type, op );
+		}
+	}
+	mcbsp_collectives_barrier( group );
+	return slice;
+}
+
+/** Copies the reduced slices of all processes into destination. */
+static void mcbsp_collectives_slice_gather( const struct mcbsp_collectives_group * const group, void * const destination,
+	const size_t count, const size_t slice, const size_t tsize
+) {
+	const size_t P = group->P;
+	for( size_t i = 0; i < P; ++i ) {
+		//start at our own slice to avoid all processes reading from the same peer
+		const size_t k  = (group->s + i) % P;
+		const size_t lo = k * slice < count ? k * slice : count;
+		const size_t hi = lo + slice < count ? lo + slice : count;
+		if( hi > lo ) {
+			memcpy( (char *)destination + lo * tsize, mcbsp_collectives_peer( group, k )->coll_buffer, (hi - lo) * tsize );
+		}
+	}
+}
+
+static void mcbsp_collectives_broadcast( const struct mcbsp_collectives_group * const group, const char * const name,
+	const size_t root, const void * const source, void * const destination, const size_t size
+) {
+	const size_t P = group->P;
+	const size_t s = group->s;
+	mcbsp_collectives_check_root( group, name, root );
+	mcbsp_collectives_check_buffers( name, size, s == root ? source : destination, destination );
+
+	//the root puts its data in place first
+	if( s == root && source != destination ) {
+		memcpy( destination, source, size );
+	}
+	group->data->coll_destination = destination;
+
+	if( P <= MCBSP_COLLECTIVES_TREE_THRESHOLD ) {
+		//everyone reads from the root directly
+		mcbsp_collectives_barrier( group );
+		if( s != root ) {
+			memcpy( destination, mcbsp_collectives_peer( group, root )->coll_destination, size );
+		}
+	} else {
+		//binomial tree: in round d, processes with relative ID in [d,2d) read from d places back
+		const size_t r = (s + P - root) % P;
+		for( size_t d = 1; d < P; d *= 2 ) {
+			mcbsp_collectives_barrier( group );
+			if( r >= d && r < 2 * d ) {
+				memcpy( destination, mcbsp_collectives_peer( group, (s + P - d) % P )->coll_destination, size );
+			}
+		}
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+static void mcbsp_collectives_reduce( const struct mcbsp_collectives_group * const group, const char * const name,
+	const size_t root, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const size_t tsize = mcbsp_collectives_type_size( type );
+	const size_t P = group->P;
+	const size_t s = group->s;
+	mcbsp_collectives_check_root( group, name, root );
+	mcbsp_collectives_check_buffers( name, count * tsize, source, s == root ? destination : source );
+
+	group->data->coll_source = source;
+	if( count * tsize >= MCBSP_COLLECTIVES_SLICE_THRESHOLD && count >= P ) {
+		//reduce P slices in parallel, then the root gathers them
+		const size_t slice = mcbsp_collectives_slice_reduce( group, count, type, op );
+		if( s == root ) {
+			mcbsp_collectives_slice_gather( group, destination, count, slice, tsize );
+		}
+	} else if( P <= MCBSP_COLLECTIVES_TREE_THRESHOLD ) {
+		//the root reads all contributions directly
+		mcbsp_collectives_barrier( group );
+		if( s == root ) {
+			mcbsp_collectives_direct_reduce( group, destination, P - 1, count, type, op );
+		}
+	} else {
+		//reduce along a binomial tree into process 0, from which the root reads
+		mcbsp_collectives_tree_reduce( group, source, count, type, op );
+		mcbsp_collectives_barrier( group );
+		if( s == root ) {
+			memcpy( destination, mcbsp_collectives_peer( group, 0 )->coll_buffer, count * tsize );
+		}
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+static void mcbsp_collectives_allreduce( const struct mcbsp_collectives_group * const group, const char * const name,
+	const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const size_t tsize = mcbsp_collectives_type_size( type );
+	mcbsp_collectives_check_buffers( name, count * tsize, source, destination );
+	const size_t P = group->P;
+
+	group->data->coll_source = source;
+	if( count * tsize >= MCBSP_COLLECTIVES_SLICE_THRESHOLD && count >= P ) {
+		//reduce P slices in parallel, then everyone gathers them
+		const size_t slice = mcbsp_collectives_slice_reduce( group, count, type, op );
+		mcbsp_collectives_slice_gather( group, destination, count, slice, tsize );
+	} else if( P <= MCBSP_COLLECTIVES_TREE_THRESHOLD ) {
+		//everyone reduces all contributions directly
+		mcbsp_collectives_barrier( group );
+		mcbsp_collectives_direct_reduce( group, destination, P - 1, count, type, op );
+	} else {
+		//reduce along a binomial tree into process 0, from which everyone reads
+		mcbsp_collectives_tree_reduce( group, source, count, type, op );
+		mcbsp_collectives_barrier( group );
+		memcpy( destination, mcbsp_collectives_peer( group, 0 )->coll_buffer, count * tsize );
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+static void mcbsp_collectives_scan( const struct mcbsp_collectives_group * const group, const char * const name,
+	const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const size_t tsize = mcbsp_collectives_type_size( type );
+	const size_t bytes = count * tsize;
+	mcbsp_collectives_check_buffers( name, bytes, source, destination );
+	const size_t P = group->P;
+	const size_t s = group->s;
+
+	group->data->coll_source = source;
+	if( P <= MCBSP_COLLECTIVES_TREE_THRESHOLD ) {
+		//process s reduces the contributions of processes 0 to s directly
+		mcbsp_collectives_barrier( group );
+		mcbsp_collectives_direct_reduce( group, destination, s, count, type, op );
+	} else {
+		//recursive doubling, double-buffered so that a round never
+		//overwrites what peers may still read in that same round
+		char * const buffer = mcbsp_collectives_scratch( group->data, 2 * bytes );
+		memcpy( buffer, source, bytes );
+		size_t current = 0;
+		for( size_t d = 1; d < P; d *= 2 ) {
+			mcbsp_collectives_barrier( group );
+			char * const next = buffer + (1 - current) * bytes;
+			memcpy( next, buffer + current * bytes, bytes );
+			if( s >= d ) {
+				const char * const peer = (const char *)(mcbsp_collectives_peer( group, s - d )->coll_buffer);
+				mcbsp_collectives_combine( next, peer + current * bytes, count, type, op );
+			}
+			current = 1 - current;
+		}
+		memcpy( destination, buffer + current * bytes, bytes );
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+static void mcbsp_collectives_allgather( const struct mcbsp_collectives_group * const group, const char * const name,
+	const void * const source, void * const destination, const size_t size
+) {
+	mcbsp_collectives_check_buffers( name, size, source, destination );
+	const size_t P = group->P;
+
+	group->data->coll_source = source;
+	mcbsp_collectives_barrier( group );
+	for( size_t i = 0; i < P; ++i ) {
+		//start at our own block to avoid all processes reading from the same peer
+		const size_t k = (group->s + i) % P;
+		memcpy( (char *)destination + k * size, mcbsp_collectives_peer( group, k )->coll_source, size );
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+static void mcbsp_collectives_alltoall( const struct mcbsp_collectives_group * const group, const char * const name,
+	const void * const source, void * const destination, const size_t size
+) {
+	mcbsp_collectives_check_buffers( name, size, source, destination );
+	const size_t P = group->P;
+	const size_t s = group->s;
+
+	group->data->coll_source = source;
+	mcbsp_collectives_barrier( group );
+	for( size_t i = 0; i < P; ++i ) {
+		const size_t k = (s + i) % P;
+		memcpy( (char *)destination + k * size, (const char *)(mcbsp_collectives_peer( group, k )->coll_source) + s * size, size );
+	}
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( group );
+}
+
+void mcbsp_broadcast( const bsp_pid_t root, const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_broadcast( &group, "mcbsp_broadcast", (size_t)root, source, destination, size );
+}
+
+void mcbsp_reduce( const bsp_pid_t root, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_reduce( &group, "mcbsp_reduce", (size_t)root, source, destination, count, type, op );
+}
+
+void mcbsp_allreduce( const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_allreduce( &group, "mcbsp_allreduce", source, destination, count, type, op );
+}
+
+void mcbsp_scan( const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_scan( &group, "mcbsp_scan", source, destination, count, type, op );
+}
+
+void mcbsp_allgather( const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_allgather( &group, "mcbsp_allgather", source, destination, size );
+}
+
+void mcbsp_alltoall( const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_all();
+	mcbsp_collectives_alltoall( &group, "mcbsp_alltoall", source, destination, size );
+}
+
+mcbsp_team_t mcbsp_team_split( const size_t color ) {
+	const struct mcbsp_collectives_group all = mcbsp_collectives_all();
+	struct mcbsp_thread_data * const data = all.data;
+	const size_t P = all.P;
+
+	//publish our color, and find our fellow members
+	data->coll_source = &color;
+	mcbsp_collectives_barrier( &all );
+	size_t size = 0, rank = 0, leader = P;
+	for( size_t k = 0; k < P; ++k ) {
+		if( *(const size_t *)(data->init->threadData[ k ]->coll_source) == color ) {
+			if( leader == P ) {
+				leader = k;
+			}
+			if( k == all.s ) {
+				rank = size;
+			}
+			++size;
+		}
+	}
+
+	//the member with the lowest ID creates the shared state
+	if( leader == all.s ) {
+		struct mcbsp_team_shared * const team = mcbsp_util_malloc( sizeof( struct mcbsp_team_shared ), "mcbsp_team_split shared team state" );
+		team->size       = size;
+		team->members    = mcbsp_util_malloc( size * sizeof( size_t ), "mcbsp_team_split member list" );
+		team->count      = 0;
+		team->episode    = 0;
+		team->references = size;
+		team->queues     = mcbsp_util_malloc( size * size * sizeof( struct mcbsp_util_stack ), "mcbsp_team_split put queues" );
+		team->pending    = mcbsp_util_malloc( size * sizeof( struct mcbsp_util_stack ), "mcbsp_team_split pending registrations" );
+		team->table      = NULL;
+		team->cap        = 0;
+		for( size_t k = 0, i = 0; k < P; ++k ) {
+			if( *(const size_t *)(data->init->threadData[ k ]->coll_source) == color ) {
+				team->members[ i++ ] = k;
+			}
+		}
+		for( size_t i = 0; i < size * size; ++i ) {
+			mcbsp_util_stack_initialise_lazy( &(team->queues[ i ]), sizeof( struct mcbsp_message ) );
+		}
+		for( size_t i = 0; i < size; ++i ) {
+			mcbsp_util_stack_initialise( &(team->pending[ i ]), sizeof( struct mcbsp_team_reg ) );
+		}
+		data->coll_destination = team;
+	}
+	mcbsp_collectives_barrier( &all );
+
+	//create our local handle
+	struct mcbsp_team * const ret = mcbsp_util_malloc( sizeof( struct mcbsp_team ), "mcbsp_team_split team handle" );
+	ret->shared     = (struct mcbsp_team_shared *)(data->init->threadData[ leader ]->coll_destination);
+	ret->rank       = rank;
+	ret->registered = 0;
+	ret->active     = 0;
+	mcbsp_util_address_map_initialise( &(ret->slots) );
+	mcbsp_util_stack_initialise( &(ret->gets), sizeof( struct mcbsp_get_request ) );
+	mcbsp_util_stack_initialise( &(ret->buffer), sizeof( char ) );
+
+	//make sure all reads have completed
+	mcbsp_collectives_barrier( &all );
+	return ret;
+}
+
+size_t mcbsp_team_size( const mcbsp_team_t team ) {
+	return team->shared->size;
+}
+
+size_t mcbsp_team_rank( const mcbsp_team_t team ) {
+	return team->rank;
+}
+
+bsp_pid_t mcbsp_team_pid( const mcbsp_team_t team, const size_t rank ) {
+	return (bsp_pid_t)(team->shared->members[ rank ]);
+}
+
+void mcbsp_team_push_reg( const mcbsp_team_t team, void * const address, const size_t size ) {
+#ifndef MCBSP_NO_CHECKS
+	if( mcbsp_util_address_map_get( &(team->slots), address ) != SIZE_MAX ) {
+		bsp_abort( "Error: mcbsp_team_push_reg called with an address (%p) that is already registered with this team!\n", address );
+	}
+#endif
+	const struct mcbsp_team_reg reg = { address, size };
+	mcbsp_util_address_map_insert( &(team->slots), address, (team->registered)++ );
+	mcbsp_util_stack_push( &(team->shared->pending[ team->rank ]), &reg );
+}
+
+/** @return The registration of the given member for the given local address. */
+static const struct mcbsp_team_reg * mcbsp_team_lookup( const mcbsp_team_t team, const char * const name,
+	const size_t rank, const void * const address, const size_t offset, const size_t size
+) {
+	const struct mcbsp_team_shared * const shared = team->shared;
+	const size_t slot = mcbsp_util_address_map_get( &(team->slots), address );
+#ifndef MCBSP_NO_CHECKS
+	if( rank >= shared->size ) {
+		bsp_abort( "Error: %s called with an out-of-range rank (%zd, while the team has %zd members)!\n", name, rank, shared->size );
+	}
+	if( slot == SIZE_MAX || slot >= team->active ) {
+		bsp_abort( "Error: %s called with a memory area (%p) not registered with this team, or registered during the current superstep!\n", name, address );
+	}
+#endif
+	const struct mcbsp_team_reg * const reg = shared->table + slot * shared->size + rank;
+#ifndef MCBSP_NO_CHECKS
+	if( offset + size > reg->size ) {
+		bsp_abort( "Error: %s would go out of bounds at the remote member (offset=%zd, size=%zd, while registered memory area is %zd bytes)!\n", name, offset, size, reg->size );
+	}
+#else
+	(void)name;
+	(void)offset;
+	(void)size;
+#endif
+	return reg;
+}
+
+void mcbsp_team_put( const mcbsp_team_t team, const size_t rank, const void * const source,
+	const void * const destination, const size_t offset, const size_t size
+) {
+	if( size == 0 ) {
+		return;
+	}
+	const struct mcbsp_team_reg * const reg = mcbsp_team_lookup( team, "mcbsp_team_put", rank, destination, offset, size );
+	const struct mcbsp_message request = { (char *)(reg->address) + offset, size };
+	struct mcbsp_util_stack * const queue = &(team->shared->queues[ team->rank * team->shared->size + rank ]);
+	mcbsp_util_varstack_push( queue, source, size );
+	mcbsp_util_varstack_regpush( queue, &request );
+}
+
+void mcbsp_team_get( const mcbsp_team_t team, const size_t rank, const void * const source,
+	const size_t offset, void * const destination, const size_t size
+) {
+	if( size == 0 ) {
+		return;
+	}
+	const struct mcbsp_team_reg * const reg = mcbsp_team_lookup( team, "mcbsp_team_get", rank, source, offset, size );
+	const struct mcbsp_get_request request = { (char *)(reg->address) + offset, destination, size, rank };
+	mcbsp_util_stack_push( &(team->gets), &request );
+}
+
+void mcbsp_team_sync( const mcbsp_team_t team ) {
+	struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	struct mcbsp_team_shared * const shared = team->shared;
+	const size_t size = shared->size;
+	const size_t rank = team->rank;
+
+	//wait for all members to finish their superstep
+	mcbsp_collectives_barrier( &group );
+
+	//activate new registrations; all members register in the same order
+	const size_t new_regs = shared->pending[ 0 ].top;
+#ifndef MCBSP_NO_CHECKS
+	if( shared->pending[ rank ].top != new_regs ) {
+		bsp_abort( "Error: team members registered a different number of memory areas (%zd at rank %zd, while rank 0 registered %zd)!\n",
+			shared->pending[ rank ].top, rank, new_regs );
+	}
+#endif
+	if( new_regs > 0 ) {
+		if( rank == 0 && team->active + new_regs > shared->cap ) {
+			size_t cap = shared->cap == 0 ? 16 : shared->cap;
+			while( cap < team->active + new_regs ) {
+				cap *= 2;
+			}
+			struct mcbsp_team_reg * const table = mcbsp_util_malloc( cap * size * sizeof( struct mcbsp_team_reg ), "mcbsp_team_sync registration table" );
+			if( shared->table != NULL ) {
+				memcpy( table, shared->table, team->active * size * sizeof( struct mcbsp_team_reg ) );
+				free( shared->table );
+			}
+			shared->table = table;
+			shared->cap   = cap;
+		}
+		mcbsp_collectives_barrier( &group );
+		const struct mcbsp_team_reg * const regs = shared->pending[ rank ].array;
+		for( size_t i = 0; i < new_regs; ++i ) {
+			shared->table[ (team->active + i) * size + rank ] = regs[ i ];
+		}
+		shared->pending[ rank ].top = 0;
+		team->active += new_regs;
+		mcbsp_collectives_barrier( &group );
+	}
+
+	//gets read the sources before any put is delivered, and hence are buffered
+	const struct mcbsp_get_request * const gets = team->gets.array;
+	for( size_t i = 0; i < team->gets.top; ++i ) {
+		mcbsp_util_varstack_push( &(team->buffer), gets[ i ].source, gets[ i ].length );
+	}
+	mcbsp_collectives_barrier( &group );
+	while( !mcbsp_util_stack_empty( &(team->gets) ) ) {
+		const struct mcbsp_get_request * const request = mcbsp_util_stack_pop( &(team->gets) );
+		memcpy( request->destination, mcbsp_util_varstack_pop( &(team->buffer), request->length ), request->length );
+	}
+
+	//deliver the puts directed at us
+	for( size_t k = 0; k < size; ++k ) {
+		struct mcbsp_util_stack * const queue = &(shared->queues[ k * size + rank ]);
+		while( !mcbsp_util_stack_empty( queue ) ) {
+			const struct mcbsp_message * const request = mcbsp_util_varstack_regpop( queue );
+			memcpy( request->destination, mcbsp_util_varstack_pop( queue, request->length ), request->length );
+		}
+	}
+
+	//senders may only reuse their queues once all are delivered
+	mcbsp_collectives_barrier( &group );
+}
+
+void mcbsp_team_destroy( const mcbsp_team_t team ) {
+	struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	struct mcbsp_team_shared * const shared = team->shared;
+
+	//nobody may still be using the team
+	mcbsp_collectives_barrier( &group );
+
+	//destroy our own handle
+	mcbsp_util_address_map_destroy( &(team->slots) );
+	mcbsp_util_stack_destroy( &(team->gets) );
+	mcbsp_util_stack_destroy( &(team->buffer) );
+	free( team );
+
+	//the last member to leave destroys the shared state
+	if( __atomic_sub_fetch( &(shared->references), 1, __ATOMIC_ACQ_REL ) == 0 ) {
+		for( size_t i = 0; i < shared->size * shared->size; ++i ) {
+			mcbsp_util_stack_destroy( &(shared->queues[ i ]) );
+		}
+		for( size_t i = 0; i < shared->size; ++i ) {
+			mcbsp_util_stack_destroy( &(shared->pending[ i ]) );
+		}
+		free( shared->queues );
+		free( shared->pending );
+		if( shared->table != NULL ) {
+			free( shared->table );
+		}
+		free( shared->members );
+		free( shared );
+	}
+}
+
+void mcbsp_team_broadcast( const mcbsp_team_t team, const size_t root, const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_broadcast( &group, "mcbsp_team_broadcast", root, source, destination, size );
+}
+
+void mcbsp_team_reduce( const mcbsp_team_t team, const size_t root, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_reduce( &group, "mcbsp_team_reduce", root, source, destination, count, type, op );
+}
+
+void mcbsp_team_allreduce( const mcbsp_team_t team, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_allreduce( &group, "mcbsp_team_allreduce", source, destination, count, type, op );
+}
+
+void mcbsp_team_scan( const mcbsp_team_t team, const void * const source, void * const destination, const size_t count,
+	const enum mcbsp_collectives_type type, const enum mcbsp_collectives_operator op
+) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_scan( &group, "mcbsp_team_scan", source, destination, count, type, op );
+}
+
+void mcbsp_team_allgather( const mcbsp_team_t team, const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_allgather( &group, "mcbsp_team_allgather", source, destination, size );
+}
+
+void mcbsp_team_alltoall( const mcbsp_team_t team, const void * const source, void * const destination, const size_t size ) {
+	const struct mcbsp_collectives_group group = mcbsp_collectives_team( team );
+	mcbsp_collectives_alltoall( &group, "mcbsp_team_alltoall", source, destination, size );
+}
+
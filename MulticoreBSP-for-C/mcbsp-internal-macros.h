@@ -94,11 +94,86 @@
  */
 #define MCBSP_ALIGNMENT 128
 
+#ifndef MCBSP_NO_IMMEDIATE_HP
+ /**
+  * Executes bsp_hpput and bsp_hpget at call time, instead of queueing
+  * them until the start of the next bsp_sync.
+  */
+ #define MCBSP_IMMEDIATE_HP
+#endif
+
+#if !defined MCBSP_NO_THREAD_POOL && !defined _WIN32 && !defined __MACH__
+ /**
+  * Keeps the threads spawned by bsp_begin parked after bsp_end, so that
+  * later SPMD sections reuse them together with their communication queues.
+  */
+ #define MCBSP_THREAD_POOL
+#endif
+
+#ifndef MCBSP_SYSFS_ROOT
+ /**
+  * Where the topology-based affinity strategies look for the cpu and
+  * node directories describing the machine.
+  */
+ #define MCBSP_SYSFS_ROOT "/sys/devices/system"
+#endif
+
+#if defined __linux__ && !defined MCBSP_NO_NUMA
+ /**
+  * Keeps the memory of each process on the NUMA node of the hardware
+  * thread it is pinned to. Define MCBSP_NUMA_BIND_REGISTERED to also
+  * bind memory areas registered via bsp_push_reg to the node of the
+  * registering process.
+  */
+ #define MCBSP_NUMA
+#endif
+
 /**
  * If enabled, then during the handling of communication buffers during a
  * bsp_sync, a use congestion-avoiding scheduling is used.
  */
 #define MCBSP_CA_SYNC
 
+#ifndef MCBSP_SPIN_WINDOW_MIN
+/**
+ * The smallest spin window (in nanoseconds) the adaptive barrier waiting
+ * policy shrinks to, before blocking on a futex.
+ */
+ #define MCBSP_SPIN_WINDOW_MIN 1000
+#endif
+
+#ifndef MCBSP_SPIN_BACKOFF_MAX
+/**
+ * The maximum number of pause instructions executed between two polls of a
+ * barrier condition; the number of pauses doubles after every poll.
+ */
+ #define MCBSP_SPIN_BACKOFF_MAX 64
+#endif
+
+#ifndef MCBSP_BARRIER_TREE_ARITY
+/**
+ * The number of children of each interior node of the combining tree barrier
+ * (MCBSP_BARRIER_TREE). The leaves of the tree may have a different arity, as
+ * they group threads that share a core.
+ */
+ #define MCBSP_BARRIER_TREE_ARITY 4
+#endif
+
+#ifndef MCBSP_COLLECTIVES_TREE_THRESHOLD
+/**
+ * Collectives involving more than this number of BSP processes switch from
+ * direct all-to-one reads to tree-based or recursive-doubling schedules.
+ */
+ #define MCBSP_COLLECTIVES_TREE_THRESHOLD 8
+#endif
+
+#ifndef MCBSP_COLLECTIVES_SLICE_THRESHOLD
+/**
+ * Reductions of at least this many bytes per process are split in P slices
+ * that are reduced in parallel, followed by a gather of the slices.
+ */
+ #define MCBSP_COLLECTIVES_SLICE_THRESHOLD 16384
+#endif
+
 #endif
 
@@ -187,6 +187,34 @@ void bsp_put( const bsp_pid_t pid, const void * const source,
 	bsp_put( pid, source, static_cast< const void * >(destination), offset * sizeof(T), size * sizeof(T) );
 }
 
+/**
+ * Put data in a remote memory location, without
+ * buffering the source.
+ *
+ * This is the templated variant of bsp_put_deferred().
+ *
+ * The source memory area must not change until the
+ * next bsp_sync returns.
+ *
+ * @param pid         The ID number of the remote thread.
+ * @param source      Pointer to one or
+ *                    more source elements.
+ * @param destination Pointer to the registered remote 
+ *                    memory area to send one or more
+ *                    source elements to.
+ * @param offset      Offset (in number of elements) of
+ *                    the destination memory area.
+ * @param size        Number of data elements to be
+ *                    transmitted.
+ *
+ * @ingroup cpp
+ */
+template< typename T >
+void bsp_put_deferred( const bsp_pid_t pid, const void * const source,
+	T * const destination, const size_t offset = 0, const size_t size = 1 ) {
+	bsp_put_deferred( pid, source, static_cast< const void * >(destination), offset * sizeof(T), size * sizeof(T) );
+}
+
 /**
  * Get data from a remote memory location.
  *
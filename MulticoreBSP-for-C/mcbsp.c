@@ -35,6 +35,10 @@ enum mcbsp_affinity_mode MCBSP_DEFAULT_AFFINITY = SCATTER;
 
 enum mcbsp_thread_numbering MCBSP_DEFAULT_THREAD_NUMBERING = CONSECUTIVE;
 
+enum mcbsp_barrier_mode MCBSP_DEFAULT_BARRIER = MCBSP_BARRIER_CENTRAL;
+
+size_t MCBSP_DEFAULT_SPIN_WINDOW = 100;
+
 pthread_key_t mcbsp_internal_init_data;
 
 pthread_key_t mcbsp_internal_thread_data;
@@ -45,6 +49,20 @@ pthread_mutex_t mcbsp_internal_keys_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 bool mcbsp_internal_keys_allocated = false;
 
+#ifdef MCBSP_THREAD_POOL
+/** Protects the thread pool. */
+static pthread_mutex_t mcbsp_internal_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Signalled whenever a worker parks or terminates. */
+static pthread_cond_t mcbsp_internal_pool_idle = PTHREAD_COND_INITIALIZER;
+
+/** The workers in the pool (of type struct mcbsp_pool_worker *). */
+static struct mcbsp_util_stack mcbsp_internal_pool = { 0, 0, 0, NULL };
+
+/** Number of dismissed workers that did not yet terminate. */
+static size_t mcbsp_internal_pool_leaving = 0;
+#endif
+
 //MulticoreBSP extension functions
 
 void mcbsp_set_maximum_threads( const size_t max ) {
@@ -134,6 +152,24 @@ void mcbsp_set_reserved_cores( const size_t * const reserved, const size_t lengt
 	machine->Rset = true;
 }
 
+void mcbsp_set_barrier_mode( const enum mcbsp_barrier_mode mode ) {
+	struct mcbsp_util_machine_info * const machine = mcbsp_internal_getMachineInfo();
+	machine->barrier = mode;
+	machine->Bset = true;
+}
+
+void mcbsp_set_spin_window( const size_t microseconds ) {
+	struct mcbsp_util_machine_info * const machine = mcbsp_internal_getMachineInfo();
+	machine->spin_window = microseconds;
+	machine->SWset = true;
+}
+
+void mcbsp_release_threads( void ) {
+#ifdef MCBSP_THREAD_POOL
+	mcbsp_internal_pool_dismiss( true );
+#endif
+}
+
 size_t mcbsp_get_maximum_threads( void ) {
         const struct mcbsp_util_machine_info * const machine = mcbsp_internal_getMachineInfo();
         return machine->threads;
@@ -211,6 +247,16 @@ size_t * mcbsp_get_reserved_cores( void ) {
 	return ret;
 }
 
+enum mcbsp_barrier_mode mcbsp_get_barrier_mode( void ) {
+	const struct mcbsp_util_machine_info * const machine = mcbsp_internal_getMachineInfo();
+	return machine->barrier;
+}
+
+size_t mcbsp_get_spin_window( void ) {
+	const struct mcbsp_util_machine_info * const machine = mcbsp_internal_getMachineInfo();
+	return machine->spin_window;
+}
+
 void mcbsp_checkpoint( void ) {
 #if defined __MACH__ || defined _WIN32
 	//unsupported OS!
@@ -453,13 +499,11 @@ void mcbsp_internal_check_keys_allocated( void ) {
 	pthread_mutex_unlock( &mcbsp_internal_keys_mutex );
 }
 
-void* mcbsp_internal_spmd( void *p ) {
-	//get thread-local data
-	struct mcbsp_thread_data *data = (struct mcbsp_thread_data *) p;
-
-	//reallocate thread-local data and initialise communication queues
-	data = mcbsp_internal_initialise_thread_data( data );
-
+/**
+ * Starts the SPMD program as the process corresponding to the given,
+ * fully initialised, thread-local data.
+ */
+static void * mcbsp_internal_spmd_start( struct mcbsp_thread_data * const data ) {
 	//provide a link back from the initialising process' data
 	data->init->threadData[ data->bsp_id ] = data;
 
@@ -515,6 +559,11 @@ void* mcbsp_internal_spmd( void *p ) {
 	return NULL;
 }
 
+void* mcbsp_internal_spmd( void *p ) {
+	//reallocate thread-local data and initialise communication queues
+	return mcbsp_internal_spmd_start( mcbsp_internal_initialise_thread_data( (struct mcbsp_thread_data *) p ) );
+}
+
 void mcbsp_internal_check_aborted( void ) {
 	const struct mcbsp_thread_data * const data = pthread_getspecific( mcbsp_internal_thread_data );
 	//note this function can implicitly be called by bsp_abort;
@@ -534,43 +583,343 @@ void mcbsp_internal_check_aborted( void ) {
 	return;
 }
 
-void mcbsp_internal_spinlock( struct mcbsp_init_data * const init, unsigned char * const condition, const size_t bsp_id ) {
-	//set our condition go
-	const unsigned char sync_number = ++(condition[ bsp_id ]);
+void mcbsp_internal_barrier_initialise( struct mcbsp_init_data * const init, const struct mcbsp_util_machine_info * const machine ) {
+	const size_t P = init->P;
+	init->barrier             = machine->barrier;
+	init->barrier_flags       = NULL;
+	init->barrier_rounds      = 0;
+	init->barrier_leaf_arity  = MCBSP_BARRIER_TREE_ARITY;
+	init->barrier_spin_window = machine->spin_window > SIZE_MAX / 1000 ? SIZE_MAX : machine->spin_window * 1000;
+
+	//state for blocking and waking up, used by all barriers
+	init->barrier_wakeup = mcbsp_util_malloc( sizeof( struct mcbsp_barrier_wakeup ), "mcbsp_internal_barrier_initialise barrier wake-up state" );
+	init->barrier_wakeup->word     = 0;
+	init->barrier_wakeup->sleepers = 0;
+	init->barrier_local = mcbsp_util_malloc( P * sizeof( struct mcbsp_barrier_flag ), "mcbsp_internal_barrier_initialise per-process barrier state" );
+	for( size_t s = 0; s < P; ++s ) {
+		init->barrier_local[ s ].episode      = init->barrier_local[ s ].count = 0;
+		init->barrier_local[ s ].spin_window  = init->barrier_spin_window;
+		init->barrier_local[ s ].average_wait = 0;
+	}
+	if( init->barrier == MCBSP_BARRIER_CENTRAL ) {
+		return;
+	}
 
-#ifdef MCBSP_NO_CC
-	mcbsp_nocc_flush_cacheline( condition + bsp_id );
+	//number of rounds is ceil(log2 P)
+	while( ((size_t)1 << init->barrier_rounds) < P ) {
+		++(init->barrier_rounds);
+	}
+
+	//consecutive PIDs share a core under compact affinity; let those meet first
+	const size_t tpc = machine->threads_per_core - machine->unused_threads_per_core;
+	if( machine->affinity == COMPACT && machine->thread_numbering == CONSECUTIVE && tpc > 1 ) {
+		init->barrier_leaf_arity = tpc;
+	}
+
+	//the combining tree has less than 2P nodes, the other barriers need one flag per round and process
+	const size_t num_flags = init->barrier == MCBSP_BARRIER_TREE ? 2 * P : init->barrier_rounds * P;
+	init->barrier_flags = mcbsp_util_malloc( (num_flags > 0 ? num_flags : 1) * sizeof( struct mcbsp_barrier_flag ), "mcbsp_internal_barrier_initialise barrier flags" );
+	for( size_t i = 0; i < num_flags; ++i ) {
+		init->barrier_flags[ i ].episode = init->barrier_flags[ i ].count = 0;
+	}
+}
+
+void mcbsp_internal_barrier_destroy( struct mcbsp_init_data * const init ) {
+	if( init->barrier_flags != NULL ) {
+		free( init->barrier_flags );
+	}
+	if( init->barrier_local != NULL ) {
+		free( init->barrier_local );
+	}
+	if( init->barrier_wakeup != NULL ) {
+		free( init->barrier_wakeup );
+	}
+	init->barrier_flags  = init->barrier_local = NULL;
+	init->barrier_wakeup = NULL;
+}
+
+/** Tells the CPU we are spinning, so to save power and free resources for hardware siblings. */
+#if defined __i386__ || defined __x86_64__
+ #define MCBSP_CPU_RELAX() __builtin_ia32_pause()
+#elif defined __aarch64__ || defined __arm__
+ #define MCBSP_CPU_RELAX() __asm__ __volatile__( "yield" )
+#else
+ #define MCBSP_CPU_RELAX()
 #endif
 
-	//check if all are go
-	bool go;
-	do {
-#ifdef MCBSP_NO_CC
-		//brute force dealing with cache coherency, disabled in favour 
-		//of the current implementation that invalidates only the parts
-		//of the memory the spinlock relies on
-		//mcbsp_nocc_purge_all();
+/** @return A monotonic time stamp, in nanoseconds. */
+static size_t mcbsp_internal_wait_clock( void ) {
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return ((size_t)now.tv_sec) * 1000000000ul + (size_t)now.tv_nsec;
+}
+
+/** Blocks the calling process until woken up, unless passed( arg ) holds already. */
+static void mcbsp_internal_barrier_block( struct mcbsp_init_data * const init,
+	bool (* const passed)( const void * const ), const void * const arg ) {
+	struct mcbsp_barrier_wakeup * const wakeup = init->barrier_wakeup;
+	//announce we are about to sleep before checking the condition a last time;
+	//a process that signals after our check will hence see us and wake us
+	__atomic_add_fetch( &(wakeup->sleepers), 1, __ATOMIC_SEQ_CST );
+	const int word = __atomic_load_n( &(wakeup->word), __ATOMIC_SEQ_CST );
+	if( !passed( arg ) ) {
+#ifdef __linux__
+		//returns immediately if the word changed since we read it
+		syscall( SYS_futex, &(wakeup->word), FUTEX_WAIT_PRIVATE, word, NULL, NULL, 0 );
+#else
+		(void)word;
+		sched_yield();
 #endif
-		//assume we can leave the spin-lock, unless...
-		go = true;
-		for( size_t s = 0; s < init->P; ++s ) {
-#ifdef MCBSP_NO_CC
-			//warning: hardcoded for 64-byte cache lines!
-			if( s % mcbsp_nocc_cache_line_size() == 0 ) {
-				//invalidate this new cache line
-				mcbsp_nocc_invalidate_cacheline( condition + s );
+	}
+	__atomic_sub_fetch( &(wakeup->sleepers), 1, __ATOMIC_SEQ_CST );
+}
+
+void mcbsp_internal_barrier_wait( struct mcbsp_init_data * const init, const size_t bsp_id,
+	bool (* const passed)( const void * const ), const void * const arg ) {
+	struct mcbsp_barrier_flag * const local = &(init->barrier_local[ bsp_id ]);
+	size_t waited = 0;
+	if( !passed( arg ) ) {
+		const size_t start = mcbsp_internal_wait_clock();
+		size_t now = start, backoff = 1;
+		do {
+			if( now - start < local->spin_window ) {
+				for( size_t i = 0; i < backoff; ++i ) {
+					MCBSP_CPU_RELAX();
+				}
+				if( backoff < MCBSP_SPIN_BACKOFF_MAX ) {
+					backoff *= 2;
+				}
+			} else {
+				mcbsp_internal_barrier_block( init, passed, arg );
 			}
+			now = mcbsp_internal_wait_clock();
+		} while( !passed( arg ) );
+		waited = now - start;
+	}
+	//spin long enough to cover the typical imbalance, unless that exceeds our budget
+	local->average_wait = (7 * local->average_wait + waited) / 8;
+	const size_t window = 2 * local->average_wait;
+	local->spin_window = window > init->barrier_spin_window || window < MCBSP_SPIN_WINDOW_MIN ?
+		MCBSP_SPIN_WINDOW_MIN : window;
+	if( local->spin_window > init->barrier_spin_window ) {
+		local->spin_window = init->barrier_spin_window;
+	}
+}
+
+void mcbsp_internal_barrier_wake( struct mcbsp_init_data * const init ) {
+	struct mcbsp_barrier_wakeup * const wakeup = init->barrier_wakeup;
+	//order our preceding signal before reading the number of sleepers
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &(wakeup->sleepers), __ATOMIC_RELAXED ) > 0 ) {
+		__atomic_add_fetch( &(wakeup->word), 1, __ATOMIC_SEQ_CST );
+#ifdef __linux__
+		syscall( SYS_futex, &(wakeup->word), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0 );
 #endif
-			//if the condition is sync_number, then s is at my superstep
-			//if the condition is sync_number+1, then s is at the next superstep
-			//in both cases, s is OK with us proceeding into the next superstep
-			//therefore, if neither is true, we should stay in the spinlock.
-			if( !(init->abort) && condition[ s ] != sync_number && condition[ s ] != (unsigned char)(sync_number + 1) ) {
-				go = false;
-				break;
+	}
+}
+
+/** Argument of mcbsp_internal_flag_passed. */
+struct mcbsp_internal_flag_wait {
+
+	/** The SPMD group waiting. */
+	const struct mcbsp_init_data * init;
+
+	/** The flag to wait for. */
+	const struct mcbsp_barrier_flag * flag;
+
+	/** The episode the flag should reach. */
+	size_t episode;
+};
+
+/** @return Whether a flag reached an episode, or whether the run aborted. */
+static bool mcbsp_internal_flag_passed( const void * const arg ) {
+	const struct mcbsp_internal_flag_wait * const wait = (const struct mcbsp_internal_flag_wait *)arg;
+	return __atomic_load_n( &(wait->flag->episode), __ATOMIC_ACQUIRE ) >= wait->episode || wait->init->abort;
+}
+
+/** Signals an episode through a flag, and wakes up blocked processes. */
+static void mcbsp_internal_flag_signal( struct mcbsp_init_data * const init, struct mcbsp_barrier_flag * const flag, const size_t episode ) {
+	__atomic_store_n( &(flag->episode), episode, __ATOMIC_RELEASE );
+	mcbsp_internal_barrier_wake( init );
+}
+
+/** Waits until a flag reached an episode, or until the run aborts. */
+static void mcbsp_internal_flag_wait( struct mcbsp_init_data * const init, const size_t bsp_id, const struct mcbsp_barrier_flag * const flag, const size_t episode ) {
+	const struct mcbsp_internal_flag_wait wait = { init, flag, episode };
+	mcbsp_internal_barrier_wait( init, bsp_id, &mcbsp_internal_flag_passed, &wait );
+}
+
+void mcbsp_internal_wait_delivered( const struct mcbsp_init_data * const init, const size_t pid, const size_t superstep ) {
+	const struct mcbsp_thread_data * const remote = init->threadData[ pid ];
+	while( __atomic_load_n( &(remote->delivered), __ATOMIC_ACQUIRE ) < superstep && !(init->abort) ) {
+		MCBSP_CPU_RELAX();
+		sched_yield();
+	}
+}
+
+void mcbsp_internal_dissemination_barrier( struct mcbsp_init_data * const init, const size_t bsp_id ) {
+	const size_t P = init->P;
+	const size_t episode = ++(init->barrier_local[ bsp_id ].count);
+	for( size_t r = 0; r < init->barrier_rounds; ++r ) {
+		//flag r*P+s is written by s-2^r only
+		const size_t partner = (bsp_id + ((size_t)1 << r)) % P;
+		mcbsp_internal_flag_signal( init, &(init->barrier_flags[ r * P + partner ]), episode );
+		mcbsp_internal_flag_wait( init, bsp_id, &(init->barrier_flags[ r * P + bsp_id ]), episode );
+	}
+	mcbsp_internal_check_aborted();
+}
+
+void mcbsp_internal_tournament_barrier( struct mcbsp_init_data * const init, const size_t bsp_id ) {
+	const size_t P = init->P;
+	const size_t episode = ++(init->barrier_local[ bsp_id ].count);
+	//arrival: play rounds until we lose one, or until we won the tournament
+	size_t r = 0;
+	for( ; r < init->barrier_rounds; ++r ) {
+		const size_t distance = (size_t)1 << r;
+		if( bsp_id % (2 * distance) == 0 ) {
+			//winner of this round waits for its opponent, if any
+			if( bsp_id + distance < P ) {
+				mcbsp_internal_flag_wait( init, bsp_id, &(init->barrier_flags[ r * P + bsp_id ]), episode );
 			}
+		} else {
+			//loser signals the winner, then waits to be woken up
+			mcbsp_internal_flag_signal( init, &(init->barrier_flags[ r * P + bsp_id - distance ]), episode );
+			mcbsp_internal_flag_wait( init, bsp_id, &(init->barrier_local[ bsp_id ]), episode );
+			break;
+		}
+	}
+	//wake-up: release the opponents we beat, latest round first
+	while( r-- > 0 ) {
+		const size_t opponent = bsp_id + ((size_t)1 << r);
+		if( opponent < P ) {
+			mcbsp_internal_flag_signal( init, &(init->barrier_local[ opponent ]), episode );
+		}
+	}
+	mcbsp_internal_check_aborted();
+}
+
+void mcbsp_internal_tree_barrier( struct mcbsp_init_data * const init, const size_t bsp_id ) {
+	const size_t episode = ++(init->barrier_local[ bsp_id ].count);
+	//nodes we arrived at last, and thus have to release
+	struct mcbsp_barrier_flag * completed[ 8 * sizeof( size_t ) ];
+	size_t depth = 0;
+	//climb the tree: q is our index among the n participants of the current level
+	size_t q = bsp_id, n = init->P, offset = 0, arity = init->barrier_leaf_arity;
+	while( n > 1 ) {
+		const size_t group = q / arity;
+		const size_t expected = n - group * arity < arity ? n - group * arity : arity;
+		struct mcbsp_barrier_flag * const node = &(init->barrier_flags[ offset + group ]);
+		if( __atomic_add_fetch( &(node->count), 1, __ATOMIC_ACQ_REL ) < expected ) {
+			//not the last to arrive; wait for the node to be released
+			mcbsp_internal_flag_wait( init, bsp_id, node, episode );
+			break;
+		}
+		//last to arrive: reset the node for the next episode, and move up
+		node->count = 0;
+		completed[ depth++ ] = node;
+		offset += (n + arity - 1) / arity;
+		n = (n + arity - 1) / arity;
+		q = group;
+		arity = MCBSP_BARRIER_TREE_ARITY;
+	}
+	//release the nodes we completed, top-down
+	while( depth-- > 0 ) {
+		mcbsp_internal_flag_signal( init, completed[ depth ], episode );
+	}
+	mcbsp_internal_check_aborted();
+}
+
+/** Argument of mcbsp_internal_central_passed. */
+struct mcbsp_internal_central_wait {
+
+	/** The SPMD group waiting. */
+	const struct mcbsp_init_data * init;
+
+	/** The packed flags of all processes. */
+	unsigned char * condition;
+
+	/** The value our own flag took. */
+	unsigned char sync_number;
+};
+
+/** @return Whether all processes reached the central barrier, or whether the run aborted. */
+static bool mcbsp_internal_central_passed( const void * const arg ) {
+	const struct mcbsp_internal_central_wait * const wait = (const struct mcbsp_internal_central_wait *)arg;
+	const struct mcbsp_init_data * const init = wait->init;
+	unsigned char * const condition = wait->condition;
+	const unsigned char sync_number = wait->sync_number;
+#ifdef MCBSP_NO_CC
+	//brute force dealing with cache coherency, disabled in favour 
+	//of the current implementation that invalidates only the parts
+	//of the memory the spinlock relies on
+	//mcbsp_nocc_purge_all();
+#endif
+	for( size_t s = 0; s < init->P; ++s ) {
+#ifdef MCBSP_NO_CC
+		//warning: hardcoded for 64-byte cache lines!
+		if( s % mcbsp_nocc_cache_line_size() == 0 ) {
+			//invalidate this new cache line
+			mcbsp_nocc_invalidate_cacheline( condition + s );
 		}
-	} while( !go );
+#endif
+		//if the condition is sync_number, then s is at my superstep
+		//if the condition is sync_number+1, then s is at the next superstep
+		//in both cases, s is OK with us proceeding into the next superstep
+		//therefore, if neither is true, we should stay in the spinlock.
+		const unsigned char current = __atomic_load_n( condition + s, __ATOMIC_ACQUIRE );
+		if( !(init->abort) && current != sync_number && current != (unsigned char)(sync_number + 1) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void mcbsp_internal_spinlock( struct mcbsp_init_data * const init, unsigned char * const condition, const size_t bsp_id ) {
+	//dispatch to one of the scalable barriers, if selected
+	switch( init->barrier ) {
+		case MCBSP_BARRIER_DISSEMINATION:
+			mcbsp_internal_dissemination_barrier( init, bsp_id );
+			return;
+		case MCBSP_BARRIER_TOURNAMENT:
+			mcbsp_internal_tournament_barrier( init, bsp_id );
+			return;
+		case MCBSP_BARRIER_TREE:
+			mcbsp_internal_tree_barrier( init, bsp_id );
+			return;
+		default:
+			break;
+	}
+
+	//central barrier: arrive, then wait for everyone else
+	(void)mcbsp_internal_spinlock_arrive( init, condition, bsp_id );
+	mcbsp_internal_spinlock_complete( init, condition, bsp_id );
+}
+
+bool mcbsp_internal_spinlock_arrive( struct mcbsp_init_data * const init, unsigned char * const condition, const size_t bsp_id ) {
+	//the scalable barriers signal and wait in interleaved rounds
+	if( init->barrier != MCBSP_BARRIER_CENTRAL ) {
+		return false;
+	}
+
+	//set our condition go
+	const unsigned char sync_number = (unsigned char)(condition[ bsp_id ] + 1);
+	__atomic_store_n( condition + bsp_id, sync_number, __ATOMIC_RELEASE );
+
+#ifdef MCBSP_NO_CC
+	mcbsp_nocc_flush_cacheline( condition + bsp_id );
+#endif
+
+	//we may be the last to arrive
+	mcbsp_internal_barrier_wake( init );
+
+	//done
+	return true;
+}
+
+void mcbsp_internal_spinlock_complete( struct mcbsp_init_data * const init, unsigned char * const condition, const size_t bsp_id ) {
+	//check if all are go
+	const struct mcbsp_internal_central_wait wait = { init, condition, condition[ bsp_id ] };
+	mcbsp_internal_barrier_wait( init, bsp_id, &mcbsp_internal_central_passed, &wait );
 
 	//sync complete, check for abort condition on exit
 	mcbsp_internal_check_aborted();
@@ -640,30 +989,65 @@ struct mcbsp_thread_data * mcbsp_internal_allocate_thread_data( struct mcbsp_ini
 	thread_data->localC = 0;
 	//initialise default tag size
 	thread_data->newTagSize = 0;
+	//no collectives in progress, no scratch space allocated yet
+	thread_data->coll_source      = NULL;
+	thread_data->coll_destination = NULL;
+	thread_data->coll_buffer      = NULL;
+	thread_data->coll_buffer_size = 0;
+	//not run by a pooled worker, unless handed to one
+	thread_data->worker           = NULL;
 	//return newly constructed and partially initialised thread_data struct
 	return thread_data;
 }
 
+/**
+ * Resets the communication state of thread-local data, such that it
+ * is ready for a new SPMD section.
+ */
+static void mcbsp_internal_reset_thread_data( struct mcbsp_thread_data * const thread_data ) {
+	//no process has communicated with us yet
+	thread_data->senders[ 0 ]   = NULL;
+	thread_data->senders[ 1 ]   = NULL;
+	thread_data->superstep      = 0;
+	thread_data->delivered      = 0;
+	thread_data->sources_pending= false;
+	thread_data->get_low        = NULL;
+	thread_data->get_high       = NULL;
+	thread_data->recording      = NULL;
+	thread_data->sync_begun     = false;
+	thread_data->arrived        = false;
+	thread_data->sync_start     = 0;
+	thread_data->bsmp_generation = 0;
+	thread_data->bsmp_buckets   = 0;
+	thread_data->bsmp_bucket    = NULL;
+	thread_data->new_bsmp_buckets = 0;
+	thread_data->new_bsmp_bucket  = NULL;
+}
+
 struct mcbsp_thread_data * mcbsp_internal_initialise_thread_data( struct mcbsp_thread_data * const data ) {
 	//allocate new thread-local data
 	struct mcbsp_thread_data *thread_data = mcbsp_util_malloc( sizeof( struct mcbsp_thread_data ), "mcbsp_internal_initialise_thread_data thread data struct" );
 
 	//copy initial thread data, for better locality on NUMA systems
 	*thread_data = *data;
+	//we run pinned already, so everything allocated from here on is first touched on our node
+	thread_data->numa_node = mcbsp_util_numa_node();
 
 	//initialise non-copyable/plain-old-data fields
 	const size_t P = (size_t)(thread_data->init->P);
 
-	//allocate stack arrays used for communication
-	thread_data->request_queues = mcbsp_util_malloc( P * sizeof( struct mcbsp_util_stack ), "mcbsp_internal_initialise_thread_data communication request stack array" );
-	thread_data->queues         = mcbsp_util_malloc( P * sizeof( struct mcbsp_util_stack ), "mcbsp_internal_initialise_thread_data communication stack array" );
-	thread_data->hpsend_queues  = mcbsp_util_malloc( P * sizeof( struct mcbsp_util_stack ), "mcbsp_internal_initialise_thread_data hp-communication stack array" );
-	//initialise stacks
-	for( size_t i = 0; i < P; ++i ) {
-		mcbsp_util_stack_initialise( &(thread_data->request_queues[ i ]), sizeof( struct mcbsp_get_request ) );
-		mcbsp_util_stack_initialise( &(thread_data->queues[ i ]),         sizeof( struct mcbsp_message) );
-		mcbsp_util_stack_initialise( &(thread_data->hpsend_queues[ i ]),  sizeof( struct mcbsp_hpsend_request) );
+	//the queues to other processes are only allocated once used, so that processes
+	//that never communicate with each other cost no more than two NULL pointers
+	thread_data->outboxes = mcbsp_util_malloc( 2 * P * sizeof( struct mcbsp_outbox * ), "mcbsp_internal_initialise_thread_data outbox table" );
+	for( size_t i = 0; i < 2 * P; ++i ) {
+		thread_data->outboxes[ i ] = NULL;
 	}
+	mcbsp_internal_reset_thread_data( thread_data );
+	mcbsp_util_stack_initialise_lazy( &(thread_data->active), sizeof( struct mcbsp_outbox * ) );
+	mcbsp_util_stack_initialise_lazy( &(thread_data->request_queue), sizeof( struct mcbsp_get_request ) );
+	mcbsp_util_stack_initialise( &(thread_data->strided_gets), sizeof( struct mcbsp_strided_get_request ) );
+	mcbsp_util_stack_initialise( &(thread_data->plan_sets[ 0 ]), sizeof( struct mcbsp_plan * ) );
+	mcbsp_util_stack_initialise( &(thread_data->plan_sets[ 1 ]), sizeof( struct mcbsp_plan * ) );
 
 	//initialise local to global map
 	mcbsp_util_address_map_initialise( &(thread_data->local2global ) );
@@ -672,7 +1056,11 @@ struct mcbsp_thread_data * mcbsp_internal_initialise_thread_data( struct mcbsp_t
 	mcbsp_util_stack_initialise( &(thread_data->hpdrma_queue), sizeof( struct mcbsp_hp_request ) );
 
 	//initialise BSMP queue
-	mcbsp_util_stack_initialise( &(thread_data->bsmp), sizeof( size_t ) );
+	mcbsp_util_stack_initialise( &(thread_data->bsmp), sizeof( struct bsp_message ) );
+	mcbsp_util_arena_initialise( &(thread_data->bsmp_copies), sizeof( size_t ) );
+	mcbsp_util_stack_initialise_lazy( &(thread_data->bsmp_entries[ 0 ]), sizeof( struct mcbsp_bsmp_entry ) );
+	mcbsp_util_stack_initialise_lazy( &(thread_data->bsmp_entries[ 1 ]), sizeof( struct mcbsp_bsmp_entry ) );
+	thread_data->bsmp_starts = NULL;
 
 	//initialise profile vector
 	mcbsp_util_stack_initialise( &(thread_data->profile), sizeof( struct mcbsp_superstep_stats ) );
@@ -696,29 +1084,296 @@ struct mcbsp_thread_data * mcbsp_internal_initialise_thread_data( struct mcbsp_t
 	return thread_data;
 }
 
-void mcbsp_internal_destroy_thread_data( struct mcbsp_thread_data * const data ) {
+struct mcbsp_outbox * mcbsp_internal_create_outbox( struct mcbsp_thread_data * const data, const size_t index ) {
+	struct mcbsp_outbox * const box = mcbsp_util_malloc( sizeof( struct mcbsp_outbox ), "mcbsp_internal_create_outbox outbox" );
+	mcbsp_util_arena_initialise( &(box->queue), sizeof( struct mcbsp_message ) );
+	mcbsp_util_stack_initialise_lazy( &(box->hpsends),  sizeof( struct mcbsp_hpsend_request ) );
+	mcbsp_util_stack_initialise_lazy( &(box->deferred), sizeof( struct mcbsp_hp_request ) );
+	box->source = data->bsp_id;
+	box->listed = false;
+	box->next   = NULL;
+	data->outboxes[ index ] = box;
+	return box;
+}
+
+/**
+ * Deallocates a fully initialised mcbsp_thread_data struct, which
+ * belonged to an SPMD section of P processes.
+ */
+static void mcbsp_internal_free_thread_data( struct mcbsp_thread_data * const data, const size_t P ) {
 #ifdef __MACH__
 	mach_port_deallocate( mach_task_self(), data->clock );
 #endif
-	for( size_t s = 0; s < data->init->P; ++s ) {
-		mcbsp_util_stack_destroy( &(data->request_queues[ s ]) );
-		mcbsp_util_stack_destroy( &(data->queues[ s ]) );
-		mcbsp_util_stack_destroy( &(data->hpsend_queues[ s ]) );
-	}
-	free( data->request_queues );
-	free( data->queues );
-	free( data->hpsend_queues );
+	mcbsp_util_stack_destroy( &(data->request_queue) );
+	mcbsp_util_stack_destroy( &(data->strided_gets) );
+	mcbsp_util_stack_destroy( &(data->plan_sets[ 0 ]) );
+	mcbsp_util_stack_destroy( &(data->plan_sets[ 1 ]) );
+	for( size_t s = 0; s < 2 * P; ++s ) {
+		struct mcbsp_outbox * const box = data->outboxes[ s ];
+		if( box != NULL ) {
+			mcbsp_util_arena_destroy( &(box->queue) );
+			mcbsp_util_stack_destroy( &(box->hpsends) );
+			mcbsp_util_stack_destroy( &(box->deferred) );
+			free( box );
+		}
+	}
+	free( data->outboxes );
+	mcbsp_util_stack_destroy( &(data->active) );
 	mcbsp_util_address_map_destroy( &(data->local2global) );
 	mcbsp_util_stack_destroy( &(data->hpdrma_queue) );
 	mcbsp_util_stack_destroy( &(data->bsmp) );
+	mcbsp_util_arena_destroy( &(data->bsmp_copies) );
+	mcbsp_util_stack_destroy( &(data->bsmp_entries[ 0 ]) );
+	mcbsp_util_stack_destroy( &(data->bsmp_entries[ 1 ]) );
+	if( data->bsmp_starts != NULL ) {
+		free( data->bsmp_starts );
+	}
 	mcbsp_util_stack_destroy( &(data->profile) );
 	mcbsp_util_stack_destroy( &(data->removedGlobals) );
 	mcbsp_util_stack_destroy( &(data->localsToRemove) );
 	mcbsp_util_stack_destroy( &(data->localsToPush) );
 	mcbsp_util_stack_destroy( &(data->globalsToPush) );
+	if( data->coll_buffer != NULL ) {
+		free( data->coll_buffer );
+	}
+	free( data );
+}
+
+void mcbsp_internal_destroy_thread_data( struct mcbsp_thread_data * const data ) {
+	mcbsp_internal_free_thread_data( data, data->init->P );
+}
+
+#ifdef MCBSP_THREAD_POOL
+/**
+ * Turns the thread-local data a worker retained from its last SPMD
+ * section into fully initialised thread-local data for its new one.
+ * The retained communication queues keep their capacities.
+ *
+ * @return The reused thread-local data, or NULL if there was nothing
+ *         to reuse.
+ */
+static struct mcbsp_thread_data * mcbsp_internal_reuse_thread_data( struct mcbsp_pool_worker * const worker, struct mcbsp_thread_data * const data ) {
+	struct mcbsp_thread_data * const spare = worker->spare;
+	if( spare == NULL ) {
+		return NULL;
+	}
+	worker->spare = NULL;
+	const size_t P = data->init->P;
+	if( worker->spare_P != P ) {
+		//the queue arrays are sized for another number of processes
+		mcbsp_internal_free_thread_data( spare, worker->spare_P );
+		return NULL;
+	}
+	if( spare->numa_node != mcbsp_util_numa_node() ) {
+		//the worker was re-pinned to another node; fresh queues are local to it,
+		//while reusing the old ones would make all our communication remote
+		mcbsp_internal_free_thread_data( spare, P );
+		return NULL;
+	}
+
+	//take over the fields set by mcbsp_internal_allocate_thread_data and bsp_begin
+	spare->init              = data->init;
+	spare->bsp_id            = data->bsp_id;
+	spare->localC            = data->localC;
+	spare->newTagSize        = data->newTagSize;
+	spare->machine_partition = data->machine_partition;
+	spare->coll_source       = NULL;
+	spare->coll_destination  = NULL;
+	spare->worker            = worker;
 	free( data );
+
+	//empty all queues, retaining their capacities
+	for( size_t i = 0; i < 2 * P; ++i ) {
+		struct mcbsp_outbox * const box = spare->outboxes[ i ];
+		if( box != NULL ) {
+			mcbsp_util_arena_reset( &(box->queue) );
+			box->hpsends.top  = 0;
+			box->deferred.top = 0;
+			box->listed       = false;
+			box->next         = NULL;
+		}
+	}
+	spare->active.top         = 0;
+	spare->request_queue.top  = 0;
+	spare->strided_gets.top   = 0;
+	spare->plan_sets[ 0 ].top = 0;
+	spare->plan_sets[ 1 ].top = 0;
+	spare->hpdrma_queue.top   = 0;
+	spare->bsmp.top           = 0;
+	spare->profile.top        = 0;
+	spare->removedGlobals.top = 0;
+	spare->localsToRemove.top = 0;
+	spare->localsToPush.top   = 0;
+	spare->globalsToPush.top  = 0;
+	mcbsp_util_arena_reset( &(spare->bsmp_copies) );
+	if( spare->bsmp_starts != NULL ) {
+		free( spare->bsmp_starts );
+		spare->bsmp_starts = NULL;
+	}
+	mcbsp_util_address_map_clear( &(spare->local2global) );
+	mcbsp_internal_reset_thread_data( spare );
+	return spare;
+}
+
+/** Removes a worker from the pool, if it is in there. Must be called while holding the pool mutex. */
+static void mcbsp_internal_pool_remove( const struct mcbsp_pool_worker * const worker ) {
+	struct mcbsp_pool_worker * * const workers = mcbsp_internal_pool.array;
+	for( size_t i = 0; i < mcbsp_internal_pool.top; ++i ) {
+		if( workers[ i ] == worker ) {
+			workers[ i ] = workers[ --(mcbsp_internal_pool.top) ];
+			return;
+		}
+	}
+}
+
+/**
+ * Cleans up a terminating worker; called both when a parked worker was
+ * dismissed, and when the process it ran aborted.
+ */
+static void mcbsp_internal_pool_exit( void * const arg ) {
+	struct mcbsp_pool_worker * const worker = (struct mcbsp_pool_worker *)arg;
+	pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+	mcbsp_internal_pool_remove( worker );
+	if( worker->dismissed ) {
+		--mcbsp_internal_pool_leaving;
+	}
+	pthread_cond_broadcast( &mcbsp_internal_pool_idle );
+	pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+	if( worker->spare != NULL ) {
+		mcbsp_internal_free_thread_data( worker->spare, worker->spare_P );
+	}
+	pthread_cond_destroy( &(worker->wakeup) );
+	free( worker );
+}
+
+/** The main loop of a pooled worker. */
+static void * mcbsp_internal_pool_main( void * const p ) {
+	struct mcbsp_pool_worker * const worker = (struct mcbsp_pool_worker *)p;
+	pthread_cleanup_push( mcbsp_internal_pool_exit, worker );
+	pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+	while( true ) {
+		//park until we receive work, or are dismissed
+		while( worker->job == NULL && !worker->dismissed ) {
+			pthread_cond_wait( &(worker->wakeup), &mcbsp_internal_pool_mutex );
+		}
+		if( worker->job == NULL ) {
+			break;
+		}
+		pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+
+		//run the process; it returns here right after its bsp_end
+		struct mcbsp_thread_data * const reused = mcbsp_internal_reuse_thread_data( worker, worker->job );
+		if( reused == NULL ) {
+			(void)mcbsp_internal_spmd( worker->job );
+		} else {
+			(void)mcbsp_internal_spmd_start( reused );
+		}
+
+		//park
+		pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+		worker->job = NULL;
+		pthread_cond_broadcast( &mcbsp_internal_pool_idle );
+	}
+	pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+	pthread_cleanup_pop( 1 );
+	return NULL;
 }
 
+struct mcbsp_pool_worker * mcbsp_internal_pool_acquire( struct mcbsp_thread_data * const data, const size_t core ) {
+	cpu_set_t mask;
+	CPU_ZERO( &mask );
+	CPU_SET ( core, &mask );
+
+	pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+	if( mcbsp_internal_pool.array == NULL ) {
+		mcbsp_util_stack_initialise( &mcbsp_internal_pool, sizeof( struct mcbsp_pool_worker * ) );
+	}
+
+	//find a parked worker, preferably one that is pinned to the requested hardware thread already
+	struct mcbsp_pool_worker * worker = NULL;
+	struct mcbsp_pool_worker * * const workers = mcbsp_internal_pool.array;
+	for( size_t i = 0; i < mcbsp_internal_pool.top; ++i ) {
+		if( workers[ i ]->job == NULL ) {
+			if( worker == NULL || workers[ i ]->pinned == core ) {
+				worker = workers[ i ];
+			}
+			if( worker->pinned == core ) {
+				break;
+			}
+		}
+	}
+
+	if( worker == NULL ) {
+		//spawn a new worker
+		worker = mcbsp_util_malloc( sizeof( struct mcbsp_pool_worker ), "mcbsp_internal_pool_acquire worker" );
+		pthread_cond_init( &(worker->wakeup), NULL );
+		worker->job       = data;
+		worker->spare     = NULL;
+		worker->spare_P   = 0;
+		worker->pinned    = core;
+		worker->dismissed = false;
+		data->worker      = worker;
+		pthread_attr_t attr;
+		pthread_attr_init( &attr );
+		pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+		pthread_attr_setaffinity_np( &attr, sizeof( cpu_set_t ), &mask );
+		const int pthr_rval = pthread_create( &(worker->thread), &attr, mcbsp_internal_pool_main, worker );
+		if( pthr_rval != 0 ) {
+			fprintf( stderr, "Could not spawn new thread (%s)!\n", strerror( pthr_rval ) );
+			mcbsp_util_fatal();
+		}
+		pthread_attr_destroy( &attr );
+		mcbsp_util_stack_push( &mcbsp_internal_pool, &worker );
+	} else {
+		//re-pin if necessary, and wake up the parked worker
+		if( worker->pinned != core ) {
+			pthread_setaffinity_np( worker->thread, sizeof( cpu_set_t ), &mask );
+			worker->pinned = core;
+		}
+		worker->job  = data;
+		data->worker = worker;
+		pthread_cond_signal( &(worker->wakeup) );
+	}
+	pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+	return worker;
+}
+
+void mcbsp_internal_pool_release( struct mcbsp_thread_data * const data ) {
+	struct mcbsp_pool_worker * const worker = data->worker;
+	assert( worker != NULL && worker->spare == NULL );
+	worker->spare   = data;
+	worker->spare_P = data->init->P;
+}
+
+void mcbsp_internal_pool_wait( struct mcbsp_pool_worker * const worker ) {
+	pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+	while( worker->job != NULL ) {
+		pthread_cond_wait( &mcbsp_internal_pool_idle, &mcbsp_internal_pool_mutex );
+	}
+	pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+}
+
+void mcbsp_internal_pool_dismiss( const bool wait ) {
+	pthread_mutex_lock( &mcbsp_internal_pool_mutex );
+	struct mcbsp_pool_worker * * const workers = mcbsp_internal_pool.array;
+	for( size_t i = 0; i < mcbsp_internal_pool.top; ) {
+		struct mcbsp_pool_worker * const worker = workers[ i ];
+		if( worker->job == NULL && !worker->dismissed ) {
+			worker->dismissed = true;
+			++mcbsp_internal_pool_leaving;
+			workers[ i ] = workers[ --(mcbsp_internal_pool.top) ];
+			pthread_cond_signal( &(worker->wakeup) );
+		} else {
+			++i;
+		}
+	}
+	while( wait && mcbsp_internal_pool_leaving > 0 ) {
+		pthread_cond_wait( &mcbsp_internal_pool_idle, &mcbsp_internal_pool_mutex );
+	}
+	pthread_mutex_unlock( &mcbsp_internal_pool_mutex );
+}
+#endif
+
 #ifdef MCBSP_WITH_DMTCP
 int mcbsp_internal_call_checkpoint( void ) {
 	const int rc = dmtcp_checkpoint();
@@ -36,6 +36,7 @@
 #include "mcbsp-affinity.h"
 #include "mcbsp-profiling.h"
 #include "mcbsp-resiliency.h"
+#include "mcbsp-collectives.h"
 
 //hidden includes (from library user's perspective):
 
@@ -51,6 +52,11 @@
  #include <windows.h>
 #endif
 
+#ifdef __linux__
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
 #ifdef MCBSP_WITH_DMTCP
  #include <dmtcp.h>
 #endif
@@ -174,6 +180,119 @@ struct mcbsp_superstep_stats {
 
 };
 
+/**
+ * A barrier flag padded to its own cache line(s), used by the scalable
+ * barrier algorithms (see enum mcbsp_barrier_mode).
+ *
+ * Flags record barrier episodes, which only ever increase. A waiter hence
+ * passes once a flag is at least its own episode, which makes the flags safe
+ * for back-to-back barriers without resetting them.
+ */
+struct mcbsp_barrier_flag {
+
+	/** The latest barrier episode signalled through this flag. */
+	size_t episode;
+
+	/**
+	 * For the flags of the combining tree, the number of arrivals at
+	 * this node during the current episode. For per-process flags, the
+	 * episode this process last entered.
+	 */
+	size_t count;
+
+	/**
+	 * For per-process flags, how long (in nanoseconds) this process
+	 * spins before it blocks.
+	 */
+	size_t spin_window;
+
+	/**
+	 * For per-process flags, the exponentially weighted average time
+	 * (in nanoseconds) this process waited at a barrier.
+	 */
+	size_t average_wait;
+
+	/** Keeps different flags on different cache lines. */
+	char padding[ MCBSP_ALIGNMENT - 4 * sizeof( size_t ) ];
+};
+
+/**
+ * The iterations a process owns during bsp_parallel_for, organised as a
+ * Chase-Lev work-stealing deque of chunks. Chunk k covers the grain
+ * iterations starting at begin + k * grain, cut off at end, so that no
+ * array of tasks is required. The owner takes chunks at the bottom of
+ * the deque, while other processes steal chunks at its top.
+ */
+struct mcbsp_loop_deque {
+
+	/** The next chunk to be stolen. */
+	size_t top;
+
+	/** One past the next chunk to be taken by the owner. */
+	size_t bottom;
+
+	/** The first iteration owned by this process. */
+	size_t begin;
+
+	/** One past the last iteration owned by this process. */
+	size_t end;
+
+	/** Keeps different deques on different cache lines. */
+	char padding[ MCBSP_ALIGNMENT - 4 * sizeof( size_t ) ];
+};
+
+/**
+ * A worker thread that outlives the SPMD section it ran. Between
+ * sections, workers are parked on their wakeup condition until
+ * bsp_begin hands them new thread-local data to run with.
+ */
+struct mcbsp_pool_worker {
+
+	/** The POSIX thread of this worker. */
+	pthread_t thread;
+
+	/** Signalled when this worker receives work or is dismissed. */
+	pthread_cond_t wakeup;
+
+	/** The thread-local data to run with; NULL while parked. */
+	struct mcbsp_thread_data * job;
+
+	/**
+	 * The thread-local data of the last SPMD section this worker
+	 * ran, kept so that its communication queues can be reused.
+	 */
+	struct mcbsp_thread_data * spare;
+
+	/** The number of processes of the section spare belonged to. */
+	size_t spare_P;
+
+	/** The hardware thread this worker is pinned to. */
+	size_t pinned;
+
+	/** Whether this worker should terminate once parked. */
+	bool dismissed;
+
+};
+
+/**
+ * Shared state that lets processes block at a barrier, once they
+ * spun for longer than their spin window.
+ */
+struct mcbsp_barrier_wakeup {
+
+	/**
+	 * The futex word blocked processes wait on. It changes whenever a
+	 * barrier is signalled while processes are blocked.
+	 */
+	int word;
+
+	/** The number of processes that (are about to) block. */
+	size_t sleepers;
+
+	/** Keeps the wake-up state on its own cache line. */
+	char padding[ MCBSP_ALIGNMENT - 2 * sizeof( size_t ) ];
+};
+
 /**
  * Initialisation struct.
  * 
@@ -213,6 +332,24 @@ struct mcbsp_init_data {
 	/** Currently active tag size. */
 	size_t tagSize;
 
+	/**
+	 * Counts the processes that require the full, three-barrier
+	 * bsp_sync, because of pending (de-)registrations, tag size
+	 * changes, or bsp_get requests. Counter
+	 * (superstep % 3) is used by bsp_sync number superstep; a
+	 * third counter lets process 0 reset one counter while the
+	 * other two may be in use.
+	 */
+	size_t sync_pending[ 3 ];
+
+	/**
+	 * Counts the processes that queued communication reading directly
+	 * from their own memory (see mcbsp_thread_data.sources_pending).
+	 * When nonzero, bsp_sync receives such communication before any
+	 * buffered put, separated by a barrier. Indexed as sync_pending.
+	 */
+	size_t unbuffered_pending[ 3 ];
+
 	/**
 	 * ID of the top-level run, if available.
 	 *
@@ -246,6 +383,11 @@ struct mcbsp_init_data {
 	/** Threads corresponding to this BSP program. */
 	pthread_t *threads;
 
+#ifdef MCBSP_THREAD_POOL
+	/** Pooled workers running processes 1 to P-1 of this BSP program. */
+	struct mcbsp_pool_worker * * workers;
+#endif
+
 	/** Pointers to all thread-local data, as needed for communication. */
 	struct mcbsp_thread_data * * threadData;
 
@@ -271,6 +413,35 @@ struct mcbsp_init_data {
 	 */
 	unsigned char * sl_end_condition;
 
+	/**
+	 * Per-round arrival flags of the dissemination and tournament
+	 * barriers, or the nodes of the combining tree barrier. NULL when
+	 * the central barrier is in use.
+	 */
+	struct mcbsp_barrier_flag * barrier_flags;
+
+	/**
+	 * Per-process barrier state: the episode counter and adaptive spin
+	 * window of each process, and the wake-up flags of the tournament
+	 * barrier.
+	 */
+	struct mcbsp_barrier_flag * barrier_local;
+
+	/** Shared state for blocking at and waking up from barriers. */
+	struct mcbsp_barrier_wakeup * barrier_wakeup;
+
+	/** The work-stealing deque of each process; see bsp_parallel_for. */
+	struct mcbsp_loop_deque * loop_deques;
+
+	/** The maximum spin window (in nanoseconds) of any process. */
+	size_t barrier_spin_window;
+
+	/** Number of rounds of the dissemination and tournament barriers. */
+	size_t barrier_rounds;
+
+	/** Arity of the leaves of the combining tree barrier. */
+	size_t barrier_leaf_arity;
+
 	/** Stores any previous thread-local data. Used for nested runs. */
 	struct mcbsp_thread_data * prev_data;
 
@@ -318,6 +489,9 @@ struct mcbsp_init_data {
 	 */
 	pthread_cond_t end_condition;
 
+	/** The barrier algorithm used by mcbsp_internal_spinlock. */
+	enum mcbsp_barrier_mode barrier;
+
 	/** Passed argc from bsp_init. */
 	int argc;
 
@@ -370,24 +544,60 @@ struct mcbsp_thread_data {
 	struct mcbsp_init_data * init;
 
 	/**
-	 * The communication queues used for bsp_get
+	 * The communication queue used for bsp_get
 	 * requests.
 	 */
-	struct mcbsp_util_stack * request_queues;
+	struct mcbsp_util_stack request_queue;
 
 	/**
-	 * The communication queues used for all DRMA
-	 * and BSMP communication.
+	 * The queue of bsp_get_strided requests issued
+	 * during the current superstep.
 	 */
-	struct mcbsp_util_stack * queues;
+	struct mcbsp_util_stack strided_gets;
 
-	/** 
-	 * The communication queues used for bsp_hpsend
-	 * requests. Kept separately from bsp_hpget and
-	 * bsp_hpput queues since they are handled quite
-	 * differently.
+	/**
+	 * Two sets of P pointers to the queues this process
+	 * fills for each destination process, used in
+	 * alternating supersteps: set (superstep % 2) starts
+	 * at index (superstep % 2) * P. Receivers may thus
+	 * still drain the queues of a superstep while this
+	 * process already queues requests for the next.
+	 * An entry stays NULL until this process first
+	 * communicates with that destination, so that pairs
+	 * of processes that never communicate cost only the
+	 * pointer.
+	 *
+	 * @see mcbsp_outbox
 	 */
-	struct mcbsp_util_stack * hpsend_queues;
+	struct mcbsp_outbox ** outboxes;
+
+	/**
+	 * Per superstep parity, the list of outboxes other
+	 * processes (or this process) filled for this process.
+	 * A sender adds its outbox on its first request to
+	 * this process in a superstep; during bsp_sync this
+	 * process takes the list over, so that synchronisation
+	 * only visits communicating pairs.
+	 */
+	struct mcbsp_outbox * senders[ 2 ];
+
+	/**
+	 * Scratch space holding the outboxes taken from
+	 * senders, sorted on their source process, while
+	 * bsp_sync handles them.
+	 */
+	struct mcbsp_util_stack active;
+
+	/** The number of bsp_syncs this process completed. */
+	size_t superstep;
+
+	/**
+	 * The number of supersteps for which this process
+	 * has handled all incoming communication. Other
+	 * processes wait on this before directly accessing
+	 * the memory of this process.
+	 */
+	size_t delivered;
 
 	/** Local address to global variable map. */
 	struct mcbsp_util_address_map local2global;
@@ -406,9 +616,52 @@ struct mcbsp_thread_data {
 	 */
 	struct mcbsp_util_stack hpdrma_queue;
 
-	/** The BSMP incoming message queue. */
+	/**
+	 * The BSMP incoming message queue. This is a stack of
+	 * struct bsp_message, which refer to the messages in
+	 * the communication queues of their senders, or in
+	 * bsmp_copies for messages sent by bsp_hpsend.
+	 */
 	struct mcbsp_util_stack bsmp;
 
+	/** Copies of the tags and payloads received by bsp_hpsend. */
+	struct mcbsp_util_arena bsmp_copies;
+
+	/**
+	 * Changes whenever the BSMP queue loses messages, i.e., on every
+	 * bsp_sync, bsp_move, and bsp_hpmove; message iterators started
+	 * on an older generation are invalid.
+	 */
+	size_t bsmp_generation;
+
+	/**
+	 * The number of buckets the BSMP messages delivered by the last
+	 * bsp_sync were sorted into, or 0 if they were not sorted.
+	 */
+	size_t bsmp_buckets;
+
+	/** Assigns BSMP messages to buckets; NULL groups them by source. */
+	bsp_bucket_function_t bsmp_bucket;
+
+	/** The number of buckets requested by bsp_set_message_buckets. */
+	size_t new_bsmp_buckets;
+
+	/** The bucket function requested by bsp_set_message_buckets. */
+	bsp_bucket_function_t new_bsmp_bucket;
+
+	/**
+	 * Incoming BSMP messages with their sort keys, while they are
+	 * sorted into buckets. The second stack is scratch space.
+	 */
+	struct mcbsp_util_stack bsmp_entries[ 2 ];
+
+	/**
+	 * Bucket b occupies the BSMP queue from bsmp_starts[ b + 1 ] up
+	 * to bsmp_starts[ b ]. Holds max( bsmp_buckets, P ) + 1 entries,
+	 * or equals NULL if bsmp_buckets is 0.
+	 */
+	size_t * bsmp_starts;
+
 	/** Where to store any profiling statistics. */
 	struct mcbsp_util_stack profile;
 
@@ -439,6 +692,62 @@ struct mcbsp_thread_data {
 	/** Stores statistics on the current superstep. */
 	struct mcbsp_superstep_stats superstep_stats;
 
+	/** Source buffer published to the other processes by a collective. */
+	const void * coll_source;
+
+	/** Destination buffer published to the other processes by a collective. */
+	void * coll_destination;
+
+	/**
+	 * Scratch space holding partial results of collectives. Peers may read
+	 * from this buffer while a collective is in progress.
+	 */
+	void * coll_buffer;
+
+	/** Size of coll_buffer, in bytes. */
+	size_t coll_buffer_size;
+
+	/**
+	 * Whether this process queued bsp_hpsend or bsp_put_deferred
+	 * requests, or executed a communication plan, during the current
+	 * superstep. Receivers copy their payloads from our memory, so
+	 * bsp_sync receives these before any buffered put, and returns
+	 * only after all receivers copied them.
+	 */
+	bool sources_pending;
+
+	/** Whether bsp_sync_begin was called without bsp_sync_end. */
+	bool sync_begun;
+
+	/** Whether bsp_sync_begin announced our arrival at the barrier. */
+	bool arrived;
+
+	/** The value of bsp_time when the current synchronisation began. */
+	double sync_start;
+
+	/** The communication plan being recorded, or NULL. */
+	struct mcbsp_plan * recording;
+
+	/** The pooled worker running this process, or NULL if it is not pooled. */
+	struct mcbsp_pool_worker * worker;
+
+	/** The NUMA node this process was initialised on; see mcbsp_util_numa_node. */
+	size_t numa_node;
+
+	/**
+	 * The communication plans executed during the current
+	 * superstep, per parity; the puts they record for a process
+	 * are copied by that process during the next bsp_sync.
+	 */
+	struct mcbsp_util_stack plan_sets[ 2 ];
+
+	/**
+	 * Lowest and one-past-highest address written by the bsp_get
+	 * requests of the current superstep. Gets reading from outside
+	 * this range at this process copy directly from the source.
+	 */
+	char * get_low, * get_high;
+
 #ifdef __MACH__
 	/** Mach OS X port for getting timings. */
 	clock_serv_t clock;
@@ -484,6 +793,66 @@ struct mcbsp_get_request {
 	/** Length */
 	size_t length;
 
+	/** Process owning the source */
+	size_t pid;
+
+};
+
+/**
+ *  A DRMA communication request for strided `get'-requests.
+ *  @see bsp_get_strided
+ */
+struct mcbsp_strided_get_request {
+
+	/** Source of the first block */
+	const void * source;
+
+	/** Destination of the first block */
+	void * destination;
+
+	/** Distance between successive source blocks */
+	size_t source_stride;
+
+	/** Distance between successive destination blocks */
+	size_t destination_stride;
+
+	/** Size of a single block */
+	size_t block;
+
+	/** Number of blocks */
+	size_t count;
+
+	/** Process owning the source */
+	size_t pid;
+
+};
+
+/**
+ * Length of an mcbsp_message that carries a strided or indexed
+ * put. Such messages are followed on the queue by an mcbsp_pattern,
+ * optionally the destination offsets, and the packed payload.
+ */
+#define MCBSP_PATTERN_LENGTH SIZE_MAX
+
+/**
+ *  Describes how a packed payload is scattered over its destination.
+ *  @see bsp_put_strided
+ *  @see bsp_put_indexed
+ */
+struct mcbsp_pattern {
+
+	/** Size of a single block */
+	size_t block;
+
+	/** Number of blocks */
+	size_t count;
+
+	/**
+	 * Distance between successive destination blocks, or
+	 * SIZE_MAX when the blocks are placed at explicit offsets
+	 */
+	size_t stride;
+
 };
 
 /**
@@ -505,8 +874,8 @@ struct mcbsp_message {
 };
 
 /**
- *  A DRMA communication request for hpput
- *  and hpget requests.
+ *  A DRMA communication request for hpput,
+ *  hpget, and put_deferred requests.
  */
 struct mcbsp_hp_request {
 
@@ -528,6 +897,79 @@ struct mcbsp_hp_request {
 	bool source_is_remote;
 };
 
+/** A bsp_put recorded in a communication plan. */
+struct mcbsp_plan_put {
+
+	/** Destination process */
+	size_t pid;
+
+	/** Source, buffered when the plan is executed */
+	const void * source;
+
+	/** Resolved destination address */
+	void * destination;
+
+	/** Payload length */
+	size_t size;
+
+};
+
+/** A bsp_send recorded in a communication plan. */
+struct mcbsp_plan_send {
+
+	/** Destination process */
+	size_t pid;
+
+	/** Payload, read when the plan is executed */
+	const void * payload;
+
+	/** Payload length */
+	size_t size;
+
+	/** Offset of the tag copy in the tags of the plan */
+	size_t tag_offset;
+
+};
+
+/**
+ * A recorded communication pattern of a single process.
+ * @see bsp_plan_begin
+ * @see bsp_execute_plan
+ */
+struct mcbsp_plan {
+
+	/** Number of processes when the plan was recorded. */
+	size_t P;
+
+	/** The recorded deferred puts, as mcbsp_hp_request, per destination process. */
+	struct mcbsp_util_stack * puts;
+
+	/** The destination processes of the recorded deferred puts. */
+	struct mcbsp_util_stack targets;
+
+	/** The recorded bsp_puts, as mcbsp_plan_put. */
+	struct mcbsp_util_stack buffered;
+
+	/** The recorded gets, as mcbsp_get_request. */
+	struct mcbsp_util_stack gets;
+
+	/** The recorded strided gets, as mcbsp_strided_get_request. */
+	struct mcbsp_util_stack strided_gets;
+
+	/** Lowest and one-past-highest address written by the recorded gets. */
+	char * get_low, * get_high;
+
+	/** The recorded sends. */
+	struct mcbsp_util_stack sends;
+
+	/** Copies of the tags of the recorded sends. */
+	struct mcbsp_util_stack tags;
+
+	/** Tag size when the plan was recorded. */
+	size_t tagSize;
+
+};
+
 /**
  *  A high-performance (non-buffering) BSMP message request.
  *  @see bsp_hpsend.
@@ -545,6 +987,56 @@ struct mcbsp_hpsend_request {
 
 };
 
+/**
+ * All communication one process queued for one other process during a
+ * superstep. Allocated on first use; see mcbsp_thread_data.outboxes.
+ */
+struct mcbsp_outbox {
+
+	/**
+	 * The buffered DRMA and BSMP requests. This is a chunked arena,
+	 * so that queued data is never moved when the queue grows, and
+	 * so that a drained queue keeps its capacity.
+	 */
+	struct mcbsp_util_arena queue;
+
+	/** The bsp_hpsend requests, as mcbsp_hpsend_request. */
+	struct mcbsp_util_stack hpsends;
+
+	/**
+	 * The bsp_put_deferred requests, as mcbsp_hp_request. The
+	 * receiver copies directly from the memory of the sender.
+	 */
+	struct mcbsp_util_stack deferred;
+
+	/** The ID of the sending process. */
+	size_t source;
+
+	/** Whether this outbox is in the senders list of its receiver. */
+	bool listed;
+
+	/** The next outbox in the senders list of the receiver. */
+	struct mcbsp_outbox * next;
+
+};
+
+/**
+ * An incoming BSMP message, along with the keys it is sorted on.
+ * @see bsp_set_message_buckets.
+ */
+struct mcbsp_bsmp_entry {
+
+	/** The message. */
+	struct bsp_message message;
+
+	/** The process that sent the message. */
+	size_t source;
+
+	/** The bucket the message belongs to. */
+	size_t bucket;
+
+};
+
 /** Struct corresponding to a single push request. */
 struct mcbsp_push_request {
 
@@ -554,6 +1046,9 @@ struct mcbsp_push_request {
 	/** The memory range to register. */
 	size_t size;
 
+	/** Where to store the memory slot of this registration, if not NULL. */
+	bsp_memslot_t * slot;
+
 };
 
 /** Per-initialising thread initialisation data. */
@@ -622,6 +1117,10 @@ void mcbsp_internal_check_aborted( void );
  * Alias for mcbsp_internal_syncWithCondition using
  * the standard init.condition
  *
+ * If the SPMD group selected one of the scalable barrier
+ * algorithms, this function dispatches to that barrier
+ * instead, and cond is ignored.
+ *
  * @param init   Pointer to the BSP init corresponding
  *               to our current SPMD group.
  * @param cond   The array to spinlock on.
@@ -630,6 +1129,132 @@ void mcbsp_internal_check_aborted( void );
  */
 void mcbsp_internal_spinlock( struct mcbsp_init_data * const init, unsigned char * const cond, const size_t bsp_id );
 
+/**
+ * First half of mcbsp_internal_spinlock: announces the arrival of the
+ * calling thread without waiting for the others. Only the central barrier
+ * supports this.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param cond   The array to spinlock on.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ *
+ * @return Whether arrival was announced. If not, the caller
+ *         should call mcbsp_internal_spinlock instead of
+ *         mcbsp_internal_spinlock_complete.
+ */
+bool mcbsp_internal_spinlock_arrive( struct mcbsp_init_data * const init, unsigned char * const cond, const size_t bsp_id );
+
+/**
+ * Second half of mcbsp_internal_spinlock: waits until all threads
+ * announced their arrival via mcbsp_internal_spinlock_arrive.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param cond   The array to spinlock on.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ */
+void mcbsp_internal_spinlock_complete( struct mcbsp_init_data * const init, unsigned char * const cond, const size_t bsp_id );
+
+/**
+ * Allocates the state of the barrier algorithm selected
+ * by the given machine info, for use by the SPMD group
+ * of the given init struct. Requires init->P to be set.
+ *
+ * @param init    Pointer to the BSP init corresponding
+ *                to the SPMD group to be started.
+ * @param machine The machine info to take the barrier
+ *                mode and thread layout from.
+ */
+void mcbsp_internal_barrier_initialise( struct mcbsp_init_data * const init, const struct mcbsp_util_machine_info * const machine );
+
+/**
+ * Frees the barrier state allocated by
+ * mcbsp_internal_barrier_initialise.
+ *
+ * @param init Pointer to the BSP init of an SPMD group
+ *             that has ended.
+ */
+void mcbsp_internal_barrier_destroy( struct mcbsp_init_data * const init );
+
+/**
+ * Waits until a barrier condition holds, or until the
+ * SPMD run aborts.
+ *
+ * The calling process first polls the condition while
+ * spinning with exponential backoff, for at most its
+ * spin window. It then blocks, and is woken up by
+ * mcbsp_internal_barrier_wake. Afterwards, the spin
+ * window is adapted to the observed waiting time: it
+ * grows to cover short waits, but collapses when waits
+ * routinely exceed init->barrier_spin_window, as then
+ * spinning only wastes CPU time.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ * @param passed Returns whether the condition holds.
+ * @param arg    The argument to passed.
+ */
+void mcbsp_internal_barrier_wait( struct mcbsp_init_data * const init, const size_t bsp_id,
+	bool (* const passed)( const void * const ), const void * const arg );
+
+/**
+ * Wakes up all processes blocked in
+ * mcbsp_internal_barrier_wait, if any. Must be called
+ * after every update of barrier state that may make a
+ * waiting condition hold, and after an abort.
+ *
+ * @param init Pointer to the BSP init corresponding
+ *             to our current SPMD group.
+ */
+void mcbsp_internal_barrier_wake( struct mcbsp_init_data * const init );
+
+/**
+ * Waits until a process handled all incoming
+ * communication of the given number of supersteps, so
+ * that its memory may be accessed directly.
+ *
+ * @param init      Pointer to the BSP init corresponding
+ *                  to our current SPMD group.
+ * @param pid       The process to wait for.
+ * @param superstep The number of supersteps to wait for.
+ */
+void mcbsp_internal_wait_delivered( const struct mcbsp_init_data * const init, const size_t pid, const size_t superstep );
+
+/**
+ * Dissemination barrier; see MCBSP_BARRIER_DISSEMINATION.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ */
+void mcbsp_internal_dissemination_barrier( struct mcbsp_init_data * const init, const size_t bsp_id );
+
+/**
+ * Tournament barrier; see MCBSP_BARRIER_TOURNAMENT.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ */
+void mcbsp_internal_tournament_barrier( struct mcbsp_init_data * const init, const size_t bsp_id );
+
+/**
+ * Combining tree barrier; see MCBSP_BARRIER_TREE.
+ *
+ * @param init   Pointer to the BSP init corresponding
+ *               to our current SPMD group.
+ * @param bsp_id The unique ID number corresponding to
+ *               the thread that calls this function.
+ */
+void mcbsp_internal_tree_barrier( struct mcbsp_init_data * const init, const size_t bsp_id );
+
 /**
  * Alias for mcbsp_internal_syncWithCondition using
  * the standard init.condition
@@ -673,6 +1298,15 @@ struct mcbsp_thread_data * mcbsp_internal_allocate_thread_data( struct mcbsp_ini
  */
 struct mcbsp_thread_data * mcbsp_internal_initialise_thread_data( struct mcbsp_thread_data * const data );
 
+/**
+ * Allocates an empty outbox of a process.
+ *
+ * @param data  The thread data of the sending process.
+ * @param index The entry of data->outboxes the outbox is for.
+ * @return The new outbox, which is also stored at that entry.
+ */
+struct mcbsp_outbox * mcbsp_internal_create_outbox( struct mcbsp_thread_data * const data, const size_t index );
+
 /**
  * Deallocates a fully initialised mcbsp_thread_data struct.
  *
@@ -680,6 +1314,43 @@ struct mcbsp_thread_data * mcbsp_internal_initialise_thread_data( struct mcbsp_t
  */
 void mcbsp_internal_destroy_thread_data( struct mcbsp_thread_data * const data );
 
+#ifdef MCBSP_THREAD_POOL
+/**
+ * Hands thread-local data to a parked worker, which then starts the
+ * SPMD program as the corresponding process. Prefers a worker that is
+ * already pinned to the requested hardware thread; spawns a new worker
+ * if none are parked.
+ *
+ * @param data Partially initialised thread-local data, as returned by
+ *             mcbsp_internal_allocate_thread_data.
+ * @param core The hardware thread to pin the worker to.
+ * @return The worker that runs the process.
+ */
+struct mcbsp_pool_worker * mcbsp_internal_pool_acquire( struct mcbsp_thread_data * const data, const size_t core );
+
+/**
+ * Ends the process of the calling pooled worker, retaining its thread-local
+ * data for reuse. The worker parks once its SPMD entry point returned.
+ *
+ * @param data The thread-local data of the calling process.
+ */
+void mcbsp_internal_pool_release( struct mcbsp_thread_data * const data );
+
+/**
+ * Waits until a worker has completed its process and is parked.
+ *
+ * @param worker The worker to wait for.
+ */
+void mcbsp_internal_pool_wait( struct mcbsp_pool_worker * const worker );
+
+/**
+ * Terminates all parked workers.
+ *
+ * @param wait Whether to wait for the workers to have terminated.
+ */
+void mcbsp_internal_pool_dismiss( const bool wait );
+#endif
+
 /**
  * Does the checkpointing from within a critical section.
  * THIS MEANS THIS FUNCTION IS NOT THREADSAFE. Restoring from
@@ -49,17 +49,23 @@ struct mcbsp_util_machine_info *mcbsp_util_createMachineInfo( void ) {
 	MCBSP_MACHINE_INFO->UTset  = false;
 	MCBSP_MACHINE_INFO->CPFset = false;
 	MCBSP_MACHINE_INFO->SCFset = false;
+	MCBSP_MACHINE_INFO->Bset   = false;
+	MCBSP_MACHINE_INFO->SWset  = false;
 	MCBSP_MACHINE_INFO->threads            = 0;
 	MCBSP_MACHINE_INFO->affinity           = MCBSP_DEFAULT_AFFINITY;
 	MCBSP_MACHINE_INFO->cores              = 0;
 	MCBSP_MACHINE_INFO->threads_per_core   = MCBSP_DEFAULT_THREADS_PER_CORE;
 	MCBSP_MACHINE_INFO->thread_numbering   = MCBSP_DEFAULT_THREAD_NUMBERING;
+	MCBSP_MACHINE_INFO->barrier            = MCBSP_DEFAULT_BARRIER;
+	MCBSP_MACHINE_INFO->spin_window        = MCBSP_DEFAULT_SPIN_WINDOW;
 	MCBSP_MACHINE_INFO->manual_affinity    = NULL;
 	MCBSP_MACHINE_INFO->num_reserved_cores = 0;
 	MCBSP_MACHINE_INFO->reserved_cores     = NULL;
 	MCBSP_MACHINE_INFO->unused_threads_per_core = 0;
 	MCBSP_MACHINE_INFO->cp_f               = MCBSP_DEFAULT_CHECKPOINT_FREQUENCY;
 	MCBSP_MACHINE_INFO->safe_cp_f          = MCBSP_DEFAULT_CHECKPOINT_FREQUENCY;
+	MCBSP_MACHINE_INFO->topology           = NULL;
+	MCBSP_MACHINE_INFO->topology_size      = 0;
 
 	//keep track whether we have set machine settings
 	//that don't have straightforward defaults
@@ -183,6 +189,12 @@ struct mcbsp_util_machine_info *mcbsp_util_createMachineInfo( void ) {
 							MCBSP_MACHINE_INFO->affinity = COMPACT;
 						} else if( strcmp( value, "manual" ) == 0 ) {
 							MCBSP_MACHINE_INFO->affinity = MANUAL;
+						} else if( strcmp( value, "numa-balanced" ) == 0 ) {
+							MCBSP_MACHINE_INFO->affinity = NUMA_BALANCED;
+						} else if( strcmp( value, "l3-compact" ) == 0 ) {
+							MCBSP_MACHINE_INFO->affinity = L3_COMPACT;
+						} else if( strcmp( value, "one-per-physical-core" ) == 0 ) {
+							MCBSP_MACHINE_INFO->affinity = ONE_PER_PHYSICAL_CORE;
 						} else {
 							fprintf( stderr, "Warning: unkown value for the `affinity' key in machine.info (%s); reverting to default value.\n", value );
 							success = false;
@@ -192,6 +204,40 @@ struct mcbsp_util_machine_info *mcbsp_util_createMachineInfo( void ) {
 					if( !success ) {
 						MCBSP_MACHINE_INFO->affinity = MCBSP_DEFAULT_AFFINITY;
 					}
+				//check for barrier key
+				} else if( !MCBSP_MACHINE_INFO->Bset && strcmp( key, "barrier" ) == 0 ) {
+					char value[ 255 ];
+					bool success = true;
+					if( sscanf( LINE_BUFFER, "%s %s", key, value ) != 2 ) {
+						fprintf( stderr, "Warning: parsing error while processing `barrier' key in machine.info (reverting to default) at: %s", LINE_BUFFER );
+						success = false;
+					} else {
+						if( strcmp( value, "central" ) == 0 ) {
+							MCBSP_MACHINE_INFO->barrier = MCBSP_BARRIER_CENTRAL;
+						} else if( strcmp( value, "dissemination" ) == 0 ) {
+							MCBSP_MACHINE_INFO->barrier = MCBSP_BARRIER_DISSEMINATION;
+						} else if( strcmp( value, "tournament" ) == 0 ) {
+							MCBSP_MACHINE_INFO->barrier = MCBSP_BARRIER_TOURNAMENT;
+						} else if( strcmp( value, "tree" ) == 0 ) {
+							MCBSP_MACHINE_INFO->barrier = MCBSP_BARRIER_TREE;
+						} else {
+							fprintf( stderr, "Warning: unkown value for the `barrier' key in machine.info (%s); reverting to default value.\n", value );
+							success = false;
+						}
+					}
+					//if an error occurred, revert to default
+					if( !success ) {
+						MCBSP_MACHINE_INFO->barrier = MCBSP_DEFAULT_BARRIER;
+					}
+				//check for spin_window key
+				} else if( !MCBSP_MACHINE_INFO->SWset && strcmp( key, "spin_window" ) == 0 ) {
+					unsigned long int value;
+					if( sscanf( LINE_BUFFER, "%s %lu", key, &value ) != 2 ) {
+						fprintf( stderr, "Warning: parsing error while processing `spin_window' key (reverting to default) in machine.info at: %s", LINE_BUFFER );
+						MCBSP_MACHINE_INFO->spin_window = MCBSP_DEFAULT_SPIN_WINDOW;
+					} else {
+						MCBSP_MACHINE_INFO->spin_window = (size_t)value;
+					}
 				//check for pinning key
 				} else if( !MCBSP_MACHINE_INFO->Pset && strcmp( key, "pinning" ) == 0 ) {
 					//if P was not set yet, set P to the maximum and assume user will supply complete pinning list
@@ -351,6 +397,11 @@ void mcbsp_util_destroyMachineInfo( void * machine_info ) {
 			MCBSP_MACHINE_INFO->num_reserved_cores = 0;
 			MCBSP_MACHINE_INFO->reserved_cores = NULL;
 		}
+		//if the topology was read
+		if( MCBSP_MACHINE_INFO->topology != NULL ) {
+			free( MCBSP_MACHINE_INFO->topology );
+			MCBSP_MACHINE_INFO->topology = NULL;
+		}
 		//delete it
 		free( MCBSP_MACHINE_INFO );
 		MCBSP_MACHINE_INFO = NULL;
@@ -467,6 +518,21 @@ struct mcbsp_util_pinning_info mcbsp_util_pinning( const size_t P, struct mcbsp_
 	//check machine info
 	mcbsp_util_check_machine_info( machine );
 
+	//the topology-based strategies need the machine topology, which is read once
+	if( machine->affinity == NUMA_BALANCED || machine->affinity == L3_COMPACT || machine->affinity == ONE_PER_PHYSICAL_CORE ) {
+		if( machine->topology == NULL ) {
+			machine->topology = mcbsp_util_read_topology( MCBSP_SYSFS_ROOT, &(machine->topology_size) );
+		}
+		if( machine->topology != NULL ) {
+			ret.pinning = mcbsp_util_topology_pinning( machine, P );
+			//like manual pinning, these strategies do not provide submachines
+			mcbsp_util_stack_initialise( &(ret.partition), sizeof( struct mcbsp_util_machine_partition ) );
+			return ret;
+		}
+		fprintf( stderr, "Warning: could not read the machine topology from %s; reverting to the scatter affinity strategy.\n", MCBSP_SYSFS_ROOT );
+		machine->affinity = SCATTER;
+	}
+
 	//available number of cores for this MulticoreBSP run
 	const size_t available_cores   = machine->cores - machine->num_reserved_cores;
 	const size_t available_threads = machine->Tset ? machine->threads : available_cores * (machine->threads_per_core-machine->unused_threads_per_core);
@@ -534,18 +600,28 @@ void mcbsp_util_stack_initialise( struct mcbsp_util_stack * const stack, const s
 	stack->array = mcbsp_util_malloc( 16 * size, "mcbsp_util_stack_initialise initial stack array" );
 }
 
+void mcbsp_util_stack_initialise_lazy( struct mcbsp_util_stack * const stack, const size_t size ) {
+	stack->cap   = 0;
+	stack->top   = 0;
+	stack->size  = size;
+	stack->array = NULL;
+}
+
 void mcbsp_util_stack_grow( struct mcbsp_util_stack * const stack ) {
 	//sanity checks
-	assert( stack->cap >= 1 );
 	assert( stack->top <= stack->cap );
+	//lazily initialised stacks start at the default capacity
+	const size_t cap = stack->cap == 0 ? 16 : 2 * stack->cap;
 	//allocate replacement array
-	void * replace = mcbsp_util_malloc( 2 * stack->cap * stack->size, "mcbsp_util_stack_grow replacement array" );
+	void * replace = mcbsp_util_malloc( cap * stack->size, "mcbsp_util_stack_grow replacement array" );
 	//copy old contents
-	mcbsp_util_memcpy( replace, stack->array, stack->top * stack->size );
+	if( stack->top > 0 ) {
+		mcbsp_util_memcpy( replace, stack->array, stack->top * stack->size );
+	}
 	//remove old contents
 	free( stack->array );
 	//set new stack parameters
-	stack->cap *= 2;
+	stack->cap   = cap;
 	stack->array = replace;
 }
 
@@ -580,6 +656,10 @@ void mcbsp_util_stack_destroy( struct mcbsp_util_stack * const stack ) {
 }
 
 void mcbsp_util_varstack_grow( struct mcbsp_util_stack * const stack, const size_t requested_size ) {
+	//lazily initialised stacks grow as though they started at the default capacity
+	if( stack->cap == 0 ) {
+		stack->cap = 16;
+	}
 	//text-book amortisation through doubling
 	stack->cap *= 2;
 	//instead of doubling again (and again, ...), simply set the new size equal to the
@@ -591,7 +671,9 @@ void mcbsp_util_varstack_grow( struct mcbsp_util_stack * const stack, const size
 	//allocate new stack content array
 	void * const replace = mcbsp_util_malloc( stack->cap, "mcbsp_util_varstack_grow replacement array" );
 	//copy old contents into new array
-	mcbsp_util_memcpy( replace, stack->array, stack->top );
+	if( stack->top > 0 ) {
+		mcbsp_util_memcpy( replace, stack->array, stack->top );
+	}
 	//delete old content array
 	free( stack->array );
 	//set new content array
@@ -609,6 +691,15 @@ extern void * mcbsp_util_varstack_regpop( struct mcbsp_util_stack * const stack
 extern void * mcbsp_util_varstack_regpeek( const struct mcbsp_util_stack * const stack );
 extern void mcbsp_util_varstack_regpush( struct mcbsp_util_stack * const stack, const void * const item );
 
+void * mcbsp_util_varstack_reserve( struct mcbsp_util_stack * const stack, const size_t size ) {
+	if( stack->top + size > stack->cap ) {
+		mcbsp_util_varstack_grow( stack, stack->top + size );
+	}
+	void * const ret = (char*)(stack->array) + stack->top;
+	stack->top += size;
+	return ret;
+}
+
 void * mcbsp_util_varstack_peek( const struct mcbsp_util_stack * const stack, const size_t size ) {
 	return ((char*)(stack->array)) + stack->top - size;
 }
@@ -621,6 +712,95 @@ void mcbsp_util_varstack_push( struct mcbsp_util_stack * const stack, const void
 	stack->top += size;
 }
 
+void mcbsp_util_arena_initialise( struct mcbsp_util_arena * const arena, const size_t size ) {
+	arena->first   = NULL;
+	arena->current = NULL;
+	arena->cap     = 0;
+	arena->size    = size;
+}
+
+//the below functions are inlined but could should be generated here for other translation units (C99)
+extern bool mcbsp_util_arena_empty( const struct mcbsp_util_arena * const arena );
+extern void mcbsp_util_arena_regpush( struct mcbsp_util_arena * const arena, const void * const item );
+extern void * mcbsp_util_arena_regpop( struct mcbsp_util_arena * const arena );
+
+/** @return The first byte of the data area of a chunk. */
+static inline char * mcbsp_util_arena_data( struct mcbsp_util_arena_chunk * const chunk ) {
+	return (char*)(chunk + 1);
+}
+
+void * mcbsp_util_arena_reserve( struct mcbsp_util_arena * const arena, const size_t size ) {
+	struct mcbsp_util_arena_chunk * chunk = arena->current;
+	if( chunk == NULL || chunk->top + size > chunk->cap ) {
+		//all chunks after the current one are empty; use the next, if it is large enough
+		struct mcbsp_util_arena_chunk * const next = chunk == NULL ? NULL : chunk->next;
+		if( next != NULL && size <= next->cap ) {
+			chunk = next;
+		} else {
+			//allocate a new chunk as large as all chunks so far, so that the total capacity doubles
+			size_t cap = arena->cap == 0 ? 16 * arena->size : arena->cap;
+			if( cap < size ) {
+				cap = size;
+			}
+			struct mcbsp_util_arena_chunk * const fresh = mcbsp_util_malloc( sizeof( struct mcbsp_util_arena_chunk ) + cap, "mcbsp_util_arena_reserve new chunk" );
+			fresh->prev = chunk;
+			fresh->next = next;
+			fresh->cap  = cap;
+			fresh->top  = 0;
+			if( next != NULL ) {
+				next->prev = fresh;
+			}
+			if( chunk == NULL ) {
+				arena->first = fresh;
+			} else {
+				chunk->next = fresh;
+			}
+			arena->cap += cap;
+			chunk = fresh;
+		}
+		arena->current = chunk;
+	}
+	void * const ret = mcbsp_util_arena_data( chunk ) + chunk->top;
+	chunk->top += size;
+	return ret;
+}
+
+void mcbsp_util_arena_push( struct mcbsp_util_arena * const arena, const void * const item, const size_t size ) {
+	mcbsp_util_memcpy( mcbsp_util_arena_reserve( arena, size ), item, size );
+}
+
+void * mcbsp_util_arena_pop( struct mcbsp_util_arena * const arena, const size_t size ) {
+	struct mcbsp_util_arena_chunk * chunk = arena->current;
+	assert( chunk != NULL && chunk->top >= size );
+	chunk->top -= size;
+	void * const ret = mcbsp_util_arena_data( chunk ) + chunk->top;
+	//keep the top item in the current chunk
+	while( chunk->top == 0 && chunk->prev != NULL ) {
+		chunk = chunk->prev;
+	}
+	arena->current = chunk;
+	return ret;
+}
+
+void mcbsp_util_arena_reset( struct mcbsp_util_arena * const arena ) {
+	for( struct mcbsp_util_arena_chunk * chunk = arena->first; chunk != NULL; chunk = chunk->next ) {
+		chunk->top = 0;
+	}
+	arena->current = arena->first;
+}
+
+void mcbsp_util_arena_destroy( struct mcbsp_util_arena * const arena ) {
+	struct mcbsp_util_arena_chunk * chunk = arena->first;
+	while( chunk != NULL ) {
+		struct mcbsp_util_arena_chunk * const next = chunk->next;
+		free( chunk );
+		chunk = next;
+	}
+	arena->first   = NULL;
+	arena->current = NULL;
+	arena->cap     = 0;
+}
+
 void mcbsp_util_address_table_initialise( struct mcbsp_util_address_table * const table, const unsigned long int P ) {
 	pthread_mutex_init( &(table->mutex), NULL );
 	table->cap   = 16;
@@ -760,6 +940,11 @@ void mcbsp_util_address_map_initialise( struct mcbsp_util_address_map * const ad
 	address_map->size   = 0;
 	address_map->keys   = mcbsp_util_malloc( 16 * sizeof( void * ), "mcbsp_util_address_map_initialise key array" );
 	address_map->values = mcbsp_util_malloc( 16 * sizeof( size_t ), "mcbsp_util_address_map_initialise value array" );
+
+	//mark all slots empty
+	for( size_t i = 0; i < 16; ++i ) {
+		address_map->values[ i ] = SIZE_MAX;
+	}
 }
 
 void mcbsp_util_address_map_grow( struct mcbsp_util_address_map * const address_map ) {
@@ -770,24 +955,34 @@ void mcbsp_util_address_map_grow( struct mcbsp_util_address_map * const address_
 	}
 #endif
 
-	//create replacement arrays
-	void * * replace_k = mcbsp_util_malloc( 2 * address_map->cap * sizeof( void * ), "mcbsp_util_address_map_grow key array" );
-	size_t * replace_v = mcbsp_util_malloc( 2 * address_map->cap * sizeof( size_t ), "mcbsp_util_address_map_grow value array" );
+	//keep old arrays
+	void * * const old_k = address_map->keys;
+	size_t * const old_v = address_map->values;
+	const size_t old_cap = address_map->cap;
 
-	//copy old values
-	for( size_t i = 0; i < (address_map->size); ++i ) {
-		replace_k[ i ] = address_map->keys[ i ];
-		replace_v[ i ] = address_map->values[ i ];
+	//create replacement arrays, with all slots empty
+	address_map->cap   *= 2;
+	address_map->keys   = mcbsp_util_malloc( address_map->cap * sizeof( void * ), "mcbsp_util_address_map_grow key array" );
+	address_map->values = mcbsp_util_malloc( address_map->cap * sizeof( size_t ), "mcbsp_util_address_map_grow value array" );
+	for( size_t i = 0; i < address_map->cap; ++i ) {
+		address_map->values[ i ] = SIZE_MAX;
 	}
 
-	//free old arrays
-	free( address_map->keys   );
-	free( address_map->values );
+	//rehash old entries
+	for( size_t i = 0; i < old_cap; ++i ) {
+		if( old_v[ i ] != SIZE_MAX ) {
+			size_t slot = mcbsp_util_address_map_hash( address_map, old_k[ i ] );
+			while( address_map->values[ slot ] != SIZE_MAX ) {
+				slot = (slot + 1) & (address_map->cap - 1);
+			}
+			address_map->keys  [ slot ] = old_k[ i ];
+			address_map->values[ slot ] = old_v[ i ];
+		}
+	}
 
-	//update struct
-	address_map->keys   = replace_k;
-	address_map->values = replace_v;
-	address_map->cap   *= 2;
+	//free old arrays
+	free( old_k );
+	free( old_v );
 }
 
 void mcbsp_util_address_map_destroy( struct mcbsp_util_address_map * const address_map ) {
@@ -802,64 +997,40 @@ void mcbsp_util_address_map_destroy( struct mcbsp_util_address_map * const addre
 	address_map->values = NULL;
 }
 
-size_t mcbsp_util_address_map_binsearch( const struct mcbsp_util_address_map * const address_map, const void * const key, size_t lo, size_t hi ) {
-
-	//check boundaries
-	if( address_map->keys[ lo ] == key ) return lo;
-	if( address_map->keys[ hi ] == key ) return hi;
+void mcbsp_util_address_map_clear( struct mcbsp_util_address_map * const address_map ) {
+	//mark all slots empty
+	for( size_t i = 0; i < address_map->cap; ++i ) {
+		address_map->values[ i ] = SIZE_MAX;
+	}
+	address_map->size = 0;
+}
 
-	//initialise search for insertion point
-	size_t mid = lo + ( ( hi - lo ) / 2 );
-	
-	//do binary search
-	do {
-		//check midpoint
-		if( address_map->keys[ mid ] == key ) {
-			return mid;
-		} else if( key < address_map->keys[ mid ] ) {
-			hi = mid;
-		} else {
-			lo = mid;
-		}
-		//get new midpoint
-		mid = lo + ( ( hi - lo ) / 2 );
-	} while( lo != mid );
-	//done, return current midpoint
-	return mid;
+size_t mcbsp_util_address_map_hash( const struct mcbsp_util_address_map * const address_map, const void * const key ) {
+	//Fibonacci hashing; the high bits of the product mix all bits of the address
+	const uint64_t product = ((uint64_t)(uintptr_t)key) * UINT64_C( 11400714819323198485 );
+	return ((size_t)(product >> 32)) & (address_map->cap - 1);
 }
 
-//FIXME this is a quadratic complexity in the worst case. Should use a Red/Black tree perhaps.
-//A note on this has been made in public user documentation in bsp.h.
 void mcbsp_util_address_map_insert( struct mcbsp_util_address_map * const address_map, void * const key, const size_t value ) {
 
-	//check capacity
-	if( address_map->size + 1 >= address_map->cap ) {
+	//check capacity; keep the load factor below 3/4 so that probe sequences stay short
+	if( 4 * (address_map->size + 1) > 3 * address_map->cap ) {
 		mcbsp_util_address_map_grow( address_map );
 	}
 
-	//use binary search to find the insertion point
-	size_t insertionPoint;
-	if( address_map->size > 0 ) {
-		insertionPoint = mcbsp_util_address_map_binsearch( address_map, key, 0, address_map->size - 1 );
-		if( address_map->keys[ insertionPoint ] == key ) {
-			fprintf( stderr, "Warning: mcbsp_util_address_map_insert ignored as key already existed (at %lu/%lu)!\n", (unsigned long int)insertionPoint, (address_map->size-1) );
+	//linear probing for the key or the first empty slot
+	size_t slot = mcbsp_util_address_map_hash( address_map, key );
+	while( address_map->values[ slot ] != SIZE_MAX ) {
+		if( address_map->keys[ slot ] == key ) {
+			fprintf( stderr, "Warning: mcbsp_util_address_map_insert ignored as key already existed (at %lu/%lu)!\n", (unsigned long int)slot, (unsigned long int)(address_map->cap) );
 			return; //error: key was already here
-		} else if( address_map->keys[ insertionPoint ] < key ) {
-			++insertionPoint; //we need to insert at position of higher key
 		}
-	} else {
-		insertionPoint = 0;
-	}
-
-	//scoot over
-	for( unsigned long int i = address_map->size; i > insertionPoint; --i ) {
-		address_map->keys  [ i ] = address_map->keys  [ i - 1 ];
-		address_map->values[ i ] = address_map->values[ i - 1 ];
+		slot = (slot + 1) & (address_map->cap - 1);
 	}
 
 	//actual insert
-	address_map->keys  [ insertionPoint ] = key;
-	address_map->values[ insertionPoint ] = value;
+	address_map->keys  [ slot ] = key;
+	address_map->values[ slot ] = value;
 	address_map->size++;
 
 	//done
@@ -872,20 +1043,31 @@ void mcbsp_util_address_map_remove( struct mcbsp_util_address_map * const addres
 		return; //there are no entries
 	}
 
-	//use binary search to find the entry to remove
-	const size_t index = mcbsp_util_address_map_binsearch( address_map, key, 0, address_map->size - 1 );
+	//find the entry to remove
+	const size_t mask = address_map->cap - 1;
+	size_t slot = mcbsp_util_address_map_hash( address_map, key );
+	while( address_map->values[ slot ] != SIZE_MAX && address_map->keys[ slot ] != key ) {
+		slot = (slot + 1) & mask;
+	}
 
 	//check equality
-	if( address_map->keys[ index ] != key ) {
+	if( address_map->values[ slot ] == SIZE_MAX ) {
 		fprintf( stderr, "Warning: mcbsp_util_address_map_remove ignored since key was not found!\n" );
 		return; //key not found
 	}
 
-	//scoot over to delete
-	for( size_t i = index; i < address_map->size - 1; ++i ) {
-		address_map->keys  [ i ] = address_map->keys  [ i + 1 ];
-		address_map->values[ i ] = address_map->values[ i + 1 ];
+	//shift back later entries of the same probe sequence, so that no tombstones are needed
+	size_t hole = slot;
+	for( size_t next = (hole + 1) & mask; address_map->values[ next ] != SIZE_MAX; next = (next + 1) & mask ) {
+		const size_t home = mcbsp_util_address_map_hash( address_map, address_map->keys[ next ] );
+		//the entry at next may move into the hole only if its home does not lie cyclically in (hole, next]
+		if( ((next - home) & mask) >= ((next - hole) & mask) ) {
+			address_map->keys  [ hole ] = address_map->keys  [ next ];
+			address_map->values[ hole ] = address_map->values[ next ];
+			hole = next;
+		}
 	}
+	address_map->values[ hole ] = SIZE_MAX;
 
 	//update size
 	--(address_map->size);
@@ -894,21 +1076,17 @@ void mcbsp_util_address_map_remove( struct mcbsp_util_address_map * const addres
 }
 
 size_t mcbsp_util_address_map_get( const struct mcbsp_util_address_map * const address_map, const void * const key ) {
-	//check if we are in range
-	if( address_map->size == 0 ) {
-		return SIZE_MAX;
+	//probe until the key or an empty slot is found
+	size_t slot = mcbsp_util_address_map_hash( address_map, key );
+	while( address_map->values[ slot ] != SIZE_MAX ) {
+		if( address_map->keys[ slot ] == key ) {
+			return address_map->values[ slot ];
+		}
+		slot = (slot + 1) & (address_map->cap - 1);
 	}
 
-	//do binary search
-	size_t found = mcbsp_util_address_map_binsearch( address_map, key, 0, address_map->size - 1 );
-
-	//return if key is found
-	if( address_map->keys[ found ] == key ) {
-		return address_map->values[ found ];
-	} else {
-		//otherwise return max
-		return SIZE_MAX;
-	}
+	//key not found, return max
+	return SIZE_MAX;
 }
 
 void mcbsp_util_check_machine_info( struct mcbsp_util_machine_info * const machine ) {
@@ -1209,6 +1387,58 @@ void mcbsp_util_memcpy( void * const restrict destination, const void * const re
 #endif
 }
 
+//copies count blocks between two strided areas. Blocks of a common word size
+//are copied with fixed-size moves so that the compiler can unroll and vectorise
+//the loop; other block sizes are dispatched block-by-block to mcbsp_util_memcpy
+void mcbsp_util_memcpy_strided( void * const restrict destination, const size_t destination_stride,
+	const void * const restrict source, const size_t source_stride,
+	const size_t block, const size_t count
+) {
+	char * const restrict dest = destination;
+	const char * const restrict src = source;
+	switch( block ) {
+		case sizeof(double):
+			for( size_t i = 0; i < count; ++i ) {
+				memcpy( dest + i * destination_stride, src + i * source_stride, sizeof(double) );
+			}
+			break;
+		case sizeof(float):
+			for( size_t i = 0; i < count; ++i ) {
+				memcpy( dest + i * destination_stride, src + i * source_stride, sizeof(float) );
+			}
+			break;
+		default:
+			for( size_t i = 0; i < count; ++i ) {
+				mcbsp_util_memcpy( dest + i * destination_stride, src + i * source_stride, block );
+			}
+	}
+}
+
+//scatters count contiguous blocks to the given destination offsets, with the
+//same fixed-size specialisations as mcbsp_util_memcpy_strided
+void mcbsp_util_memcpy_indexed( void * const restrict destination, const size_t * const offsets,
+	const void * const restrict source, const size_t block, const size_t count
+) {
+	char * const restrict dest = destination;
+	const char * const restrict src = source;
+	switch( block ) {
+		case sizeof(double):
+			for( size_t i = 0; i < count; ++i ) {
+				memcpy( dest + offsets[ i ], src + i * sizeof(double), sizeof(double) );
+			}
+			break;
+		case sizeof(float):
+			for( size_t i = 0; i < count; ++i ) {
+				memcpy( dest + offsets[ i ], src + i * sizeof(float), sizeof(float) );
+			}
+			break;
+		default:
+			for( size_t i = 0; i < count; ++i ) {
+				mcbsp_util_memcpy( dest + offsets[ i ], src + i * block, block );
+			}
+	}
+}
+
 void * mcbsp_util_malloc( const size_t size, const char * const name ) {
 	//allocate return pointer
 	void * ret;
@@ -1242,3 +1472,300 @@ void * mcbsp_util_malloc( const size_t size, const char * const name ) {
 	return ret;
 }
 
+size_t mcbsp_util_numa_node( void ) {
+#ifdef MCBSP_NUMA
+	unsigned int cpu, node;
+	if( syscall( SYS_getcpu, &cpu, &node, NULL ) == 0 ) {
+		return (size_t)node;
+	}
+#endif
+	return 0;
+}
+
+#ifdef MCBSP_NUMA
+/** Memory policy of mbind that prefers a single node, as in numaif.h. */
+ #define MCBSP_MPOL_PREFERRED 1
+/** Flag of mbind that migrates pages in use, as in numaif.h. */
+ #define MCBSP_MPOL_MF_MOVE (1 << 1)
+#endif
+
+void mcbsp_util_numa_bind( void * const pointer, const size_t size, const size_t node ) {
+#ifdef MCBSP_NUMA
+	//round inwards to whole pages, so that neighbouring memory is unaffected
+	const uintptr_t page  = (uintptr_t)sysconf( _SC_PAGESIZE );
+	const uintptr_t start = ((uintptr_t)pointer + page - 1) / page * page;
+	const uintptr_t end   = ((uintptr_t)pointer + size) / page * page;
+	if( start >= end ) {
+		return;
+	}
+	//build a node mask with only the given node set
+	const size_t bits = CHAR_BIT * sizeof( unsigned long int );
+	unsigned long int mask[ node / bits + 1 ];
+	memset( mask, 0, sizeof( mask ) );
+	mask[ node / bits ] = 1UL << (node % bits);
+	//errors, such as lacking permission to migrate pages, leave the memory in place
+	(void)syscall( SYS_mbind, (void *)start, (unsigned long int)(end - start), MCBSP_MPOL_PREFERRED,
+		mask, (unsigned long int)(CHAR_BIT * sizeof( mask ) + 1), MCBSP_MPOL_MF_MOVE );
+#else
+	(void)pointer;
+	(void)size;
+	(void)node;
+#endif
+}
+
+/**
+ * Reads a single non-negative integer from a file.
+ *
+ * @return Whether the file existed and started with an integer.
+ */
+static bool mcbsp_util_read_integer( const char * const path, size_t * const value ) {
+	FILE * const fp = fopen( path, "r" );
+	if( fp == NULL ) {
+		return false;
+	}
+	unsigned long int read = 0;
+	const bool ret = fscanf( fp, "%lu", &read ) == 1;
+	fclose( fp );
+	*value = (size_t)read;
+	return ret;
+}
+
+/** Orders hardware threads by their OS number. */
+static int mcbsp_util_hw_thread_compare( const void * a, const void * b ) {
+	const size_t x = ((const struct mcbsp_util_hw_thread *)a)->id;
+	const size_t y = ((const struct mcbsp_util_hw_thread *)b)->id;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+struct mcbsp_util_hw_thread * mcbsp_util_read_topology( const char * const root, size_t * const size ) {
+	*size = 0;
+#ifdef __linux__
+	char path[ 4096 ];
+	snprintf( path, 4096, "%s/cpu", root );
+	DIR * const cpus = opendir( path );
+	if( cpus == NULL ) {
+		return NULL;
+	}
+	struct mcbsp_util_stack threads;
+	mcbsp_util_stack_initialise( &threads, sizeof( struct mcbsp_util_hw_thread ) );
+	const struct dirent * entry;
+	while( (entry = readdir( cpus )) != NULL ) {
+		//only consider cpuN directories
+		unsigned long int id;
+		char trailing;
+		if( sscanf( entry->d_name, "cpu%lu%c", &id, &trailing ) != 1 ) {
+			continue;
+		}
+		//offline hardware threads have no topology directory
+		struct mcbsp_util_hw_thread thread;
+		size_t core_id;
+		thread.id = (size_t)id;
+		snprintf( path, 4096, "%s/cpu/cpu%lu/topology/physical_package_id", root, id );
+		if( !mcbsp_util_read_integer( path, &(thread.package) ) ) {
+			continue;
+		}
+		snprintf( path, 4096, "%s/cpu/cpu%lu/topology/core_id", root, id );
+		if( !mcbsp_util_read_integer( path, &core_id ) ) {
+			continue;
+		}
+		//core and smt are made dense below; until then, core holds the package-local core ID
+		thread.core    = core_id;
+		thread.core_id = core_id;
+		thread.smt  = 0;
+		//the L3 domain is named after its first hardware thread; without an L3, the package is used
+		thread.l3 = SIZE_MAX;
+		for( unsigned int index = 0; ; ++index ) {
+			size_t level;
+			snprintf( path, 4096, "%s/cpu/cpu%lu/cache/index%u/level", root, id, index );
+			if( !mcbsp_util_read_integer( path, &level ) ) {
+				break;
+			}
+			if( level == 3 ) {
+				snprintf( path, 4096, "%s/cpu/cpu%lu/cache/index%u/shared_cpu_list", root, id, index );
+				if( !mcbsp_util_read_integer( path, &(thread.l3) ) ) {
+					thread.l3 = SIZE_MAX;
+				}
+				break;
+			}
+		}
+		//the NUMA node appears as a nodeK entry in the cpuN directory
+		thread.node = 0;
+		snprintf( path, 4096, "%s/cpu/cpu%lu", root, id );
+		DIR * const cpu = opendir( path );
+		if( cpu != NULL ) {
+			const struct dirent * node_entry;
+			while( (node_entry = readdir( cpu )) != NULL ) {
+				unsigned long int node;
+				if( sscanf( node_entry->d_name, "node%lu%c", &node, &trailing ) == 1 ) {
+					thread.node = (size_t)node;
+					break;
+				}
+			}
+			closedir( cpu );
+		}
+		mcbsp_util_stack_push( &threads, &thread );
+	}
+	closedir( cpus );
+	if( mcbsp_util_stack_empty( &threads ) ) {
+		mcbsp_util_stack_destroy( &threads );
+		return NULL;
+	}
+
+	//number physical cores and SMT siblings in OS order; a core is identified by
+	//its package and its package-local core ID, which the core field holds so far
+	struct mcbsp_util_hw_thread * const ret = (struct mcbsp_util_hw_thread *)(threads.array);
+	const size_t n = threads.top;
+	qsort( ret, n, sizeof( struct mcbsp_util_hw_thread ), mcbsp_util_hw_thread_compare );
+	size_t cores = 0;
+	for( size_t i = 0; i < n; ++i ) {
+		//find the first sibling on the same core
+		size_t j = 0;
+		while( j < i && (ret[ j ].package != ret[ i ].package || ret[ j ].core_id != ret[ i ].core_id) ) {
+			++j;
+		}
+		if( j == i ) {
+			ret[ i ].core = cores++;
+			continue;
+		}
+		ret[ i ].core = ret[ j ].core;
+		for( size_t k = j; k < i; ++k ) {
+			if( ret[ k ].package == ret[ i ].package && ret[ k ].core_id == ret[ i ].core_id ) {
+				++(ret[ i ].smt);
+			}
+		}
+	}
+	for( size_t i = 0; i < n; ++i ) {
+		if( ret[ i ].l3 == SIZE_MAX ) {
+			ret[ i ].l3 = ret[ i ].package;
+		}
+	}
+	*size = n;
+	return ret;
+#else
+	(void)root;
+	return NULL;
+#endif
+}
+
+/** A hardware thread together with its sort key under a topology-based affinity strategy. */
+struct mcbsp_util_topology_key {
+
+	/** Keys in order of significance; the last one is the OS number, which makes keys unique. */
+	size_t key[ 4 ];
+
+};
+
+/** Orders topology keys lexicographically. */
+static int mcbsp_util_topology_key_compare( const void * a, const void * b ) {
+	const size_t * const x = ((const struct mcbsp_util_topology_key *)a)->key;
+	const size_t * const y = ((const struct mcbsp_util_topology_key *)b)->key;
+	for( size_t i = 0; i < 4; ++i ) {
+		if( x[ i ] != y[ i ] ) {
+			return x[ i ] < y[ i ] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+size_t * mcbsp_util_topology_pinning( const struct mcbsp_util_machine_info * const machine, const size_t P ) {
+	const struct mcbsp_util_hw_thread * const topology = machine->topology;
+	const size_t n = machine->topology_size;
+
+	//count the SMT siblings on each core
+	size_t cores = 0;
+	for( size_t i = 0; i < n; ++i ) {
+		if( topology[ i ].core >= cores ) {
+			cores = topology[ i ].core + 1;
+		}
+	}
+	size_t * const siblings = mcbsp_util_malloc( cores * sizeof( size_t ), "mcbsp_util_topology_pinning sibling counts" );
+	for( size_t i = 0; i < cores; ++i ) {
+		siblings[ i ] = 0;
+	}
+	for( size_t i = 0; i < n; ++i ) {
+		++(siblings[ topology[ i ].core ]);
+	}
+
+	//select the usable hardware threads and derive their sort keys
+	struct mcbsp_util_topology_key * const keys = mcbsp_util_malloc( n * sizeof( struct mcbsp_util_topology_key ), "mcbsp_util_topology_pinning sort keys" );
+	size_t m = 0;
+	for( size_t i = 0; i < n; ++i ) {
+		const struct mcbsp_util_hw_thread * const thread = &(topology[ i ]);
+		if( thread->smt + machine->unused_threads_per_core >= siblings[ thread->core ] && thread->smt > 0 ) {
+			continue;
+		}
+		if( machine->num_reserved_cores > 0 &&
+			mcbsp_util_contains( machine->reserved_cores, thread->core, 0, machine->num_reserved_cores ) ) {
+			continue;
+		}
+		size_t * const key = keys[ m++ ].key;
+		switch( machine->affinity ) {
+			case NUMA_BALANCED:
+				key[ 0 ] = thread->node;
+				key[ 1 ] = thread->smt;
+				key[ 2 ] = thread->l3;
+				break;
+			case L3_COMPACT:
+				key[ 0 ] = thread->l3;
+				key[ 1 ] = thread->smt;
+				key[ 2 ] = thread->core;
+				break;
+			default:
+				assert( machine->affinity == ONE_PER_PHYSICAL_CORE );
+				key[ 0 ] = thread->smt;
+				key[ 1 ] = thread->core;
+				key[ 2 ] = 0;
+				break;
+		}
+		key[ 3 ] = thread->id;
+	}
+	free( siblings );
+	if( m == 0 ) {
+		fprintf( stderr, "Error: all hardware threads are reserved or unused!\n" );
+		mcbsp_util_fatal();
+	}
+	if( P > m ) {
+		fprintf( stderr, "Warning: %lu threads requested but only %lu available; some hardware threads will run more than one thread.\n", (unsigned long int)P, (unsigned long int)m );
+	}
+	qsort( keys, m, sizeof( struct mcbsp_util_topology_key ), mcbsp_util_topology_key_compare );
+
+	//for the NUMA-balanced strategy, deal the sorted hardware threads out over the nodes
+	size_t * const order = mcbsp_util_malloc( m * sizeof( size_t ), "mcbsp_util_topology_pinning order" );
+	if( machine->affinity == NUMA_BALANCED ) {
+		//the nodes are contiguous ranges in the sorted keys; next[ g ] walks through node g
+		size_t * const next = mcbsp_util_malloc( (m + 1) * sizeof( size_t ), "mcbsp_util_topology_pinning node ranges" );
+		size_t nodes = 0;
+		for( size_t i = 0; i < m; ++i ) {
+			if( i == 0 || keys[ i ].key[ 0 ] != keys[ i - 1 ].key[ 0 ] ) {
+				next[ nodes++ ] = i;
+			}
+		}
+		next[ nodes ] = m;
+		size_t * const ends = mcbsp_util_malloc( nodes * sizeof( size_t ), "mcbsp_util_topology_pinning node ends" );
+		for( size_t g = 0; g < nodes; ++g ) {
+			ends[ g ] = next[ g + 1 ];
+		}
+		for( size_t i = 0; i < m; ) {
+			for( size_t g = 0; g < nodes; ++g ) {
+				if( next[ g ] < ends[ g ] ) {
+					order[ i++ ] = keys[ next[ g ]++ ].key[ 3 ];
+				}
+			}
+		}
+		free( ends );
+		free( next );
+	} else {
+		for( size_t i = 0; i < m; ++i ) {
+			order[ i ] = keys[ i ].key[ 3 ];
+		}
+	}
+	free( keys );
+
+	//take the first P hardware threads in order, wrapping around if there are too few
+	size_t * const ret = mcbsp_util_malloc( P * sizeof( size_t ), "mcbsp_util_topology_pinning return array" );
+	for( size_t s = 0; s < P; ++s ) {
+		ret[ s ] = order[ s % m ];
+	}
+	free( order );
+	return ret;
+}
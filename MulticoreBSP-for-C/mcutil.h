@@ -46,6 +46,14 @@
  #include <windows.h>
 #endif
 
+#ifdef MCBSP_NUMA
+ #include <sys/syscall.h>
+#endif
+
+#ifdef __linux__
+ #include <dirent.h>
+#endif
+
 
 /**
  * Structure representing a part of the current machine.
@@ -63,6 +71,34 @@ struct mcbsp_util_machine_partition {
 
 };
 
+/**
+ * Describes where a hardware thread lives in the machine topology.
+ */
+struct mcbsp_util_hw_thread {
+
+	/** The OS number of this hardware thread. */
+	size_t id;
+
+	/** The physical core, numbered by first appearance in OS order. */
+	size_t core;
+
+	/** The OS core ID of the physical core, which is local to its package. */
+	size_t core_id;
+
+	/** The rank of this hardware thread amongst the SMT siblings on its core. */
+	size_t smt;
+
+	/** The package (socket). */
+	size_t package;
+
+	/** The L3 domain; the lowest OS number of the hardware threads sharing its L3 cache. */
+	size_t l3;
+
+	/** The NUMA node. */
+	size_t node;
+
+};
+
 /**
  * Structure representing the machine hardware information.
  */
@@ -98,6 +134,12 @@ struct mcbsp_util_machine_info {
 	/** Whether the safe_checkpoint_frequency field has been overridden. */
 	bool SCFset;
 
+	/** Whether the barrier field has been overridden. */
+	bool Bset;
+
+	/** Whether the spin_window field has been overridden. */
+	bool SWset;
+
 	/** The total number of threads available for computation. */
 	size_t threads;
 
@@ -123,6 +165,15 @@ struct mcbsp_util_machine_info {
 	/** Currently active thread-numbering method. */
 	enum mcbsp_thread_numbering thread_numbering;
 
+	/** Currently active barrier algorithm. */
+	enum mcbsp_barrier_mode barrier;
+
+	/**
+	 * The maximum time (in microseconds) a process spins at a barrier
+	 * before it blocks.
+	 */
+	size_t spin_window;
+
 	/**
 	 * Pointer to the manually-defined affinity definition.
 	 *
@@ -172,12 +223,26 @@ struct mcbsp_util_machine_info {
 	 * imminent hardware failure, such as a back-up power supply failing.
 	 */
 	size_t safe_cp_f;
+
+	/**
+	 * The machine topology used by the topology-based affinity strategies,
+	 * or NULL if it was not read (yet).
+	 */
+	struct mcbsp_util_hw_thread * topology;
+
+	/** Number of entries in the topology array. */
+	size_t topology_size;
 };
 
-/** A map from pointers to unsigned long ints. */
+/**
+ * A map from pointers to unsigned long ints.
+ *
+ * This is an open-addressing hash map with linear probing.
+ * A slot is empty when its value equals SIZE_MAX.
+ */
 struct mcbsp_util_address_map {
 
-	/** Capacity. */
+	/** Capacity; always a power of two. */
 	size_t cap;
 
 	/** Size. */
@@ -219,6 +284,46 @@ struct mcbsp_util_stack {
 
 };
 
+/** A chunk of memory of an mcbsp_util_arena. */
+struct mcbsp_util_arena_chunk {
+
+	/** The preceding chunk, or NULL if this is the first chunk. */
+	struct mcbsp_util_arena_chunk * prev;
+
+	/** The next chunk, or NULL if this is the last chunk. */
+	struct mcbsp_util_arena_chunk * next;
+
+	/** Capacity of this chunk, in bytes. */
+	size_t cap;
+
+	/** Number of bytes in use. */
+	size_t top;
+
+};
+
+/**
+ * A stack of variably-sized items that is made up of chunks. Items
+ * never straddle chunks, and pushing an item that does not fit the
+ * current chunk moves on to the next chunk instead of moving the
+ * items already on the stack. Chunks are kept once the stack is
+ * emptied, so that the arena retains its high-water size.
+ */
+struct mcbsp_util_arena {
+
+	/** The first chunk, or NULL if nothing was ever pushed. */
+	struct mcbsp_util_arena_chunk * first;
+
+	/** The chunk holding the top item, or the first chunk when empty. */
+	struct mcbsp_util_arena_chunk * current;
+
+	/** Total capacity of all chunks, in bytes. */
+	size_t cap;
+
+	/** Size of a regular (fixed-size) item, in bytes. */
+	size_t size;
+
+};
+
 /** A table of local address locations per SPMD variable. */
 struct mcbsp_util_address_table {
 	
@@ -260,7 +365,18 @@ struct mcbsp_util_pinning_info {
 void mcbsp_util_stack_initialise( struct mcbsp_util_stack * const stack, const size_t elementSize );
 
 /**
- * Doubles the capacity of a given stack.
+ * Initialises the mcbsp_util_stack struct without allocating any
+ * memory; the stack array is allocated on the first push. Useful
+ * for the many stacks that may never be used.
+ *
+ * @param stack 	The stack to initialise.
+ * @param elementSize 	The size of a single element in the stack.
+ */
+void mcbsp_util_stack_initialise_lazy( struct mcbsp_util_stack * const stack, const size_t elementSize );
+
+/**
+ * Doubles the capacity of a given stack. A stack without capacity
+ * grows to the default initial capacity.
  *
  * @param stack the stack whose capacity to double.
  */
@@ -380,6 +496,17 @@ inline void * mcbsp_util_varstack_regpeek( const struct mcbsp_util_stack * const
  */
 void mcbsp_util_varstack_push( struct mcbsp_util_stack * const stack, const void * const item, const size_t size );
 
+/**
+ * Reserves a variably-sized item on top of the stack without initialising it.
+ * The caller fills the returned area, which stays valid until the next push.
+ *
+ * @param stack The variable stack to reserve space on.
+ * @param size Size (in bytes) of the area to reserve.
+ *
+ * @return A pointer to the reserved area.
+ */
+void * mcbsp_util_varstack_reserve( struct mcbsp_util_stack * const stack, const size_t size );
+
 /**
  * Pushes a fixed-size item on the stack.
  * (The fixed size was set at varstack initialisation.)
@@ -394,6 +521,90 @@ inline void mcbsp_util_varstack_regpush( struct mcbsp_util_stack * const stack,
 	mcbsp_util_varstack_push( stack, item, stack->size );
 }
 
+/**
+ * Initialises an arena. Does not allocate memory; the first chunk is
+ * allocated on the first push.
+ *
+ * @param arena The arena to initialise.
+ * @param size  The size of a regular (fixed-size) item.
+ */
+void mcbsp_util_arena_initialise( struct mcbsp_util_arena * const arena, const size_t size );
+
+/**
+ * @param arena The arena to check.
+ * @return Whether the arena holds no items.
+ */
+inline bool mcbsp_util_arena_empty( const struct mcbsp_util_arena * const arena ) {
+	return arena->current == NULL || arena->current->top == 0;
+}
+
+/**
+ * Reserves a variably-sized item on top of the arena without initialising it.
+ * The returned area stays valid until the item is popped.
+ *
+ * @param arena The arena to reserve space on.
+ * @param size  Size (in bytes) of the area to reserve.
+ *
+ * @return A pointer to the reserved area.
+ */
+void * mcbsp_util_arena_reserve( struct mcbsp_util_arena * const arena, const size_t size );
+
+/**
+ * Pushes a variably-sized item on the arena.
+ *
+ * @param arena The arena to push onto.
+ * @param item  Pointer to the data to push.
+ * @param size  Size (in bytes) of the data to push.
+ */
+void mcbsp_util_arena_push( struct mcbsp_util_arena * const arena, const void * const item, const size_t size );
+
+/**
+ * Pushes a fixed-size item on the arena.
+ * (The fixed size was set at arena initialisation.)
+ *
+ * @param arena The arena to push onto.
+ * @param item  Pointer to the item to push.
+ */
+inline void mcbsp_util_arena_regpush( struct mcbsp_util_arena * const arena, const void * const item ) {
+	mcbsp_util_arena_push( arena, item, arena->size );
+}
+
+/**
+ * Removes the top item from the arena. The size must equal the size the
+ * item was pushed with. The item remains valid until the next push.
+ *
+ * @param arena The arena to pop from.
+ * @param size  Size (in bytes) of the top item.
+ *
+ * @return A pointer to the item just removed from the arena.
+ */
+void * mcbsp_util_arena_pop( struct mcbsp_util_arena * const arena, const size_t size );
+
+/**
+ * Removes the top fixed-size item from the arena.
+ * (The fixed size was set at arena initialisation.)
+ *
+ * @param arena The arena to pop from.
+ * @return A pointer to the item just removed from the arena.
+ */
+inline void * mcbsp_util_arena_regpop( struct mcbsp_util_arena * const arena ) {
+	return mcbsp_util_arena_pop( arena, arena->size );
+}
+
+/**
+ * Removes all items from the arena, retaining all of its chunks.
+ *
+ * @param arena The arena to empty.
+ */
+void mcbsp_util_arena_reset( struct mcbsp_util_arena * const arena );
+
+/**
+ * Frees all chunks of an arena.
+ *
+ * @param arena The arena to destroy.
+ */
+void mcbsp_util_arena_destroy( struct mcbsp_util_arena * const arena );
+
 /**
  * Initialises the mcbsp_util_address_table struct.
  * This function is not thread-safe.
@@ -482,6 +693,13 @@ void mcbsp_util_address_map_grow( struct mcbsp_util_address_map * const address_
  */
 void mcbsp_util_address_map_destroy( struct mcbsp_util_address_map * const address_map );
 
+/**
+ * Removes all entries from a given address map, retaining its capacity.
+ *
+ * @param address_map Pointer to the map to clear.
+ */
+void mcbsp_util_address_map_clear( struct mcbsp_util_address_map * const address_map );
+
 /**
  * Address map accessor.
  *
@@ -510,19 +728,15 @@ void mcbsp_util_address_map_insert( struct mcbsp_util_address_map * const addres
 void mcbsp_util_address_map_remove( struct mcbsp_util_address_map * const address_map, void * const key );
 
 /**
- * Helper-function for
- *   mcbsp_util_address_map_insert, and
- *   mcbsp_util_address_map_remove.
- * Performs a binary search for key and returns the largest
- * index for which the map key is less or equal to the 
- * supplied key value.
+ * Helper-function for the address map accessors.
+ * Computes the slot at which probing for a given
+ * key starts.
  *
  * @param address_map Pointer to the map to look in.
  * @param key         The key value to look for.
- * @param lo          Lower bound on range of the map to look for.
- * @param hi          upper bound (inclusive) on range of the map to look for.
+ * @return            The home slot of key.
  */
-size_t mcbsp_util_address_map_binsearch( const struct mcbsp_util_address_map * const address_map, const void * const key, size_t lo, size_t hi );
+size_t mcbsp_util_address_map_hash( const struct mcbsp_util_address_map * const address_map, const void * const key );
 
 /**
  * Attempts to detect the number of hard-ware
@@ -698,6 +912,40 @@ size_t mcbsp_util_array_sizet_lbound( const size_t * const array, const size_t k
   void mcbsp_util_memcpy( void * const restrict dest, const void * const restrict src, const size_t size );
 #endif
 
+/**
+ * Copies count blocks of block bytes each. The i-th block is read from
+ * src + i * src_stride and written to dest + i * dest_stride. Blocks must
+ * not overlap with each other nor between source and destination.
+ *
+ * @param dest        Destination pointer.
+ * @param dest_stride Distance between successive destination blocks (in bytes).
+ * @param src         Source pointer.
+ * @param src_stride  Distance between successive source blocks (in bytes).
+ * @param block       Size of a single block (in bytes).
+ * @param count       Number of blocks to copy.
+ */
+#ifdef MCBSP_CPLUSPLUS
+  void mcbsp_util_memcpy_strided( void * const __restrict__ dest, const size_t dest_stride, const void * const __restrict__ src, const size_t src_stride, const size_t block, const size_t count );
+#else
+  void mcbsp_util_memcpy_strided( void * const restrict dest, const size_t dest_stride, const void * const restrict src, const size_t src_stride, const size_t block, const size_t count );
+#endif
+
+/**
+ * Scatters count contiguous blocks of block bytes each. The i-th block is
+ * read from src + i * block and written to dest + offsets[ i ].
+ *
+ * @param dest    Destination pointer.
+ * @param offsets Byte offsets of the destination blocks, relative to dest.
+ * @param src     Source pointer.
+ * @param block   Size of a single block (in bytes).
+ * @param count   Number of blocks to copy.
+ */
+#ifdef MCBSP_CPLUSPLUS
+  void mcbsp_util_memcpy_indexed( void * const __restrict__ dest, const size_t * const offsets, const void * const __restrict__ src, const size_t block, const size_t count );
+#else
+  void mcbsp_util_memcpy_indexed( void * const restrict dest, const size_t * const offsets, const void * const restrict src, const size_t block, const size_t count );
+#endif
+
 /**
  * Memory allocation function used for internal MulticoreBSP for C memory
  * areas.
@@ -714,5 +962,54 @@ size_t mcbsp_util_array_sizet_lbound( const size_t * const array, const size_t k
  */
 void * mcbsp_util_malloc( const size_t size, const char * const name );
 
+/**
+ * Reads the machine topology from sysfs.
+ *
+ * @param root Directory holding the cpu and node directories; normally
+ *             MCBSP_SYSFS_ROOT.
+ * @param size Where to store the number of hardware threads found.
+ * @return     An array of the online hardware threads sorted by their
+ *             OS number, or NULL if the topology could not be read. The
+ *             caller must free the array.
+ */
+struct mcbsp_util_hw_thread * mcbsp_util_read_topology( const char * const root, size_t * const size );
+
+/**
+ * Derives a pinning from the machine topology, for one of the
+ * topology-based affinity strategies.
+ *
+ * Hardware threads on reserved cores are skipped, as are the last
+ * unused_threads_per_core SMT siblings on every core. Reserved cores
+ * are given by their machine-wide index, counting the physical cores
+ * in the order their first hardware threads appear. Should P exceed
+ * the number of remaining hardware threads, a warning is printed and
+ * the pinning wraps around.
+ *
+ * @param machine The machine info holding the topology.
+ * @param P       The number of threads to pin.
+ * @return        The pinning, an array of length P the caller must free.
+ */
+size_t * mcbsp_util_topology_pinning( const struct mcbsp_util_machine_info * const machine, const size_t P );
+
+/**
+ * @return The NUMA node of the hardware thread the caller runs on, or 0
+ *         if this cannot be determined.
+ */
+size_t mcbsp_util_numa_node( void );
+
+/**
+ * Binds a memory area to a NUMA node: pages already in use are migrated
+ * to the node, while pages touched later are allocated there.
+ *
+ * Only pages that lie entirely within the memory area are affected.
+ * This is a hint only; should the operating system refuse, the memory
+ * stays where it is.
+ *
+ * @param pointer Start of the memory area.
+ * @param size    Size of the memory area (in bytes).
+ * @param node    The NUMA node to bind to.
+ */
+void mcbsp_util_numa_bind( void * const pointer, const size_t size, const size_t node );
+
 #endif
 
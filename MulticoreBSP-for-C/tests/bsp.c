@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <time.h>
 
 static size_t checkPcount[ 3 ];
 static size_t *checkLocalIntAddress[ 3 ];
@@ -39,18 +40,36 @@ static bool superstepOK = true;
 
 static pthread_mutex_t test_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-size_t predictCap( const size_t );
+#ifdef MCBSP_THREAD_POOL
+static pthread_t pooled[ 2 ][ 3 ];
+static unsigned char run = 0;
+
+static unsigned int hits[ 1000 ];
+#endif
+
 void spmd( void );
+bsp_size_t parity( const void * const tag, const bsp_pid_t source );
+void count_hits( const bsp_size_t begin, const bsp_size_t end, void * const arg );
+void rerun( void );
+void imbalanced( void );
+void sparse( void );
+
+bsp_size_t parity( const void * const tag, const bsp_pid_t source ) {
+	(void)source;
+	return (bsp_size_t)(*(const size_t*)tag % 2);
+}
 
-size_t predictCap( const size_t minSize ) {
-	size_t ret = 16;
-	if( ret < minSize ) {
-		ret *= 2;
-	}
-	if( ret < minSize ) {
-		ret = minSize;
+void count_hits( const bsp_size_t begin, const bsp_size_t end, void * const arg ) {
+	size_t * const executed = (size_t*)arg;
+	for( bsp_size_t i = begin; i < end; ++i ) {
+		//make later iterations more expensive so that stealing is likely
+		volatile size_t spin = 0;
+		for( bsp_size_t k = 0; k < i; ++k ) {
+			++spin;
+		}
+		__atomic_fetch_add( &(hits[ i ]), 1, __ATOMIC_RELAXED );
+		++*executed;
 	}
-	return ret;
 }
 
 void spmd( void ) {
@@ -131,19 +150,20 @@ void spmd( void ) {
 	commTest[ 2 ] = ULONG_MAX; //this should not influence the result after sync.
 
 	//test behind-the-scenes
-	const struct mcbsp_util_stack queue = data->queues[ (bsp_pid() + 1) % bsp_nprocs() ];
-	size_t predicted_cap = predictCap( sizeof( struct mcbsp_message ) + 2 * sizeof( size_t) );
-	if( queue.cap != predicted_cap || queue.top != sizeof( struct mcbsp_message ) + 2 * sizeof( size_t) || queue.size != sizeof( struct mcbsp_message ) ) {
+	const struct mcbsp_util_arena queue = data->outboxes[ (data->superstep % 2) * bsp_nprocs() + (bsp_pid() + 1) % bsp_nprocs() ]->queue;
+	const size_t arena_cap = 16 * sizeof( struct mcbsp_message );
+	if( queue.cap != arena_cap || queue.current == NULL || queue.current->top != sizeof( struct mcbsp_message ) + 2 * sizeof( size_t) || queue.size != sizeof( struct mcbsp_message ) ) {
 		fprintf( stderr, "FAILURE \t bsp_put did not adapt the communication queue as expected!\n(cap = %ld != %zd, top = %ld != %zd, size = %ld != %zd )\n",
-			(size_t)queue.cap, predicted_cap, (size_t)queue.top, sizeof( struct mcbsp_message ) + 2 * sizeof( size_t), (size_t)queue.size, sizeof(struct mcbsp_message) );
+			(size_t)queue.cap, arena_cap, queue.current == NULL ? 0 : (size_t)queue.current->top, sizeof( struct mcbsp_message ) + 2 * sizeof( size_t), (size_t)queue.size, sizeof(struct mcbsp_message) );
 		mcbsp_util_fatal();
 	}
-	const struct mcbsp_message request = *((struct mcbsp_message*) ((char*)queue.array + queue.top - sizeof( struct mcbsp_message )) );
+	const char * const chunk = (const char *)(queue.current + 1);
+	const struct mcbsp_message request = *((struct mcbsp_message*) (chunk + queue.current->top - sizeof( struct mcbsp_message )) );
 	if( request.length != 2 * sizeof( size_t) ) {
 		fprintf( stderr, "FAILURE \t bsp_put did not push a request of the expected length!\n(length = %ld)\n", (size_t)request.length );
 		mcbsp_util_fatal();
 	}
-	const size_t * const chk_array = (size_t*) ((char*)queue.array + queue.top - sizeof( struct mcbsp_message ) - 2 * sizeof( size_t ));
+	const size_t * const chk_array = (const size_t*) (chunk + queue.current->top - sizeof( struct mcbsp_message ) - 2 * sizeof( size_t ));
 	if( chk_array[ 0 ] != ((size_t)bsp_pid()) || chk_array[ 1 ] != ((size_t)bsp_pid()) ) {
 		fprintf( stderr, "FAILURE \t bsp_put did not push an expected communication request!\n" );
 		mcbsp_util_fatal();
@@ -204,39 +224,47 @@ void spmd( void ) {
 		mcbsp_util_fatal();
 	}
 
+#ifdef MCBSP_IMMEDIATE_HP
+	//hp requests complete before returning, without being queued
+	size_t immediate = SIZE_MAX;
+	bsp_hpget( (bsp_pid() + 1) % bsp_nprocs(), &commTest, sizeof( size_t ), &immediate, sizeof( size_t ) );
+	if( immediate != ((size_t)bsp_pid()) || !mcbsp_util_stack_empty( &(data->hpdrma_queue) ) ) {
+		fprintf( stderr, "FAILURE \t bsp_hpget did not complete immediately (got %zd)!\n", immediate );
+		mcbsp_util_fatal();
+	}
+#endif
+
 	//now test single BSMP message
 	bsp_send( (bsp_pid() + 1) % bsp_nprocs(), NULL, &commTest, sizeof( size_t ) );
 	
 	//check messages
-	const struct mcbsp_util_stack queue1 = data->queues[ (bsp_pid() + 1) % bsp_nprocs() ];
-	const size_t new_predicted_cap = predictCap( sizeof( struct mcbsp_message ) + sizeof( size_t ) );
-	predicted_cap = predicted_cap > new_predicted_cap ? predicted_cap : new_predicted_cap;
-	if( queue1.cap != predicted_cap || queue1.size != sizeof( struct mcbsp_message ) || queue1.top != sizeof( struct mcbsp_message ) + sizeof( size_t ) ) {
+	const struct mcbsp_util_arena queue1 = data->outboxes[ (data->superstep % 2) * bsp_nprocs() + (bsp_pid() + 1) % bsp_nprocs() ]->queue;
+	if( queue1.cap != arena_cap || queue1.size != sizeof( struct mcbsp_message ) || queue1.current == NULL || queue1.current->top != sizeof( struct mcbsp_message ) + sizeof( size_t ) ) {
 		fprintf( stderr, "FAILURE \t bsp_send did not adapt the communication queue as expected!\n(cap = %ld, size = %ld, top = %ld; prediction was %ld, %ld, %ld)\n",
-			(size_t)queue1.cap, (size_t)queue1.size, (size_t)queue1.top,
-			(size_t)predicted_cap, (size_t)(sizeof( struct mcbsp_message )), (size_t)(sizeof( struct mcbsp_message ) + sizeof( size_t )) );
+			(size_t)queue1.cap, (size_t)queue1.size, queue1.current == NULL ? 0 : (size_t)queue1.current->top,
+			(size_t)arena_cap, (size_t)(sizeof( struct mcbsp_message )), (size_t)(sizeof( struct mcbsp_message ) + sizeof( size_t )) );
 		mcbsp_util_fatal();
 	}
-	const struct mcbsp_message request2 = *(struct mcbsp_message*) ((char*)queue1.array + queue1.top - sizeof( struct mcbsp_message ));
+	const char * const chunk1 = (const char *)(queue1.current + 1);
+	const struct mcbsp_message request2 = *(struct mcbsp_message*) (chunk1 + queue1.current->top - sizeof( struct mcbsp_message ));
 	if( request2.destination != NULL ||
 		request2.length != sizeof( size_t ) || // assumes tagSize = 0
-		*(size_t *)queue1.array != ((size_t)bsp_pid()) ) {
+		*(const size_t *)chunk1 != ((size_t)bsp_pid()) ) {
 		fprintf( stderr, "FAILURE \t bsp_send did not push the expected communication request!\n(top = %ld, destination = %p, length = %ld, payload = %ld\n",
-			(size_t)queue1.top, request2.destination, (size_t)request2.length, *(size_t *)queue1.array );
+			(size_t)queue1.current->top, request2.destination, (size_t)request2.length, *(const size_t *)chunk1 );
 		mcbsp_util_fatal();
 	}
 
 	bsp_sync();
 
 	//inspect incoming BSMP queue (assuming tagSize = 0)
-	predicted_cap = predictCap( sizeof( size_t ) + sizeof( size_t ) );
-	if( data->bsmp.cap != predicted_cap || data->bsmp.top != sizeof( size_t ) + sizeof( size_t ) || data->bsmp.size != sizeof( size_t ) ) {
-		fprintf( stderr, "FAILURE \t BSMP queue after superstep with sends is not as expected!\n(cap = %ld, top = %ld, size = %ld; prediction was %ld, %ld, %ld)\n",
-			(size_t)data->bsmp.cap, (size_t)data->bsmp.top, (size_t)data->bsmp.size,
-			(size_t)predicted_cap, (size_t)(8 + sizeof( size_t )), (size_t)(data->bsmp.size) );
+	if( data->bsmp.top != 1 || data->bsmp.size != sizeof( struct bsp_message ) ) {
+		fprintf( stderr, "FAILURE \t BSMP queue after superstep with sends is not as expected!\n(top = %ld, size = %ld; prediction was 1, %ld)\n",
+			(size_t)data->bsmp.top, (size_t)data->bsmp.size, (size_t)sizeof( struct bsp_message ) );
 		mcbsp_util_fatal();
 	}
-	if( *(size_t*)(data->bsmp.array) != (size_t)((bsp_pid() + bsp_nprocs() - 1) % bsp_nprocs()) ) {
+	const struct bsp_message * const received = (const struct bsp_message *) data->bsmp.array;
+	if( received->size != sizeof( size_t ) || *(const size_t*)(received->payload) != (size_t)((bsp_pid() + bsp_nprocs() - 1) % bsp_nprocs()) ) {
 		fprintf( stderr, "FAILURE \t Value in BSMP queue is not correct!\n" );
 		mcbsp_util_fatal();
 	}
@@ -276,7 +304,8 @@ void spmd( void ) {
 	commTest[ 2 ] = 8 + ((size_t)bsp_pid());
 	for( unsigned char i = 0; i < bsp_nprocs(); ++i ) {
 		bsp_send( i, commTest, &(commTest[1]), 2 * sizeof( size_t ) );
-		char * const test = (char*)(data->queues[ (size_t)i ].array) + data->queues[ (size_t)i ].top - sizeof( struct mcbsp_message ) - sizeof( size_t );
+		const struct mcbsp_util_arena_chunk * const current = data->outboxes[ (data->superstep % 2) * bsp_nprocs() + (size_t)i ]->queue.current;
+		const char * const test = (const char*)(current + 1) + current->top - sizeof( struct mcbsp_message ) - sizeof( size_t );
 		if( *(size_t*)test != *commTest ) {
 			fprintf( stderr, "FAILURE \t BSMP tag did not get pushed correctly (reads %ld instead of %ld)!\n", *(size_t*)test, *commTest );
 			mcbsp_util_fatal();
@@ -285,6 +314,29 @@ void spmd( void ) {
 
 	bsp_sync();
 
+	//walk the messages in place; this should not consume them
+	for( unsigned int pass = 0; pass < 2; ++pass ) {
+		bsp_message_iterator_t it;
+		bsp_message_iterator( &it );
+		size_t seen = 0;
+		const struct bsp_message * message;
+		while( (message = bsp_next_message( &it )) != NULL ) {
+			const size_t * const payload = message->payload;
+			const size_t sender = *(const size_t*)(message->tag);
+			if( sender >= ((size_t)bsp_nprocs()) || message->size != 2 * sizeof( size_t ) ||
+				payload[ 0 ] != 3 || payload[ 1 ] != 8 + sender
+			) {
+				fprintf( stderr, "FAILURE \t bsp_next_message returned an incorrect message (tag=%ld, size=%ld)!\n", sender, (size_t)message->size );
+				mcbsp_util_fatal();
+			}
+			++seen;
+		}
+		if( seen != (size_t)bsp_nprocs() ) {
+			fprintf( stderr, "FAILURE \t bsp_next_message visited %ld messages instead of %ld!\n", seen, (size_t)bsp_nprocs() );
+			mcbsp_util_fatal();
+		}
+	}
+
 	bsp_size_t status;
 	size_t tag;
 	for( unsigned char i = 0; i < bsp_nprocs(); ++i ) {
@@ -312,6 +364,367 @@ void spmd( void ) {
 
 	bsp_sync();
 
+	//messages grouped by source arrive by increasing source and in the order sent
+	bsp_set_message_buckets( bsp_nprocs(), NULL );
+	for( size_t k = 0; k < 3; ++k ) {
+		const size_t msg[ 2 ] = { (size_t)bsp_pid(), k };
+		for( bsp_pid_t i = 0; i < bsp_nprocs(); ++i ) {
+			bsp_send( i, &(msg[ 0 ]), &(msg[ 1 ]), sizeof( size_t ) );
+		}
+	}
+	bsp_sync();
+	for( bsp_pid_t i = 0; i < bsp_nprocs(); ++i ) {
+		bsp_nprocs_t bucket_packets;
+		bsp_size_t bucket_size;
+		bsp_bucket_qsize( i, &bucket_packets, &bucket_size );
+		if( bucket_packets != 3 || bucket_size != 3 * sizeof( size_t ) ) {
+			fprintf( stderr, "FAILURE \t bsp_bucket_qsize returned %u messages of %zd bytes for bucket %u!\n", bucket_packets, (size_t)bucket_size, i );
+			mcbsp_util_fatal();
+		}
+	}
+	for( size_t j = 0; j < 3 * (size_t)bsp_nprocs(); ++j ) {
+		size_t *p_tag, *msg;
+		bsp_hpmove( (void**)&p_tag, (void**)&msg );
+		if( *p_tag != j / 3 || *msg != j % 3 ) {
+			fprintf( stderr, "FAILURE \t message %zd grouped by source was (%zd, %zd) instead of (%zd, %zd)!\n", j, *p_tag, *msg, j / 3, j % 3 );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_nprocs_t remaining;
+	bsp_bucket_qsize( 0, &remaining, NULL );
+	if( remaining != 0 ) {
+		fprintf( stderr, "FAILURE \t bsp_bucket_qsize counts moved messages!\n" );
+		mcbsp_util_fatal();
+	}
+
+	//messages bucketed by tag arrive by increasing bucket, then source
+	bsp_set_message_buckets( 2, &parity );
+	for( size_t k = 0; k < 4; ++k ) {
+		const size_t tag = k;
+		const size_t payload = (size_t)bsp_pid();
+		bsp_send( (bsp_pid() + 1) % bsp_nprocs(), &tag, &payload, sizeof( size_t ) );
+		bsp_send( (bsp_pid() + 2) % bsp_nprocs(), &tag, &payload, sizeof( size_t ) );
+	}
+	bsp_sync();
+	bsp_nprocs_t even, odd;
+	bsp_bucket_qsize( 0, &even, NULL );
+	bsp_bucket_qsize( 1, &odd, NULL );
+	if( even != 4 || odd != 4 ) {
+		fprintf( stderr, "FAILURE \t bsp_bucket_qsize returned buckets of %u and %u messages instead of 4 each!\n", even, odd );
+		mcbsp_util_fatal();
+	}
+	{
+		const size_t low  = (size_t)((bsp_pid() + 1) % bsp_nprocs());
+		const size_t high = (size_t)((bsp_pid() + 2) % bsp_nprocs());
+		const size_t first  = low < high ? low : high;
+		const size_t second = low < high ? high : low;
+		const size_t expect_tag[ 8 ]    = { 0, 2, 0, 2, 1, 3, 1, 3 };
+		const size_t expect_source[ 8 ] = { first, first, second, second, first, first, second, second };
+		bsp_message_iterator_t it;
+		bsp_message_iterator( &it );
+		for( size_t j = 0; j < 8; ++j ) {
+			const struct bsp_message * const message = bsp_next_message( &it );
+			if( message == NULL || *(const size_t*)(message->tag) != expect_tag[ j ] || *(const size_t*)(message->payload) != expect_source[ j ] ) {
+				fprintf( stderr, "FAILURE \t message %zd bucketed by tag is not as expected!\n", j );
+				mcbsp_util_fatal();
+			}
+		}
+	}
+	bsp_set_message_buckets( 0, NULL );
+	bsp_sync();
+
+	//atomics on the memory of process 0 complete within the superstep
+	int64_t shared[ 4 ] = { 0, 0, 1000, -1000 };
+	int64_t tickets[ 30 ];
+	bsp_push_reg( &shared, 4 * sizeof( int64_t ) );
+	bsp_push_reg( &tickets, 30 * sizeof( int64_t ) );
+	bsp_sync();
+	int64_t drawn[ 10 ];
+	for( size_t k = 0; k < 10; ++k ) {
+		drawn[ k ] = bsp_atomic_fetch_add( 0, &shared, 0, 1 );
+	}
+	bsp_put( 0, &drawn, &tickets, 10 * bsp_pid() * sizeof( int64_t ), 10 * sizeof( int64_t ) );
+	bsp_sync();
+	if( bsp_pid() == 0 ) {
+		//every ticket in 0, 1, ..., 29 was handed out exactly once
+		bool taken[ 30 ] = { false };
+		for( size_t k = 0; k < 30; ++k ) {
+			if( tickets[ k ] < 0 || tickets[ k ] >= 30 || taken[ tickets[ k ] ] ) {
+				fprintf( stderr, "FAILURE \t bsp_atomic_fetch_add handed out ticket %ld twice or out of range!\n", (long)tickets[ k ] );
+				mcbsp_util_fatal();
+			}
+			taken[ tickets[ k ] ] = true;
+		}
+		if( shared[ 0 ] != 30 ) {
+			fprintf( stderr, "FAILURE \t bsp_atomic_fetch_add left the counter at %ld instead of 30!\n", (long)shared[ 0 ] );
+			mcbsp_util_fatal();
+		}
+	}
+	if( bsp_atomic_cas( 0, &shared, sizeof( int64_t ), 0, (int64_t)bsp_pid() + 1 ) == 0 ) {
+		bsp_atomic_fetch_add( 0, &shared, 0, 1000 );
+	}
+	bsp_atomic_min( 0, &shared, 2 * sizeof( int64_t ), (int64_t)bsp_pid() );
+	bsp_atomic_max( 0, &shared, 3 * sizeof( int64_t ), (int64_t)bsp_pid() );
+	bsp_sync();
+	if( bsp_pid() == 0 && (
+		shared[ 0 ] != 10 * (int64_t)bsp_nprocs() + 1000 || shared[ 1 ] < 1 || shared[ 1 ] > (int64_t)bsp_nprocs() ||
+		shared[ 2 ] != 0 || shared[ 3 ] != (int64_t)bsp_nprocs() - 1
+	) ) {
+		fprintf( stderr, "FAILURE \t atomics resulted in (%ld, %ld, %ld, %ld)!\n", (long)shared[ 0 ], (long)shared[ 1 ], (long)shared[ 2 ], (long)shared[ 3 ] );
+		mcbsp_util_fatal();
+	}
+	bsp_pop_reg( &tickets );
+	bsp_pop_reg( &shared );
+	bsp_sync();
+
+	//bsp_parallel_for executes every iteration exactly once
+	if( bsp_pid() == 0 ) {
+		for( size_t i = 0; i < 1000; ++i ) {
+			hits[ i ] = 0;
+		}
+	}
+	bsp_sync();
+	size_t executed = 0;
+	bsp_parallel_for( 0, 1000, 7, &count_hits, &executed );
+	bsp_parallel_for( 500, 1000, 0, &count_hits, &executed );
+	bsp_parallel_for( 10, 10, 0, &count_hits, &executed );
+	for( size_t i = 0; i < 1000; ++i ) {
+		if( hits[ i ] != (i < 500 ? 1 : 2) ) {
+			fprintf( stderr, "FAILURE \t bsp_parallel_for executed iteration %zd %u times!\n", i, hits[ i ] );
+			mcbsp_util_fatal();
+		}
+	}
+	if( executed > 1500 ) {
+		fprintf( stderr, "FAILURE \t bsp_parallel_for executed %zd iterations at a single process!\n", executed );
+		mcbsp_util_fatal();
+	}
+
+	//consecutive supersteps with only buffered communication complete after a single barrier
+	for( size_t step = 0; step < 16; ++step ) {
+		const size_t value = 100 * step + (size_t)bsp_pid();
+		bsp_put( (bsp_pid() + 1) % bsp_nprocs(), &value, &commTest, 0, sizeof( size_t ) );
+		bsp_sync();
+		if( commTest[ 0 ] != 100 * step + (size_t)((bsp_pid() + bsp_nprocs() - 1) % bsp_nprocs()) ) {
+			fprintf( stderr, "FAILURE \t bsp_put over consecutive supersteps delivered %zd at superstep %zd!\n", commTest[ 0 ], step );
+			mcbsp_util_fatal();
+		}
+	}
+
+	//a get copying directly from the source must still see the value from before the puts
+	const size_t before = commTest[ 0 ];
+	const size_t overwrite = SIZE_MAX;
+	size_t fetched = 0;
+	bsp_get( bsp_pid(), &commTest, 0, &fetched, sizeof( size_t ) );
+	bsp_put( bsp_pid(), &overwrite, &commTest, 0, sizeof( size_t ) );
+	bsp_sync();
+	if( fetched != before || commTest[ 0 ] != SIZE_MAX ) {
+		fprintf( stderr, "FAILURE \t bsp_get combined with a bsp_put on the same source returned %zd instead of %zd!\n", fetched, before );
+		mcbsp_util_fatal();
+	}
+
+	//deferred puts copy the source as it is at sync time, which may then change right away
+	size_t deferred = 0;
+	for( size_t step = 0; step < 16; ++step ) {
+		deferred = 100 * step + (size_t)bsp_pid();
+		bsp_put_deferred( (bsp_pid() + 1) % bsp_nprocs(), &deferred, &commTest, sizeof( size_t ), sizeof( size_t ) );
+		bsp_sync();
+		deferred = SIZE_MAX;
+		if( commTest[ 1 ] != 100 * step + (size_t)((bsp_pid() + bsp_nprocs() - 1) % bsp_nprocs()) ) {
+			fprintf( stderr, "FAILURE \t bsp_put_deferred delivered %zd at superstep %zd!\n", commTest[ 1 ], step );
+			mcbsp_util_fatal();
+		}
+	}
+
+	//a ring shift whose deferred source is overwritten by a buffered put in the same superstep
+	size_t carousel[ 2 ] = { (size_t)bsp_pid(), SIZE_MAX };
+	bsp_push_reg( &carousel, 2 * sizeof( size_t ) );
+	bsp_sync();
+	for( size_t step = 1; step <= 16; ++step ) {
+		const bsp_pid_t next = (bsp_pid() + 1) % bsp_nprocs();
+		bsp_put_deferred( next, &(carousel[ 0 ]), &carousel, sizeof( size_t ), sizeof( size_t ) );
+		bsp_put( next, &(carousel[ 0 ]), &carousel, 0, sizeof( size_t ) );
+		bsp_sync();
+		const size_t expected = (size_t)((bsp_pid() + step * (bsp_nprocs() - 1)) % bsp_nprocs());
+		if( carousel[ 0 ] != expected || carousel[ 1 ] != expected ) {
+			fprintf( stderr, "FAILURE \t bsp_put_deferred read a source overwritten by a bsp_put (%d: %zd %zd, expected %zd)!\n",
+				bsp_pid(), carousel[ 0 ], carousel[ 1 ], expected );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_pop_reg( &carousel );
+	bsp_sync();
+
+	//communication through memory slots
+	size_t slotted[ 3 ] = { (size_t)bsp_pid(), 0, 0 };
+	bsp_memslot_t slot = SIZE_MAX;
+	bsp_push_reg_slot( &slotted, 3 * sizeof( size_t ), &slot );
+	bsp_sync();
+	if( slot == SIZE_MAX ) {
+		fprintf( stderr, "FAILURE \t bsp_push_reg_slot did not hand out a memory slot!\n" );
+		mcbsp_util_fatal();
+	}
+	const bsp_pid_t right = (bsp_pid() + 1) % bsp_nprocs();
+	const bsp_pid_t left  = (bsp_pid() + bsp_nprocs() - 1) % bsp_nprocs();
+	bsp_put_slot( right, &(slotted[ 0 ]), slot, sizeof( size_t ), sizeof( size_t ) );
+	bsp_get_slot( left, slot, 0, &(slotted[ 2 ]), sizeof( size_t ) );
+	bsp_sync();
+	size_t direct = SIZE_MAX;
+	bsp_direct_get_slot( right, slot, sizeof( size_t ), &direct, sizeof( size_t ) );
+	if( slotted[ 1 ] != (size_t)left || slotted[ 2 ] != (size_t)left || direct != (size_t)bsp_pid() ) {
+		fprintf( stderr, "FAILURE \t communication through memory slots is erroneous (%d: %zd %zd %zd)!\n", bsp_pid(), slotted[ 1 ], slotted[ 2 ], direct );
+		mcbsp_util_fatal();
+	}
+	bsp_sync();
+	bsp_pop_reg( &slotted );
+	bsp_sync();
+
+	//batched puts and gets; everyone writes its ID into element bsp_pid() of every commTest
+	const size_t own_id = (size_t)bsp_pid();
+	struct bsp_transfer transfers[ 3 ];
+	for( unsigned int k = 0; k < 3; ++k ) {
+		transfers[ k ].pid           = k;
+		transfers[ k ].local_offset  = 0;
+		transfers[ k ].remote_offset = own_id * sizeof( size_t );
+		transfers[ k ].size          = sizeof( size_t );
+	}
+	bsp_put_many( &own_id, &commTest, transfers, 3 );
+	bsp_sync();
+	size_t gathered[ 3 ] = { SIZE_MAX, SIZE_MAX, SIZE_MAX };
+	for( unsigned int k = 0; k < 3; ++k ) {
+		transfers[ k ].local_offset  = k * sizeof( size_t );
+		transfers[ k ].remote_offset = k * sizeof( size_t );
+	}
+	bsp_get_many( &commTest, &gathered, transfers, 3 );
+	bsp_sync();
+	for( size_t k = 0; k < 3; ++k ) {
+		if( commTest[ k ] != k || gathered[ k ] != k ) {
+			fprintf( stderr, "FAILURE \t bsp_put_many or bsp_get_many is erroneous (%d: %zd %zd at %zd)!\n", bsp_pid(), commTest[ k ], gathered[ k ], k );
+			mcbsp_util_fatal();
+		}
+	}
+
+	//strided and indexed puts and gets on a 4-by-3 row-major matrix
+	double grid[ 12 ], local[ 12 ], column[ 4 ];
+	for( size_t k = 0; k < 12; ++k ) {
+		grid[ k ]  = -1.0;
+		local[ k ] = 100.0 * bsp_pid() + k;
+	}
+	bsp_push_reg( &grid, 12 * sizeof( double ) );
+	bsp_sync();
+	const bsp_size_t corners[ 2 ] = { 0, 11 * sizeof( double ) };
+	bsp_put_strided( right, &(local[ 0 ]), 3 * sizeof( double ), &grid, sizeof( double ), 3 * sizeof( double ), sizeof( double ), 4 );
+	bsp_put_indexed( right, &(local[ 1 ]), &grid, corners, sizeof( double ), 2 );
+	bsp_sync();
+	bsp_get_strided( left, &grid, sizeof( double ), 3 * sizeof( double ), &column, sizeof( double ), sizeof( double ), 4 );
+	bsp_sync();
+	const double second = 100.0 * ((left + bsp_nprocs() - 1) % bsp_nprocs());
+	if( grid[ 0 ] != 100.0 * left + 1 || grid[ 11 ] != 100.0 * left + 2 || grid[ 2 ] != -1.0 ) {
+		fprintf( stderr, "FAILURE \t bsp_put_indexed is erroneous (%d: %f %f %f)!\n", bsp_pid(), grid[ 0 ], grid[ 11 ], grid[ 2 ] );
+		mcbsp_util_fatal();
+	}
+	for( size_t k = 0; k < 4; ++k ) {
+		if( grid[ 3 * k + 1 ] != 100.0 * left + 3 * k || column[ k ] != second + 3 * k ) {
+			fprintf( stderr, "FAILURE \t bsp_put_strided or bsp_get_strided is erroneous (%d: %f %f at %zd)!\n", bsp_pid(), grid[ 3 * k + 1 ], column[ k ], k );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_pop_reg( &grid );
+	bsp_sync();
+
+	//communication plans: record a ring shift once, then replay it
+	size_t ring[ 2 ] = { SIZE_MAX, own_id };
+	size_t shifted = SIZE_MAX;
+	bsp_push_reg( &ring, 2 * sizeof( size_t ) );
+	bsp_sync();
+	bsp_plan_begin();
+	bsp_put( right, &(ring[ 1 ]), &ring, 0, sizeof( size_t ) );
+	bsp_get( left, &ring, sizeof( size_t ), &shifted, sizeof( size_t ) );
+	bsp_send( right, &own_id, &(ring[ 1 ]), sizeof( size_t ) );
+	bsp_plan_t plan = bsp_plan_end();
+	for( size_t k = 0; k < 4; ++k ) {
+		if( k > 0 ) {
+			ring[ 1 ] = own_id + k * bsp_nprocs();
+			bsp_execute_plan( plan );
+		}
+		bsp_sync();
+		const size_t expected = (size_t)left + k * bsp_nprocs();
+		bsp_size_t status;
+		size_t tag = SIZE_MAX, moved = SIZE_MAX;
+		bsp_get_tag( &status, &tag );
+		bsp_move( &moved, sizeof( size_t ) );
+		if( ring[ 0 ] != expected || shifted != expected || tag != (size_t)left || moved != expected ) {
+			fprintf( stderr, "FAILURE \t replay of a communication plan is erroneous (%d: %zd %zd %zd %zd, expected %zd)!\n",
+				bsp_pid(), ring[ 0 ], shifted, tag, moved, expected );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_plan_destroy( plan );
+
+	//a recorded bsp_put buffers its source on replay, so an in-place ring shift stays correct
+	ring[ 0 ] = own_id;
+	bsp_plan_begin();
+	bsp_put( right, &(ring[ 0 ]), &ring, 0, sizeof( size_t ) );
+	plan = bsp_plan_end();
+	for( size_t k = 1; k <= 4; ++k ) {
+		if( k > 1 ) {
+			bsp_execute_plan( plan );
+			ring[ 0 ] = SIZE_MAX;
+		}
+		bsp_sync();
+		const size_t expected = (own_id + k * (bsp_nprocs() - 1)) % bsp_nprocs();
+		if( ring[ 0 ] != expected ) {
+			fprintf( stderr, "FAILURE \t replay of a recorded in-place bsp_put is erroneous (%d: %zd, expected %zd)!\n",
+				bsp_pid(), ring[ 0 ], expected );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_plan_destroy( plan );
+
+	//a recorded strided get is replayed along with the plan
+	size_t pair[ 3 ] = { SIZE_MAX, SIZE_MAX, SIZE_MAX };
+	bsp_plan_begin();
+	bsp_get_strided( left, &ring, 0, sizeof( size_t ), pair, 2 * sizeof( size_t ), sizeof( size_t ), 2 );
+	plan = bsp_plan_end();
+	for( size_t k = 0; k < 3; ++k ) {
+		ring[ 0 ] = 10 * own_id + k;
+		ring[ 1 ] = 10 * own_id + k + 5;
+		if( k > 0 ) {
+			pair[ 0 ] = pair[ 2 ] = SIZE_MAX;
+			bsp_execute_plan( plan );
+		}
+		bsp_sync();
+		const size_t expected = 10 * (size_t)left + k;
+		if( pair[ 0 ] != expected || pair[ 1 ] != SIZE_MAX || pair[ 2 ] != expected + 5 ) {
+			fprintf( stderr, "FAILURE \t replay of a recorded bsp_get_strided is erroneous (%d: %zd %zd %zd, expected %zd)!\n",
+				bsp_pid(), pair[ 0 ], pair[ 1 ], pair[ 2 ], expected );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_plan_destroy( plan );
+
+	//split-phase synchronisation, with and without gets
+	for( size_t k = 0; k < 2; ++k ) {
+		ring[ 1 ] = own_id + 10 * k;
+		bsp_put( right, &(ring[ 1 ]), &ring, 0, sizeof( size_t ) );
+		if( k == 1 ) {
+			bsp_get( left, &ring, sizeof( size_t ), &shifted, sizeof( size_t ) );
+		}
+		bsp_sync_begin();
+		size_t local_work = 0;
+		for( size_t i = 0; i < 1000; ++i ) {
+			local_work += i;
+		}
+		bsp_sync_end();
+		const size_t expected = (size_t)left + 10 * k;
+		if( ring[ 0 ] != expected || (k == 1 && shifted != expected) || local_work != 499500 ) {
+			fprintf( stderr, "FAILURE \t split-phase synchronisation is erroneous (%d: %zd %zd, expected %zd)!\n",
+				bsp_pid(), ring[ 0 ], shifted, expected );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_pop_reg( &ring );
+	bsp_sync();
+
 #ifdef MCBSP_ALLOW_MULTIPLE_REGS
 	//test multiple regs
 	double mreg[17];
@@ -352,6 +765,121 @@ void spmd( void ) {
 	bsp_end();
 }
 
+void rerun( void ) {
+	bsp_begin( 3 );
+#ifdef MCBSP_THREAD_POOL
+	pooled[ run ][ bsp_pid() ] = pthread_self();
+#endif
+	bsp_sync();
+	bsp_end();
+}
+
+void imbalanced( void ) {
+	bsp_begin( 3 );
+	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
+	const size_t s = (size_t)bsp_pid();
+	const size_t left = (s + 2) % 3;
+	size_t token = SIZE_MAX;
+	bsp_push_reg( &token, sizeof( size_t ) );
+	bsp_sync();
+
+	//process 0 arrives late at every barrier, so the others spin or block
+	const struct timespec delay = { 0, 2000000 };
+	for( size_t k = 0; k < 8; ++k ) {
+		if( s == 0 ) {
+			nanosleep( &delay, NULL );
+		}
+		const size_t value = 100 * s + k;
+		bsp_put( (s + 1) % 3, &value, &token, 0, sizeof( size_t ) );
+		bsp_sync();
+		if( token != 100 * left + k ) {
+			fprintf( stderr, "FAILURE \t barrier with a %zd ns spin window let process %zd pass early (%zd, expected %zd)!\n",
+				data->init->barrier_spin_window, s, token, 100 * left + k );
+			mcbsp_util_fatal();
+		}
+	}
+
+	//the waiting processes adapt their windows to the imbalance, within the configured bound
+	const size_t window = data->init->barrier_local[ s ].spin_window;
+	const size_t bound  = data->init->barrier_spin_window;
+	if( s != 0 && (
+		window > bound ||
+		(bound == 0 && window != 0) ||
+		(bound > 0 && bound < 4000000 && window != MCBSP_SPIN_WINDOW_MIN) ||
+		(bound >= 4000000 && window <= MCBSP_SPIN_WINDOW_MIN)
+	) ) {
+		fprintf( stderr, "FAILURE \t process %zd adapted its spin window to %zd ns under a %zd ns bound!\n", s, window, bound );
+		mcbsp_util_fatal();
+	}
+	bsp_pop_reg( &token );
+	bsp_end();
+}
+
+/** Number of processes of the sparse communication test; spans several word-sized blocks. */
+#define SPARSE_P 20
+
+void sparse( void ) {
+	bsp_begin( SPARSE_P );
+	const struct mcbsp_thread_data * const data = mcbsp_internal_const_prefunction();
+	const size_t s = (size_t)bsp_pid();
+	size_t inbox[ SPARSE_P ];
+	for( size_t k = 0; k < SPARSE_P; ++k ) {
+		inbox[ k ] = SIZE_MAX;
+	}
+	bsp_push_reg( inbox, SPARSE_P * sizeof( size_t ) );
+	bsp_sync();
+
+	//every process writes to and messages a single, far-away process
+	const size_t destination = (7 * s + 3) % SPARSE_P;
+	const size_t value = 100 * s;
+	bsp_put( destination, &value, inbox, s * sizeof( size_t ), sizeof( size_t ) );
+	bsp_send( destination, NULL, &value, sizeof( size_t ) );
+	for( size_t k = 0; k < SPARSE_P; ++k ) {
+		if( (k == destination) != (data->outboxes[ (data->superstep % 2) * SPARSE_P + k ] != NULL) ) {
+			fprintf( stderr, "FAILURE \t process %zd allocated its queue towards %zd %s!\n", s, k,
+				k == destination ? "too late" : "without communicating" );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_sync();
+	size_t source = SIZE_MAX;
+	for( size_t k = 0; k < SPARSE_P; ++k ) {
+		if( (7 * k + 3) % SPARSE_P == s ) {
+			source = k;
+		}
+	}
+	bsp_nprocs_t packets;
+	bsp_size_t bytes;
+	bsp_qsize( &packets, &bytes );
+	size_t moved = SIZE_MAX;
+	bsp_move( &moved, sizeof( size_t ) );
+	for( size_t k = 0; k < SPARSE_P; ++k ) {
+		if( inbox[ k ] != (k == source ? 100 * k : SIZE_MAX) ) {
+			fprintf( stderr, "FAILURE \t process %zd received %zd from %zd in a sparse pattern!\n", s, inbox[ k ], k );
+			mcbsp_util_fatal();
+		}
+	}
+	if( packets != 1 || moved != 100 * source ) {
+		fprintf( stderr, "FAILURE \t process %zd received %zd messages (%zd) in a sparse pattern!\n", s, (size_t)packets, moved );
+		mcbsp_util_fatal();
+	}
+
+	//a single pair at opposite ends of the process range communicates
+	inbox[ source ] = SIZE_MAX;
+	if( s == SPARSE_P - 1 ) {
+		bsp_put( 0, &value, inbox, s * sizeof( size_t ), sizeof( size_t ) );
+	}
+	bsp_sync();
+	for( size_t k = 0; k < SPARSE_P; ++k ) {
+		if( inbox[ k ] != (s == 0 && k == SPARSE_P - 1 ? 100 * k : SIZE_MAX) ) {
+			fprintf( stderr, "FAILURE \t process %zd received %zd from %zd from a single sender!\n", s, inbox[ k ], k );
+			mcbsp_util_fatal();
+		}
+	}
+	bsp_pop_reg( inbox );
+	bsp_end();
+}
+
 int main(int argc, char **argv) {
 	//test bsp_init
 	bsp_init( spmd, argc, argv );
@@ -410,6 +938,44 @@ int main(int argc, char **argv) {
 		mcbsp_util_fatal();
 	}
 	
+	//consecutive SPMD sections reuse the parked threads of earlier ones
+	for( unsigned char i = 0; i < 2; ++i ) {
+		bsp_init( rerun, argc, argv );
+		rerun();
+#ifdef MCBSP_THREAD_POOL
+		++run;
+#endif
+	}
+#ifdef MCBSP_THREAD_POOL
+	if( !(
+		( pthread_equal( pooled[ 0 ][ 1 ], pooled[ 1 ][ 1 ] ) && pthread_equal( pooled[ 0 ][ 2 ], pooled[ 1 ][ 2 ] ) ) ||
+		( pthread_equal( pooled[ 0 ][ 1 ], pooled[ 1 ][ 2 ] ) && pthread_equal( pooled[ 0 ][ 2 ], pooled[ 1 ][ 1 ] ) )
+	) ) {
+		fprintf( stderr, "FAILURE \t bsp_begin did not reuse the threads of an earlier SPMD section!\n" );
+		mcbsp_util_fatal();
+	}
+#endif
+
+	//block right away, cap the window below the imbalance, and spin through it
+	const size_t windows[ 3 ] = { 0, 500, 100000 };
+	for( unsigned char i = 0; i < 3; ++i ) {
+		mcbsp_set_spin_window( windows[ i ] );
+		bsp_init( imbalanced, argc, argv );
+		imbalanced();
+	}
+	mcbsp_set_spin_window( MCBSP_DEFAULT_SPIN_WINDOW );
+
+	//communication between few, distant pairs of processes
+	free( MCBSP_MACHINE_INFO->manual_affinity );
+	MCBSP_MACHINE_INFO->threads = SPARSE_P;
+	MCBSP_MACHINE_INFO->cores   = SPARSE_P;
+	MCBSP_MACHINE_INFO->manual_affinity = malloc( SPARSE_P * sizeof( size_t ) );
+	for( unsigned char i = 0; i < SPARSE_P; ++i )
+		MCBSP_MACHINE_INFO->manual_affinity[ i ] = 0;
+	bsp_init( sparse, argc, argv );
+	sparse();
+	mcbsp_release_threads();
+
 	//cleanup
 	free( MCBSP_MACHINE_INFO->manual_affinity );
 	MCBSP_MACHINE_INFO->manual_affinity = NULL;
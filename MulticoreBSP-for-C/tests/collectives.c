@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026
+ *
+ * File created 18/10/2026.
+ *
+ * This file is part of MulticoreBSP in C --
+ *        a port of the original Java-based MulticoreBSP.
+ *
+ * MulticoreBSP for C is distributed as part of the original
+ * MulticoreBSP and is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU Lesser
+ * General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MulticoreBSP is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with MulticoreBSP. If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "mcbsp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+//large enough to trigger the sliced reductions
+#define LARGE (MCBSP_COLLECTIVES_SLICE_THRESHOLD / sizeof( double ) + 5)
+
+static unsigned int P;
+static bool success = true;
+
+static pthread_mutex_t test_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void spmd( void );
+static void fail( const char * const what, const unsigned int s );
+
+static void fail( const char * const what, const unsigned int s ) {
+	pthread_mutex_lock( &test_mutex );
+	fprintf( stderr, "FAILURE \t %s incorrect at PID %u (P=%u)!\n", what, s, P );
+	success = false;
+	pthread_mutex_unlock( &test_mutex );
+}
+
+void spmd( void ) {
+	bsp_begin( P );
+	const unsigned int p = (unsigned int)bsp_nprocs();
+	const unsigned int s = (unsigned int)bsp_pid();
+
+	//broadcast, from a root other than 0
+	const bsp_pid_t root = p - 1;
+	size_t bcast[ 3 ] = { 0, 0, 0 };
+	size_t source[ 3 ] = { 7, 8, s };
+	mcbsp_broadcast( root, source, bcast, sizeof( bcast ) );
+	if( bcast[ 0 ] != 7 || bcast[ 1 ] != 8 || bcast[ 2 ] != p - 1 ) {
+		fail( "mcbsp_broadcast", s );
+	}
+
+	//reduce and allreduce of small buffers
+	int value[ 2 ] = { (int)s + 1, -(int)s };
+	int sum[ 2 ] = { 0, 0 };
+	mcbsp_reduce( 1 % p, value, sum, 2, MCBSP_INT, MCBSP_SUM );
+	if( s == 1 % p && ( sum[ 0 ] != (int)(p * (p + 1) / 2) || sum[ 1 ] != -(int)(p * (p - 1) / 2) ) ) {
+		fail( "mcbsp_reduce", s );
+	}
+	double dvalue = (double)s;
+	double dmax = -1.0;
+	mcbsp_allreduce( &dvalue, &dmax, 1, MCBSP_DOUBLE, MCBSP_MAX );
+	if( dmax != (double)(p - 1) ) {
+		fail( "mcbsp_allreduce (max)", s );
+	}
+
+	//allreduce of a large buffer
+	double * const large  = malloc( LARGE * sizeof( double ) );
+	double * const result = malloc( LARGE * sizeof( double ) );
+	for( size_t i = 0; i < LARGE; ++i ) {
+		large[ i ] = (double)(i + s);
+	}
+	mcbsp_allreduce( large, result, LARGE, MCBSP_DOUBLE, MCBSP_SUM );
+	for( size_t i = 0; i < LARGE; ++i ) {
+		if( result[ i ] != (double)(p * i + p * (p - 1) / 2) ) {
+			fail( "mcbsp_allreduce (large)", s );
+			break;
+		}
+	}
+	free( large );
+	free( result );
+
+	//inclusive scan
+	size_t one = 1, prefix = 0;
+	mcbsp_scan( &one, &prefix, 1, MCBSP_SIZE_T, MCBSP_SUM );
+	if( prefix != (size_t)s + 1 ) {
+		fail( "mcbsp_scan", s );
+	}
+
+	//allgather and alltoall
+	unsigned int * const gathered = malloc( 2 * p * sizeof( unsigned int ) );
+	unsigned int * const outgoing = malloc( p * sizeof( unsigned int ) );
+	unsigned int mine = 10 * s;
+	mcbsp_allgather( &mine, gathered, sizeof( unsigned int ) );
+	for( unsigned int k = 0; k < p; ++k ) {
+		outgoing[ k ] = 100 * s + k;
+		if( gathered[ k ] != 10 * k ) {
+			fail( "mcbsp_allgather", s );
+			break;
+		}
+	}
+	mcbsp_alltoall( outgoing, gathered, sizeof( unsigned int ) );
+	for( unsigned int k = 0; k < p; ++k ) {
+		if( gathered[ k ] != 100 * k + s ) {
+			fail( "mcbsp_alltoall", s );
+			break;
+		}
+	}
+	free( gathered );
+	free( outgoing );
+
+	//teams of even and odd processes
+	const mcbsp_team_t team = mcbsp_team_split( s % 2 );
+	const size_t tsize = mcbsp_team_size( team );
+	const size_t rank  = mcbsp_team_rank( team );
+	if( tsize != (p + 1 - s % 2) / 2 || rank != s / 2 || mcbsp_team_pid( team, rank ) != (bsp_pid_t)s ) {
+		fail( "mcbsp_team_split", s );
+	}
+	size_t pid = s, tsum = 0, tbcast = SIZE_MAX;
+	mcbsp_team_allreduce( team, &pid, &tsum, 1, MCBSP_SIZE_T, MCBSP_SUM );
+	mcbsp_team_broadcast( team, tsize - 1, &pid, &tbcast, sizeof( size_t ) );
+	mcbsp_team_scan( team, &one, &prefix, 1, MCBSP_SIZE_T, MCBSP_SUM );
+	if( tsum != tsize * (tsize - 1) + tsize * (s % 2) ) {
+		fail( "mcbsp_team_allreduce", s );
+	}
+	if( tbcast != 2 * (tsize - 1) + s % 2 ) {
+		fail( "mcbsp_team_broadcast", s );
+	}
+	if( prefix != rank + 1 ) {
+		fail( "mcbsp_team_scan", s );
+	}
+
+	//team DRMA: shift the process IDs around the team in both directions
+	size_t inbox = SIZE_MAX, fetched = SIZE_MAX;
+	mcbsp_team_push_reg( team, &pid, sizeof( size_t ) );
+	mcbsp_team_push_reg( team, &inbox, sizeof( size_t ) );
+	mcbsp_team_sync( team );
+	mcbsp_team_put( team, (rank + 1) % tsize, &pid, &inbox, 0, sizeof( size_t ) );
+	mcbsp_team_get( team, (rank + 1) % tsize, &pid, 0, &fetched, sizeof( size_t ) );
+	mcbsp_team_sync( team );
+	if( inbox != (size_t)mcbsp_team_pid( team, (rank + tsize - 1) % tsize ) ||
+		fetched != (size_t)mcbsp_team_pid( team, (rank + 1) % tsize )
+	) {
+		fail( "mcbsp_team_put/mcbsp_team_get", s );
+	}
+	mcbsp_team_destroy( team );
+
+	bsp_end();
+}
+
+int main( int argc, char **argv ) {
+	struct mcbsp_util_machine_info * MCBSP_MACHINE_INFO = mcbsp_internal_getMachineInfo();
+	const unsigned int tests[ 2 ] = { 3, MCBSP_COLLECTIVES_TREE_THRESHOLD + 3 };
+
+	//allow oversubscription, so that the tree schedules get tested too
+	MCBSP_MACHINE_INFO->threads = tests[ 1 ];
+	MCBSP_MACHINE_INFO->cores   = tests[ 1 ];
+	if( MCBSP_MACHINE_INFO->manual_affinity != NULL ) free( MCBSP_MACHINE_INFO->manual_affinity );
+	MCBSP_MACHINE_INFO->manual_affinity = malloc( tests[ 1 ] * sizeof( size_t ) );
+	for( unsigned int i = 0; i < tests[ 1 ]; ++i )
+		MCBSP_MACHINE_INFO->manual_affinity[ i ] = 0;
+	MCBSP_MACHINE_INFO->affinity = MANUAL;
+
+	//the collectives rely on barriers for their correctness; exercise each barrier algorithm
+	const enum mcbsp_barrier_mode barriers[ 4 ] = {
+		MCBSP_BARRIER_CENTRAL, MCBSP_BARRIER_DISSEMINATION, MCBSP_BARRIER_TOURNAMENT, MCBSP_BARRIER_TREE
+	};
+	for( unsigned int b = 0; b < 4; ++b ) {
+		mcbsp_set_barrier_mode( barriers[ b ] );
+		for( unsigned int t = 0; t < 2; ++t ) {
+			P = tests[ t ];
+			bsp_init( spmd, argc, argv );
+			spmd();
+		}
+	}
+
+	if( success ) {
+		fprintf( stdout, "SUCCESS\n" );
+	}
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
@@ -29,6 +29,72 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <sys/stat.h>
+
+static char fake_paths[ 128 ][ 256 ];
+static size_t fake_count = 0;
+
+/** Creates a file or, if contents is NULL, a directory in a fake sysfs tree, and remembers it for removal. */
+static void fake_sysfs( const char * const root, const char * const path, const char * const contents ) {
+	char * const full = fake_paths[ fake_count++ ];
+	snprintf( full, 256, "%s/%s", root, path );
+	if( contents == NULL ) {
+		mkdir( full, 0700 );
+	} else {
+		FILE * const fp = fopen( full, "w" );
+		fputs( contents, fp );
+		fclose( fp );
+	}
+}
+
+/** Builds two packages, each with two cores of two SMT siblings numbered at +4, plus one offline hardware thread. */
+static void fake_sysfs_topology( const char * const root ) {
+	char path[ 128 ];
+	char value[ 16 ];
+	fake_sysfs( root, "cpu", NULL );
+	fake_sysfs( root, "cpu/cpufreq", NULL );
+	fake_sysfs( root, "cpu/cpu8", NULL );
+	fake_sysfs( root, "cpu/cpu8/online", "0\n" );
+	for( size_t i = 0; i < 8; ++i ) {
+		const size_t package = (i % 4) / 2;
+		snprintf( path, 128, "cpu/cpu%zd", i ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/node%zd", i, package ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/topology", i ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/topology/physical_package_id", i );
+		snprintf( value, 16, "%zd\n", package ); fake_sysfs( root, path, value );
+		snprintf( path, 128, "cpu/cpu%zd/topology/core_id", i );
+		snprintf( value, 16, "%zd\n", i % 2 ); fake_sysfs( root, path, value );
+		snprintf( path, 128, "cpu/cpu%zd/cache", i ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/cache/index0", i ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/cache/index0/level", i ); fake_sysfs( root, path, "1\n" );
+		snprintf( path, 128, "cpu/cpu%zd/cache/index1", i ); fake_sysfs( root, path, NULL );
+		snprintf( path, 128, "cpu/cpu%zd/cache/index1/level", i ); fake_sysfs( root, path, "3\n" );
+		snprintf( path, 128, "cpu/cpu%zd/cache/index1/shared_cpu_list", i );
+		snprintf( value, 16, "%zd-%zd,%zd-%zd\n", 2 * package, 2 * package + 1, 2 * package + 4, 2 * package + 5 );
+		fake_sysfs( root, path, value );
+	}
+}
+
+/** Checks a topology-based pinning of P threads against the expected one. */
+static void check_topology_pinning( struct mcbsp_util_machine_info * const info, const enum mcbsp_affinity_mode affinity,
+	const size_t P, const size_t * const expected, const char * const name
+) {
+	info->affinity = affinity;
+	struct mcbsp_util_pinning_info pinning = mcbsp_util_pinning( P, info, NULL );
+	if( pinning.partition.top != 0 ) {
+		fprintf( stderr, "FAILURE \t %s affinity returned submachines!\n", name );
+		exit( EXIT_SUCCESS );
+	}
+	for( size_t s = 0; s < P; ++s ) {
+		if( pinning.pinning[ s ] != expected[ s ] ) {
+			fprintf( stderr, "FAILURE \t %s affinity pinned thread %zd to %zd instead of %zd!\n", name, s, pinning.pinning[ s ], expected[ s ] );
+			exit( EXIT_SUCCESS );
+		}
+	}
+	free( pinning.pinning );
+	mcbsp_util_stack_destroy( &(pinning.partition) );
+}
+
 int main( int argc, char **argv ) {
 	(void)argc;
 	(void)argv;
@@ -97,6 +163,56 @@ int main( int argc, char **argv ) {
 	free( info->manual_affinity );
 	info->manual_affinity = NULL;
 
+	char fake_root[] = "/tmp/mcbsp-sysfs-XXXXXX";
+	if( mkdtemp( fake_root ) == NULL ) {
+		fprintf( stderr, "FAILURE \t could not create a fake sysfs tree!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	fake_sysfs_topology( fake_root );
+	info->topology = mcbsp_util_read_topology( fake_root, &(info->topology_size) );
+	for( size_t i = fake_count; i > 0; --i ) {
+		remove( fake_paths[ i - 1 ] );
+	}
+	remove( fake_root );
+	if( info->topology == NULL || info->topology_size != 8 ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_read_topology did not find the eight online hardware threads!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	for( size_t i = 0; i < 8; ++i ) {
+		const struct mcbsp_util_hw_thread thread = info->topology[ i ];
+		if( thread.id != i || thread.core != i % 4 || thread.core_id != i % 2 || thread.smt != i / 4 || thread.package != (i % 4) / 2 ||
+			thread.node != thread.package || thread.l3 != 2 * thread.package
+		) {
+			fprintf( stderr, "FAILURE \t mcbsp_util_read_topology misread hardware thread %zd!\n", i );
+			exit( EXIT_SUCCESS );
+		}
+	}
+	const size_t numa_balanced[ 4 ] = { 0, 2, 1, 3 };
+	const size_t l3_compact[ 4 ]    = { 0, 1, 4, 5 };
+	const size_t per_core[ 6 ]      = { 0, 1, 2, 3, 4, 5 };
+	const size_t no_smt[ 4 ]        = { 0, 1, 2, 3 };
+	const size_t reserved_core[ 3 ] = { 0, 1, 3 };
+	check_topology_pinning( info, NUMA_BALANCED, 4, numa_balanced, "numa-balanced" );
+	check_topology_pinning( info, L3_COMPACT, 4, l3_compact, "l3-compact" );
+	check_topology_pinning( info, ONE_PER_PHYSICAL_CORE, 6, per_core, "one-per-physical-core" );
+	info->unused_threads_per_core = 1;
+	check_topology_pinning( info, ONE_PER_PHYSICAL_CORE, 4, no_smt, "one-per-physical-core without SMT" );
+	//core 2 is the first core of the second package, though its OS core ID is 0
+	info->reserved_cores = mcbsp_util_malloc( sizeof( size_t ), "reserved cores test" );
+	info->reserved_cores[ 0 ] = 2;
+	info->num_reserved_cores = 1;
+	info->threads = 9;
+	check_topology_pinning( info, ONE_PER_PHYSICAL_CORE, 3, reserved_core, "one-per-physical-core with a reserved core" );
+	free( info->reserved_cores );
+	info->reserved_cores = NULL;
+	info->num_reserved_cores = 0;
+	info->threads = 10;
+	info->unused_threads_per_core = 0;
+	free( info->topology );
+	info->topology = NULL;
+	info->topology_size = 0;
+	info->affinity = SCATTER;
+
 	struct mcbsp_util_address_map map;
 
 	mcbsp_util_address_map_initialise( &map );
@@ -112,7 +228,7 @@ int main( int argc, char **argv ) {
 	}
 
 	mcbsp_util_address_map_insert( &map, (void*)1, 17 );
-	if( map.cap != 32 || map.size != 1 || map.keys == NULL || map.values == NULL || map.keys[ 0 ] != ((void*)1) || map.values[ 0 ] != 17 ) {
+	if( map.cap != 32 || map.size != 1 || map.keys == NULL || map.values == NULL || mcbsp_util_address_map_get( &map, (void*)1 ) != 17 ) {
 		fprintf( stderr, "FAILURE \t insertion on a mcbsp_util_address_map failed!\n" );
 		exit( EXIT_SUCCESS );
 	}
@@ -125,25 +241,13 @@ int main( int argc, char **argv ) {
 		fprintf( stderr, "FAILURE \t repeated insertions on a mcbsp_util_address_map failed!\n" );
 		exit( EXIT_SUCCESS );
 	}
-	for( size_t i = 1; i < map.size; ++i ) {
-		if( map.keys[ i ] <= map.keys[ i - 1 ] ) {
-			fprintf( stderr, "FAILURE \t insertion sort on mcbsp_util_address_map failed!\n" );
-			exit( EXIT_SUCCESS );
+	size_t occupied = 0;
+	for( size_t i = 0; i < map.cap; ++i ) {
+		if( map.values[ i ] != SIZE_MAX ) {
+			++occupied;
 		}
 	}
-	if( map.keys[ 0 ] != (void*)0 ||
-		map.keys[ 1 ] != (void*)1 ||
-		map.keys[ 2 ] != (void*)2 ||
-		map.keys[ 3 ] != (void*)3 ||
-		map.keys[ 4 ] != (void*)7 ) {
-		fprintf( stderr, "FAILURE \t contents of map.keys are not as expected!\n" );
-		exit( EXIT_SUCCESS );
-	}
-	if( map.values[ 0 ] != 11 ||
-		map.values[ 1 ] != 17 ||
-		map.values[ 2 ] != 42 ||
-		map.values[ 3 ] != 30 ||
-		map.values[ 4 ] != 13 ) {
+	if( occupied != 5 ) {
 		fprintf( stderr, "FAILURE \t contents of map.values are not as expected!\n" );
 		exit( EXIT_SUCCESS );
 	}
@@ -166,6 +270,27 @@ int main( int argc, char **argv ) {
 		exit( EXIT_SUCCESS );
 	}
 	
+	//enough colliding-prone keys to force growth and long probe sequences
+	for( size_t i = 1; i <= 1000; ++i ) {
+		mcbsp_util_address_map_insert( &map, (void*)(i * 64), i );
+	}
+	for( size_t i = 1; i <= 1000; i += 2 ) {
+		mcbsp_util_address_map_remove( &map, (void*)(i * 64) );
+	}
+	for( size_t i = 1; i <= 1000; ++i ) {
+		if( mcbsp_util_address_map_get( &map, (void*)(i * 64) ) != (i % 2 == 0 ? i : SIZE_MAX) ) {
+			fprintf( stderr, "FAILURE \t mcbsp_util_address_map lost entries after growing and removals!\n" );
+			exit( EXIT_SUCCESS );
+		}
+	}
+
+	const size_t grown = map.cap;
+	mcbsp_util_address_map_clear( &map );
+	if( map.cap != grown || map.size != 0 || mcbsp_util_address_map_get( &map, (void*)128 ) != SIZE_MAX ) {
+		fprintf( stderr, "FAILURE \t clearing the mcbsp_util_address_map failed!\n" );
+		exit( EXIT_SUCCESS );
+	}
+
 	mcbsp_util_address_map_destroy( &map );
 	if( map.cap != 0 || map.size != 0 || map.keys != NULL || map.values != NULL ) {
 		fprintf( stderr, "FAILURE \t destroying the mcbsp_util_address_map failed!\n" );
@@ -283,6 +408,85 @@ int main( int argc, char **argv ) {
 		exit( EXIT_SUCCESS );
 	}
 
+	mcbsp_util_stack_initialise_lazy( &stack, sizeof( unsigned long int ) );
+	if( stack.cap != 0 || stack.top != 0 || stack.size != sizeof( unsigned long int ) || stack.array != NULL ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_stack_initialise_lazy allocated memory!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	toPush = 9ul;
+	mcbsp_util_stack_push( &stack, &toPush );
+	if( stack.cap != 16 || stack.top != 1 || stack.array == NULL || *((unsigned long int*)(stack.array)) != 9ul ) {
+		fprintf( stderr, "FAILURE \t the first push on a lazily initialised stack does not function correctly!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	mcbsp_util_stack_destroy( &stack );
+	mcbsp_util_stack_initialise_lazy( &stack, 8 );
+	mcbsp_util_varstack_push( &stack, &toPush, sizeof( unsigned long int ) );
+	if( stack.top != sizeof( unsigned long int ) || stack.cap < stack.top || *((unsigned long int*)(stack.array)) != 9ul ) {
+		fprintf( stderr, "FAILURE \t the first push on a lazily initialised varstack does not function correctly!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	mcbsp_util_stack_destroy( &stack );
+
+	struct mcbsp_util_arena arena;
+	mcbsp_util_arena_initialise( &arena, sizeof( unsigned long int ) );
+	if( arena.first != NULL || arena.current != NULL || arena.cap != 0 || !mcbsp_util_arena_empty( &arena ) ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_arena_initialise allocated memory!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	unsigned long int * first_item = NULL;
+	for( unsigned long int i = 0; i < 100; ++i ) {
+		mcbsp_util_arena_regpush( &arena, &i );
+		if( i == 0 ) {
+			first_item = (unsigned long int *)(arena.first + 1);
+		}
+	}
+	if( arena.first == arena.current || *first_item != 0ul || mcbsp_util_arena_empty( &arena ) ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_arena_push did not grow the arena by adding chunks!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	for( unsigned long int i = 100; i > 0; --i ) {
+		if( *((unsigned long int*)mcbsp_util_arena_regpop( &arena )) != i - 1 ) {
+			fprintf( stderr, "FAILURE \t mcbsp_util_arena_pop did not return items in reverse order!\n" );
+			exit( EXIT_SUCCESS );
+		}
+	}
+	if( !mcbsp_util_arena_empty( &arena ) || arena.current != arena.first ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_arena_pop did not return to the first chunk!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	const size_t arena_cap = arena.cap;
+	for( unsigned long int i = 0; i < 100; ++i ) {
+		mcbsp_util_arena_regpush( &arena, &i );
+	}
+	mcbsp_util_arena_reset( &arena );
+	if( !mcbsp_util_arena_empty( &arena ) || arena.cap != arena_cap || arena.current != arena.first ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_arena_reset did not retain the arena chunks!\n" );
+		exit( EXIT_SUCCESS );
+	}
+	mcbsp_util_arena_destroy( &arena );
+	if( arena.first != NULL || arena.current != NULL || arena.cap != 0 ) {
+		fprintf( stderr, "FAILURE \t mcbsp_util_arena_destroy does not function properly!\n" );
+		exit( EXIT_SUCCESS );
+	}
+
+	//binding to the current node, also partially and for areas smaller than a page, keeps the contents
+	const size_t node = mcbsp_util_numa_node();
+	unsigned char * const bound = mcbsp_util_malloc( 1 << 16, "NUMA binding test" );
+	for( size_t i = 0; i < (1 << 16); ++i ) {
+		bound[ i ] = (unsigned char)i;
+	}
+	mcbsp_util_numa_bind( bound, 1 << 16, node );
+	mcbsp_util_numa_bind( bound + 3, 1000, node );
+	mcbsp_util_numa_bind( bound + 17, (1 << 15) + 5, node );
+	for( size_t i = 0; i < (1 << 16); ++i ) {
+		if( bound[ i ] != (unsigned char)i ) {
+			fprintf( stderr, "FAILURE \t mcbsp_util_numa_bind changed the memory contents!\n" );
+			exit( EXIT_SUCCESS );
+		}
+	}
+	free( bound );
+
 	if( mcbsp_util_log2( 0 ) != 0 ) {
 		fprintf( stderr, "FAILURE \t mcbsp_util_log2( 0 ) != 0!\n" );
 		exit( EXIT_SUCCESS );
@@ -0,0 +1 @@
+gcc daemon.c -o daemon.out MulticoreBSP-for-C/lib/libmcbsp2.0.3.a -pthread -lm
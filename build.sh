@@ -1 +1 @@
-gcc main.c -o main.out MulticoreBSP-for-C/lib/libmcbsp2.0.3.a -pthread -lm
+gcc main.c stats.c -o main.out MulticoreBSP-for-C/lib/libmcbsp2.0.3.a -pthread -lm
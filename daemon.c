@@ -0,0 +1,625 @@
+/*
+ * Sieve-as-a-service: a long-running prime query server.
+ *
+ * Queries are read one per line, either from stdin (replies on stdout) or from
+ * clients of a Unix-domain socket (replies on the same connection):
+ *
+ *   isprime x    -> yes | no
+ *   pi a b       -> number of primes p with a <= p <= b
+ *   next x       -> the smallest prime larger than x
+ *   stats        -> query count, cache hit rate, rejected query count and
+ *                   p50/p99 latency
+ *
+ * The base primes up to sqrt(MAX_N) and a cache of recently used segments stay
+ * resident between queries. All queries that arrive together form one batch;
+ * the batch is resolved against the cache, and the union of the segments still
+ * missing is sieved in a single BSP pass, so every segment is sieved once no
+ * matter how many queries touch it. Since every segment is counted when it is
+ * sieved, large pi ranges only need the segments at their edges to be resident.
+ *
+ * Usage: daemon.out [-s socket_path] [-p processes] [-w batch_window_us]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "MulticoreBSP-for-C/include/bsp.h"
+
+#define SEGMENT_SIZE (1 << 18)
+#define MAX_N (1ULL << 32)
+#define SEGMENTS ((int)(MAX_N / SEGMENT_SIZE))
+#define BASE_LIMIT (1 << 16)
+
+/* Resident segment bitmaps; 64 slots of 256KiB */
+#define CACHE_SLOTS 64
+#define BATCH_MAX 1024
+#define MAX_CLIENTS 64
+#define LINE_MAX_LEN 256
+#define LATENCY_SAMPLES 65536
+
+enum QueryType {
+	Q_ISPRIME,
+	Q_PI,
+	Q_NEXT,
+	Q_STATS,
+	Q_INVALID
+};
+
+struct Query {
+	enum QueryType type;
+	uint64_t a;
+	uint64_t b;
+	/* Client index, or -1 for stdin */
+	int client;
+	/* Generation of the connection in that client slot when the query arrived */
+	uint64_t generation;
+	double arrival;
+	bool done;
+	char answer[128];
+};
+
+struct Slot {
+	int segment;
+	uint64_t lastUse;
+	bool *bits;
+};
+
+struct Client {
+	int fd;
+	/* Changes with every connection accepted into this slot */
+	uint64_t generation;
+	size_t length;
+	char buffer[LINE_MAX_LEN];
+};
+
+/* Resident state, lives as long as the daemon */
+static uint32_t *basePrimes;
+static int basePrimeCount;
+static int32_t segmentCount[SEGMENTS];
+static int16_t slotOf[SEGMENTS];
+/* Round in which a segment was last needed or used, which protects it from eviction */
+static uint32_t pinnedIn[SEGMENTS];
+static uint32_t assignedIn[CACHE_SLOTS];
+static struct Slot slots[CACHE_SLOTS];
+static uint64_t useClock = 0;
+
+/* The work list of the current BSP pass, read by every process */
+static int sieveList[CACHE_SLOTS];
+static int sieveSlot[CACHE_SLOTS];
+static int sieveAmount = 0;
+static int processes = 2;
+
+/* The batch being answered by the current SPMD section */
+static struct Query *currentBatch;
+static int currentAmount = 0;
+static uint32_t currentRound = 0;
+static bool firstRound = false;
+
+/* Statistics */
+static double latencies[LATENCY_SAMPLES];
+static uint64_t answered = 0;
+static uint64_t hits = 0;
+static uint64_t misses = 0;
+static uint64_t passes = 0;
+/* Malformed or out-of-range queries; not part of the counts and latencies above */
+static uint64_t rejected = 0;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int signal) {
+	(void)signal;
+	stopRequested = 1;
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void computeBasePrimes() {
+	bool *composite = (bool*)calloc(BASE_LIMIT + 1, sizeof(bool));
+	basePrimes = (uint32_t*)malloc(sizeof(uint32_t) * BASE_LIMIT);
+	basePrimeCount = 0;
+	for (uint32_t i = 2; i <= BASE_LIMIT; i++) {
+		if (composite[i]) continue;
+		basePrimes[basePrimeCount++] = i;
+		for (uint32_t j = i * i; j <= BASE_LIMIT; j += i) {
+			composite[j] = true;
+		}
+	}
+	free(composite);
+}
+
+/* Sieves one segment into bits and records its prime count */
+static void sieveSegment(int segment, bool *bits) {
+	uint64_t low = (uint64_t)segment * SEGMENT_SIZE;
+	uint64_t high = low + SEGMENT_SIZE;
+	memset(bits, 1, SEGMENT_SIZE);
+	if (low == 0) {
+		bits[0] = 0;
+		bits[1] = 0;
+	}
+	for (int k = 0; k < basePrimeCount; k++) {
+		uint64_t p = basePrimes[k];
+		if (p * p >= high) break;
+		uint64_t start = ((low + p - 1) / p) * p;
+		if (start < p * p) start = p * p;
+		for (uint64_t i = start; i < high; i += p) {
+			bits[i - low] = 0;
+		}
+	}
+	int32_t count = 0;
+	for (int i = 0; i < SEGMENT_SIZE; i++) {
+		count += bits[i];
+	}
+	segmentCount[segment] = count;
+}
+
+static bool *resident(int segment, uint32_t round) {
+	int slot = slotOf[segment];
+	if (slot < 0) return NULL;
+	slots[slot].lastUse = ++useClock;
+	pinnedIn[segment] = round;
+	return slots[slot].bits;
+}
+
+/* Adds a segment to this round's work list; false when the list is full */
+static bool need(int segment, uint32_t round) {
+	if (pinnedIn[segment] == round) return true;
+	if (sieveAmount == CACHE_SLOTS) return false;
+	pinnedIn[segment] = round;
+	sieveList[sieveAmount++] = segment;
+	return true;
+}
+
+static uint64_t countRange(const bool *bits, uint64_t from, uint64_t to) {
+	uint64_t count = 0;
+	for (uint64_t i = from; i <= to; i++) {
+		count += bits[i];
+	}
+	return count;
+}
+
+/*
+ * Tries to answer a query from the resident state. If that is not possible,
+ * the segments it is missing are added to the work list of this round.
+ */
+static bool resolve(struct Query *q, uint32_t round) {
+	switch (q->type) {
+	case Q_ISPRIME: {
+		int segment = (int)(q->a / SEGMENT_SIZE);
+		bool *bits = resident(segment, round);
+		if (bits == NULL) {
+			need(segment, round);
+			return false;
+		}
+		snprintf(q->answer, sizeof(q->answer), "%s", bits[q->a % SEGMENT_SIZE] ? "yes" : "no");
+		return true;
+	}
+	case Q_PI: {
+		int first = (int)(q->a / SEGMENT_SIZE);
+		int last = (int)(q->b / SEGMENT_SIZE);
+		bool *firstBits = resident(first, round);
+		bool *lastBits = resident(last, round);
+		bool complete = firstBits != NULL && lastBits != NULL;
+		// The edges are needed as bitmaps, and go first on the work list
+		if (firstBits == NULL) need(first, round);
+		if (lastBits == NULL) need(last, round);
+		uint64_t total = 0;
+		for (int s = first + 1; s < last; s++) {
+			if (segmentCount[s] < 0) {
+				complete = false;
+				if (!need(s, round)) break;
+			} else {
+				total += segmentCount[s];
+			}
+		}
+		if (!complete) return false;
+		if (first == last) {
+			total = countRange(firstBits, q->a % SEGMENT_SIZE, q->b % SEGMENT_SIZE);
+		} else {
+			total += countRange(firstBits, q->a % SEGMENT_SIZE, SEGMENT_SIZE - 1);
+			total += countRange(lastBits, 0, q->b % SEGMENT_SIZE);
+		}
+		snprintf(q->answer, sizeof(q->answer), "%llu", (unsigned long long)total);
+		return true;
+	}
+	case Q_NEXT: {
+		uint64_t candidate = q->a + 1;
+		while (candidate < MAX_N) {
+			int segment = (int)(candidate / SEGMENT_SIZE);
+			if (segmentCount[segment] == 0) {
+				candidate = (uint64_t)(segment + 1) * SEGMENT_SIZE;
+				continue;
+			}
+			bool *bits = resident(segment, round);
+			if (bits == NULL) {
+				need(segment, round);
+				return false;
+			}
+			for (uint64_t i = candidate % SEGMENT_SIZE; i < SEGMENT_SIZE; i++) {
+				if (bits[i]) {
+					snprintf(q->answer, sizeof(q->answer), "%llu",
+						(unsigned long long)((uint64_t)segment * SEGMENT_SIZE + i));
+					return true;
+				}
+			}
+			candidate = (uint64_t)(segment + 1) * SEGMENT_SIZE;
+		}
+		snprintf(q->answer, sizeof(q->answer), "error: no prime below %llu", MAX_N);
+		return true;
+	}
+	default:
+		return true;
+	}
+}
+
+/*
+ * Picks the slot to sieve into: an empty slot, else the least recently used
+ * slot that no query of this round relies on. If every slot is pinned, the
+ * least recently used slot not yet claimed in this round is taken; the
+ * affected queries simply retry in the next round.
+ */
+static int chooseVictim(uint32_t round) {
+	int victim = -1;
+	int fallback = -1;
+	for (int s = 0; s < CACHE_SLOTS; s++) {
+		if (assignedIn[s] == round) continue;
+		if (slots[s].segment < 0) return s;
+		if (fallback < 0 || slots[s].lastUse < slots[fallback].lastUse) {
+			fallback = s;
+		}
+		if (pinnedIn[slots[s].segment] == round) continue;
+		if (victim < 0 || slots[s].lastUse < slots[victim].lastUse) {
+			victim = s;
+		}
+	}
+	return victim >= 0 ? victim : fallback;
+}
+
+/* Assigns slots to the work list, evicting the least recently used segments */
+static void assignSlots(uint32_t round) {
+	for (int k = 0; k < sieveAmount; k++) {
+		int victim = chooseVictim(round);
+		if (slots[victim].segment >= 0) {
+			slotOf[slots[victim].segment] = -1;
+		}
+		slots[victim].segment = sieveList[k];
+		slots[victim].lastUse = ++useClock;
+		assignedIn[victim] = round;
+		slotOf[sieveList[k]] = (int16_t)victim;
+		sieveSlot[k] = victim;
+	}
+}
+
+static int compareDoubles(const void *a, const void *b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+static void latencySummary(char *out, size_t size) {
+	size_t samples = answered < LATENCY_SAMPLES ? answered : LATENCY_SAMPLES;
+	double p50 = 0, p99 = 0;
+	if (samples > 0) {
+		double *sorted = (double*)malloc(sizeof(double) * samples);
+		memcpy(sorted, latencies, sizeof(double) * samples);
+		qsort(sorted, samples, sizeof(double), compareDoubles);
+		p50 = sorted[(samples - 1) / 2];
+		p99 = sorted[(size_t)((samples - 1) * 0.99)];
+		free(sorted);
+	}
+	snprintf(out, size, "queries %llu hits %llu misses %llu passes %llu rejected %llu p50 %.1fus p99 %.1fus",
+		(unsigned long long)answered, (unsigned long long)hits,
+		(unsigned long long)misses, (unsigned long long)passes,
+		(unsigned long long)rejected, p50 * 1e6, p99 * 1e6);
+}
+
+static void parseQuery(struct Query *q, const char *line) {
+	char command[16];
+	unsigned long long a = 0, b = 0;
+	int fields = sscanf(line, "%15s %llu %llu", command, &a, &b);
+	q->type = Q_INVALID;
+	q->done = false;
+	q->a = a;
+	q->b = b;
+	snprintf(q->answer, sizeof(q->answer), "error: expected isprime x, pi a b, next x or stats");
+	if (fields < 1) return;
+	if (strcmp(command, "stats") == 0) {
+		q->type = Q_STATS;
+	} else if (strcmp(command, "isprime") == 0 && fields >= 2) {
+		q->type = Q_ISPRIME;
+	} else if (strcmp(command, "next") == 0 && fields >= 2) {
+		q->type = Q_NEXT;
+	} else if (strcmp(command, "pi") == 0 && fields == 3) {
+		q->type = Q_PI;
+		if (q->a > q->b) {
+			q->type = Q_INVALID;
+			snprintf(q->answer, sizeof(q->answer), "error: pi needs a <= b");
+		}
+	}
+	if (q->type != Q_INVALID && q->type != Q_STATS &&
+		(q->a >= MAX_N || (q->type == Q_PI && q->b >= MAX_N))) {
+		q->type = Q_INVALID;
+		snprintf(q->answer, sizeof(q->answer), "error: arguments must be below %llu", MAX_N);
+	}
+}
+
+/*
+ * Resolves what it can of the current batch, and prepares the work list and
+ * slots of the next pass over the missing segments. Run by PID 0 only.
+ */
+static void planRound() {
+	currentRound++;
+	sieveAmount = 0;
+	for (int i = 0; i < currentAmount; i++) {
+		struct Query *q = &currentBatch[i];
+		if (q->done || q->type == Q_STATS || q->type == Q_INVALID) continue;
+		q->done = resolve(q, currentRound);
+		if (firstRound) {
+			if (q->done) hits++;
+			else misses++;
+		}
+	}
+	firstRound = false;
+	if (sieveAmount > 0) {
+		assignSlots(currentRound);
+		passes++;
+	}
+}
+
+/*
+ * Answers the current batch within a single SPMD section. Every round, PID 0
+ * resolves the queries it can and plans a pass over the missing segments, which
+ * all processes then sieve. The processes share the address space, and every
+ * segment has its own slot and count entry, so each process writes its results
+ * in place without further communication. Once a round needs no segments, all
+ * queries are answered.
+ */
+static void spmd() {
+	bsp_begin(processes);
+	int pid = bsp_pid();
+	int P = bsp_nprocs();
+	for (;;) {
+		if (pid == 0) planRound();
+		bsp_sync();
+		if (sieveAmount == 0) break;
+		for (int k = pid; k < sieveAmount; k += P) {
+			sieveSegment(sieveList[k], slots[sieveSlot[k]].bits);
+		}
+		bsp_sync();
+	}
+	bsp_end();
+}
+
+/* Answers a whole batch, sieving the missing segments of all queries together */
+static void processBatch(struct Query *batch, int amount) {
+	currentBatch = batch;
+	currentAmount = amount;
+	firstRound = true;
+	// Every SPMD section needs its own bsp_init; the previous one ended in bsp_end
+	bsp_init(&spmd, 0, NULL);
+	spmd();
+	// Statistics queries see the state after the rest of the batch
+	double end = now();
+	for (int i = 0; i < amount; i++) {
+		if (batch[i].type == Q_INVALID) {
+			rejected++;
+			batch[i].done = true;
+		} else if (batch[i].type != Q_STATS) {
+			latencies[answered++ % LATENCY_SAMPLES] = end - batch[i].arrival;
+		}
+	}
+	for (int i = 0; i < amount; i++) {
+		if (batch[i].type == Q_STATS) {
+			latencySummary(batch[i].answer, sizeof(batch[i].answer));
+			batch[i].done = true;
+		}
+	}
+}
+
+/* Writes all of a line, retrying short writes; false if the other end went away */
+static bool writeLine(int fd, const char *line, size_t length) {
+	while (length > 0) {
+		ssize_t written = write(fd, line, length);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		line += written;
+		length -= written;
+	}
+	return true;
+}
+
+static void reply(struct Client *clients, struct Query *batch, int amount) {
+	for (int i = 0; i < amount; i++) {
+		int fd = STDOUT_FILENO;
+		if (batch[i].client >= 0) {
+			struct Client *client = &clients[batch[i].client];
+			// The client that asked may have gone, and its slot may serve another by now
+			if (client->fd < 0 || client->generation != batch[i].generation) continue;
+			fd = client->fd;
+		}
+		char line[LINE_MAX_LEN];
+		int length = snprintf(line, sizeof(line), "%s\n", batch[i].answer);
+		if (!writeLine(fd, line, length) && batch[i].client >= 0) {
+			// The client went away; drop the connection
+			close(fd);
+			clients[batch[i].client].fd = -1;
+		}
+	}
+}
+
+/*
+ * Reads whatever is available on one input and turns complete lines into
+ * queries. Returns false on end of file.
+ */
+static bool readQueries(struct Client *client, int index, struct Query *batch, int *amount) {
+	if (*amount == BATCH_MAX) return true;
+	ssize_t got = read(client->fd, client->buffer + client->length,
+		sizeof(client->buffer) - 1 - client->length);
+	if (got <= 0) {
+		return got < 0 && (errno == EINTR || errno == EAGAIN);
+	}
+	client->length += got;
+	client->buffer[client->length] = '\0';
+	char *line = client->buffer;
+	char *newline;
+	while (*amount < BATCH_MAX && (newline = strchr(line, '\n')) != NULL) {
+		*newline = '\0';
+		if (newline != line) {
+			parseQuery(&batch[*amount], line);
+			batch[*amount].client = index;
+			batch[*amount].generation = client->generation;
+			batch[*amount].arrival = now();
+			(*amount)++;
+		}
+		line = newline + 1;
+	}
+	client->length -= line - client->buffer;
+	memmove(client->buffer, line, client->length);
+	if (client->length == sizeof(client->buffer) - 1) {
+		// Overlong line; discard it
+		client->length = 0;
+	}
+	return true;
+}
+
+static int openSocket(const char *path) {
+	struct sockaddr_un address;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		perror("socket");
+		return -1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	unlink(path);
+	if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(fd, MAX_CLIENTS) < 0) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int main(int argc, char **argv) {
+	const char *socketPath = NULL;
+	int windowMicros = 0;
+	int option;
+	while ((option = getopt(argc, argv, "s:p:w:")) != -1) {
+		switch (option) {
+		case 's': socketPath = optarg; break;
+		case 'p': processes = atoi(optarg); break;
+		case 'w': windowMicros = atoi(optarg); break;
+		default:
+			fprintf(stderr, "Usage: %s [-s socket_path] [-p processes] [-w batch_window_us]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (processes < 1) processes = 1;
+
+	computeBasePrimes();
+	for (int s = 0; s < SEGMENTS; s++) {
+		segmentCount[s] = -1;
+		slotOf[s] = -1;
+	}
+	for (int s = 0; s < CACHE_SLOTS; s++) {
+		slots[s].segment = -1;
+		slots[s].lastUse = 0;
+		slots[s].bits = (bool*)malloc(SEGMENT_SIZE);
+	}
+
+	// Slot 0 is the listening socket or stdin, the others are clients
+	struct Client *clients = (struct Client*)calloc(MAX_CLIENTS + 1, sizeof(struct Client));
+	struct pollfd fds[MAX_CLIENTS + 1];
+	struct Query *batch = (struct Query*)malloc(sizeof(struct Query) * BATCH_MAX);
+	clients[0].fd = socketPath == NULL ? STDIN_FILENO : openSocket(socketPath);
+	if (clients[0].fd < 0) return EXIT_FAILURE;
+	for (int c = 1; c <= MAX_CLIENTS; c++) clients[c].fd = -1;
+
+	signal(SIGINT, requestStop);
+	signal(SIGTERM, requestStop);
+	// Clients that disconnect before their answer arrives must not kill the daemon
+	signal(SIGPIPE, SIG_IGN);
+
+	bool running = true;
+	uint64_t connections = 0;
+	while (running && !stopRequested) {
+		int amount = 0;
+		int timeout = -1;
+		double deadline = 0;
+		// Block for the first query, then keep gathering for the batch window
+		for (;;) {
+			for (int c = 0; c <= MAX_CLIENTS; c++) {
+				fds[c].fd = clients[c].fd;
+				fds[c].events = POLLIN;
+				fds[c].revents = 0;
+			}
+			int ready = poll(fds, MAX_CLIENTS + 1, timeout);
+			if (ready <= 0) break;
+			if (fds[0].revents & (POLLIN | POLLHUP)) {
+				if (socketPath == NULL) {
+					if (!readQueries(&clients[0], -1, batch, &amount)) running = false;
+				} else {
+					int fd = accept(clients[0].fd, NULL, NULL);
+					for (int c = 1; c <= MAX_CLIENTS && fd >= 0; c++) {
+						if (clients[c].fd < 0) {
+							clients[c].fd = fd;
+							clients[c].generation = ++connections;
+							clients[c].length = 0;
+							fd = -1;
+						}
+					}
+					if (fd >= 0) close(fd);
+				}
+			}
+			for (int c = 1; c <= MAX_CLIENTS; c++) {
+				if (clients[c].fd >= 0 && (fds[c].revents & (POLLIN | POLLHUP | POLLERR))) {
+					if (!readQueries(&clients[c], c, batch, &amount)) {
+						close(clients[c].fd);
+						clients[c].fd = -1;
+					}
+				}
+			}
+			if (!running || stopRequested || amount == BATCH_MAX) break;
+			if (amount > 0) {
+				if (windowMicros <= 0) break;
+				if (deadline == 0) deadline = now() + windowMicros / 1e6;
+				double left = deadline - now();
+				if (left <= 0) break;
+				timeout = (int)(left * 1000) + 1;
+			}
+		}
+		if (amount > 0) {
+			processBatch(batch, amount);
+			reply(clients, batch, amount);
+		}
+	}
+
+	char summary[LINE_MAX_LEN];
+	latencySummary(summary, sizeof(summary));
+	fprintf(stderr, "%s\n", summary);
+	if (socketPath != NULL) {
+		close(clients[0].fd);
+		unlink(socketPath);
+	}
+	for (int s = 0; s < CACHE_SLOTS; s++) free(slots[s].bits);
+	free(batch);
+	free(clients);
+	free(basePrimes);
+	return EXIT_SUCCESS;
+}
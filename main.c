@@ -4,15 +4,22 @@
 
 #define CORES 2
 
-int crossOuts = 0;
 bool primes[MAX_PRIMES];
 
-void crossOutMultiples(bool *array, int start, int end, int number, int pid) {
+void crossOutMultiples(bool *array, int start, int end, int number, struct SieveStats *stats) {
 	for (int i = start; i < end; i++) {
-		crossOuts++;
 		if(i % number == 0)
 			array[i] = 0;
 	}
+	// Count outside the loop: crossings are the multiples of number in [start, end)
+	if (end > start) {
+		const int first = (start + number - 1) / number * number;
+		stats->visits += end - start;
+		stats->phases[PHASE_SIEVE].bytes += end - start;
+		if (first < end)
+			stats->crossings += (uint64_t)((end - 1 - first) / number + 1);
+	}
+	stats->segments++;
 }
 
 int main( int argc, char ** argv ) {
@@ -39,6 +46,12 @@ void spmd() {
 
 	int pid = bsp_pid();
 
+	struct SieveStats stats;
+	struct PhaseTimer timer;
+	statsInit(&stats, pid);
+	statsOpenCounters(&timer, &stats);
+
+	phaseBegin(&timer, PHASE_INIT);
 
 	bool* vector = (bool*)malloc(MAX_PRIMES);
 
@@ -49,8 +62,14 @@ void spmd() {
 	}
 
 	bsp_push_reg(vector, MAX_PRIMES);
+	stats.phases[PHASE_INIT].bytes += MAX_PRIMES;
+
+	// Room for every process' statistics; only PID 0 reads it
+	struct SieveStats* allStats = (struct SieveStats*)malloc(sizeof(struct SieveStats) * cores);
+	bsp_push_reg(allStats, sizeof(struct SieveStats) * cores);
 
 	bsp_sync();
+	phaseEnd(&timer, &stats);
 
 
 	for (int i = 2; i < MAX_PRIMES / 2; i++) {
@@ -67,14 +86,21 @@ void spmd() {
 			int myStart = globalStart + blockSize * pid;
 			int myEnd = myStart + blockSize;
 
-    		crossOutMultiples(sample, myStart, myEnd, i, pid);
+			phaseBegin(&timer, PHASE_SIEVE);
+    		crossOutMultiples(sample, myStart, myEnd, i, &stats);
+			phaseEnd(&timer, &stats);
+
+			phaseBegin(&timer, PHASE_EXCHANGE);
 			for (int j = 0; j < cores; j++) {
 				//printf("mystart:%d\n", sample[myStart]);
 				bsp_put(j, sample + myStart, vector, myStart, blockSize);
 				bsp_sync();
 				bsp_get(j, vector, 0, sample, MAX_PRIMES);
+				stats.commOps += 2;
+				stats.phases[PHASE_EXCHANGE].bytes += blockSize + MAX_PRIMES;
 			}
 			bsp_sync();
+			phaseEnd(&timer, &stats);
 			
     	}
     	
@@ -82,6 +108,7 @@ void spmd() {
 
     printf("Total time: %f\n", bsp_time() - start);
 
+	phaseBegin(&timer, PHASE_COUNT);
     int sum = 0;
 
     for (int i = 0; i < MAX_PRIMES; i++) {
@@ -89,30 +116,60 @@ void spmd() {
     		sum++;
     	}
     }
+	stats.phases[PHASE_COUNT].bytes += MAX_PRIMES;
+	phaseEnd(&timer, &stats);
     printf("Number of primes%d prosessor %d\n", sum, pid);
 
 	
 	// Print out twin primes
 	if (pid == 0) {
+		phaseBegin(&timer, PHASE_TWIN);
 		for (int i = 2; i < MAX_PRIMES-2; i++) {
 			if (vector[i] == 1 && vector[i + 2] == 1 ) {
 				printf("%d:%d, ", i, i+2);
 			}
 		}
+		stats.phases[PHASE_TWIN].bytes += MAX_PRIMES;
+		phaseEnd(&timer, &stats);
 	}
 
 	// Print out goldbach primes
 	if (pid == 0) {
-		struct GoldBach* bacharray = createGoldBachPairs(vector, MAX_PRIMES);
+		phaseBegin(&timer, PHASE_GOLDBACH);
+		struct GoldBach* bacharray = createGoldBachPairs(vector, MAX_PRIMES, &stats);
+		phaseEnd(&timer, &stats);
+		free(bacharray);
+	}
+
+	// Gather all statistics at PID 0 in one final superstep
+	statsCloseCounters(&timer);
+	bsp_put(0, &stats, allStats, sizeof(struct SieveStats) * pid, sizeof(struct SieveStats));
+	bsp_sync();
+	if (pid == 0) {
+		statsReport(stdout, allStats, cores);
+		const char *csvPath = getenv("SIEVE_STATS_CSV");
+		if (csvPath != NULL) {
+			FILE *csv = fopen(csvPath, "w");
+			if (csv == NULL) {
+				fprintf(stderr, "Could not open %s for writing\n", csvPath);
+			} else {
+				statsExportCsv(csv, allStats, cores);
+				fclose(csv);
+			}
+		}
 	}
 
     // Clean up memory	
+	bsp_pop_reg(allStats);
+	bsp_pop_reg(vector);
+	bsp_sync();
+	free(allStats);
 	free(vector);
 	bsp_end();
 
 }
 
-struct GoldBach* createGoldBachPairs(bool* primes, int upperBound) {
+struct GoldBach* createGoldBachPairs(bool* primes, int upperBound, struct SieveStats *stats) {
 	
 	struct GoldBach* bacharray = (struct GoldBach*)malloc(sizeof(struct GoldBach) * upperBound / 2);
 	bacharray[4 / 2] = (struct GoldBach){ 2, 2 };
@@ -123,8 +180,10 @@ struct GoldBach* createGoldBachPairs(bool* primes, int upperBound) {
 			if (! primes[j]) continue;
 			//i and j are both primes,
 			bacharray[(i + j) / 2] = (struct GoldBach) { i, j };
+			stats->bucketOps++;
 		}
 	}
+	stats->phases[PHASE_GOLDBACH].bytes += upperBound + stats->bucketOps * sizeof(struct GoldBach);
 	return bacharray;
 }
 
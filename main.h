@@ -3,6 +3,7 @@
 #include <math.h>
 #include "MulticoreBSP-for-C/include/bsp.h"
 #include <stdbool.h>
+#include "stats.h"
 
 void spmd();
 
@@ -11,5 +12,5 @@ struct GoldBach {
 	int prime2;
 };
 
-struct GoldBach* createGoldBachPairs(bool *primes, int upperBound);
+struct GoldBach* createGoldBachPairs(bool *primes, int upperBound, struct SieveStats *stats);
 void printGoldBachArray(struct GoldBach* bacharray, int upperbound);
@@ -0,0 +1,183 @@
+#include <string.h>
+#include <unistd.h>
+#include "stats.h"
+#include "MulticoreBSP-for-C/include/bsp.h"
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* Misses per thousand instructions above which we call a run memory-bound */
+#define LLC_MPKI_BOUND 1.0
+#define L1_MPKI_BOUND 20.0
+
+static const char *phaseNames[PHASE_AMOUNT] = {
+	"init", "sieve", "exchange", "count", "twin", "goldbach"
+};
+
+void statsInit(struct SieveStats *stats, int pid) {
+	memset(stats, 0, sizeof(struct SieveStats));
+	stats->pid = pid;
+}
+
+#ifdef __linux__
+static int openCounter(uint32_t type, uint64_t config) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	// pid 0, cpu -1: count the calling thread wherever it runs
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+void statsOpenCounters(struct PhaseTimer *timer, struct SieveStats *stats) {
+	for (int i = 0; i < HW_AMOUNT; i++) {
+		timer->fd[i] = -1;
+	}
+	stats->hwValid = false;
+#ifdef __linux__
+	const uint64_t l1d = PERF_COUNT_HW_CACHE_L1D |
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	timer->fd[HW_CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	timer->fd[HW_INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	timer->fd[HW_L1D_MISSES] = openCounter(PERF_TYPE_HW_CACHE, l1d);
+	timer->fd[HW_LLC_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+	// Only trust the counters if every one of them could be opened
+	stats->hwValid = true;
+	for (int i = 0; i < HW_AMOUNT; i++) {
+		if (timer->fd[i] < 0) {
+			stats->hwValid = false;
+		}
+	}
+	if (!stats->hwValid) {
+		statsCloseCounters(timer);
+	}
+#endif
+}
+
+void statsCloseCounters(struct PhaseTimer *timer) {
+	for (int i = 0; i < HW_AMOUNT; i++) {
+		if (timer->fd[i] >= 0) {
+			close(timer->fd[i]);
+		}
+		timer->fd[i] = -1;
+	}
+}
+
+void phaseBegin(struct PhaseTimer *timer, enum SievePhase phase) {
+	timer->phase = phase;
+#ifdef __linux__
+	for (int i = 0; i < HW_AMOUNT; i++) {
+		if (timer->fd[i] >= 0) {
+			ioctl(timer->fd[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(timer->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+	timer->start = bsp_time();
+}
+
+void phaseEnd(struct PhaseTimer *timer, struct SieveStats *stats) {
+	struct PhaseStats *phase = &stats->phases[timer->phase];
+	phase->time += bsp_time() - timer->start;
+#ifdef __linux__
+	for (int i = 0; i < HW_AMOUNT; i++) {
+		uint64_t value = 0;
+		if (timer->fd[i] < 0) {
+			continue;
+		}
+		ioctl(timer->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+		if (read(timer->fd[i], &value, sizeof(value)) == sizeof(value)) {
+			phase->hw[i] += value;
+		}
+	}
+#endif
+}
+
+static const char *verdict(const struct PhaseStats *phase, bool hwValid) {
+	if (!hwValid || phase->hw[HW_INSTRUCTIONS] == 0) {
+		return "unknown";
+	}
+	double kiloInstructions = phase->hw[HW_INSTRUCTIONS] / 1000.0;
+	if (phase->hw[HW_LLC_MISSES] / kiloInstructions > LLC_MPKI_BOUND ||
+		phase->hw[HW_L1D_MISSES] / kiloInstructions > L1_MPKI_BOUND) {
+		return "memory-bound";
+	}
+	return "compute-bound";
+}
+
+void statsReport(FILE *out, const struct SieveStats *all, int nprocs) {
+	struct PhaseStats total[PHASE_AMOUNT];
+	bool hwValid = true;
+	memset(total, 0, sizeof(total));
+
+	fprintf(out, "\n%4s %10s %12s %12s %10s %10s %10s\n", "pid", "segments",
+		"visits", "crossings", "bucketOps", "commOps", "time(s)");
+	for (int s = 0; s < nprocs; s++) {
+		double time = 0;
+		for (int p = 0; p < PHASE_AMOUNT; p++) {
+			time += all[s].phases[p].time;
+			total[p].time += all[s].phases[p].time;
+			total[p].bytes += all[s].phases[p].bytes;
+			for (int h = 0; h < HW_AMOUNT; h++) {
+				total[p].hw[h] += all[s].phases[p].hw[h];
+			}
+		}
+		hwValid = hwValid && all[s].hwValid;
+		fprintf(out, "%4d %10llu %12llu %12llu %10llu %10llu %10f\n", all[s].pid,
+			(unsigned long long)all[s].segments, (unsigned long long)all[s].visits,
+			(unsigned long long)all[s].crossings, (unsigned long long)all[s].bucketOps,
+			(unsigned long long)all[s].commOps, time);
+	}
+
+	fprintf(out, "\n%-9s %10s %12s %8s %8s %8s  %s\n", "phase", "time(s)",
+		"bytes", "IPC", "L1 MPKI", "LLC MPKI", "verdict");
+	for (int p = 0; p < PHASE_AMOUNT; p++) {
+		double ipc = 0, l1 = 0, llc = 0;
+		if (hwValid && total[p].hw[HW_INSTRUCTIONS] > 0) {
+			double kiloInstructions = total[p].hw[HW_INSTRUCTIONS] / 1000.0;
+			if (total[p].hw[HW_CYCLES] > 0) {
+				ipc = (double)total[p].hw[HW_INSTRUCTIONS] / total[p].hw[HW_CYCLES];
+			}
+			l1 = total[p].hw[HW_L1D_MISSES] / kiloInstructions;
+			llc = total[p].hw[HW_LLC_MISSES] / kiloInstructions;
+		}
+		fprintf(out, "%-9s %10f %12llu %8.2f %8.2f %8.2f  %s\n", phaseNames[p],
+			total[p].time, (unsigned long long)total[p].bytes, ipc, l1, llc,
+			verdict(&total[p], hwValid));
+	}
+	if (!hwValid) {
+		fprintf(out, "(hardware counters unavailable; see /proc/sys/kernel/perf_event_paranoid)\n");
+	}
+}
+
+void statsExportCsv(FILE *out, const struct SieveStats *all, int nprocs) {
+	fprintf(out, "pid,phase,time,bytes,cycles,instructions,l1d_misses,llc_misses,"
+		"segments,visits,crossings,bucket_ops,comm_ops\n");
+	for (int s = 0; s < nprocs; s++) {
+		for (int p = 0; p < PHASE_AMOUNT; p++) {
+			const struct PhaseStats *phase = &all[s].phases[p];
+			fprintf(out, "%d,%s,%f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+				all[s].pid, phaseNames[p], phase->time,
+				(unsigned long long)phase->bytes,
+				(unsigned long long)phase->hw[HW_CYCLES],
+				(unsigned long long)phase->hw[HW_INSTRUCTIONS],
+				(unsigned long long)phase->hw[HW_L1D_MISSES],
+				(unsigned long long)phase->hw[HW_LLC_MISSES],
+				(unsigned long long)all[s].segments,
+				(unsigned long long)all[s].visits,
+				(unsigned long long)all[s].crossings,
+				(unsigned long long)all[s].bucketOps,
+				(unsigned long long)all[s].commOps);
+		}
+	}
+}
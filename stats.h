@@ -0,0 +1,81 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Per-process instrumentation of the sieve. Every BSP process owns one
+ * SieveStats; nothing in here is shared between threads, so the counters
+ * can be bumped from the hot loops without synchronisation.
+ */
+
+enum SievePhase {
+	PHASE_INIT = 0,
+	PHASE_SIEVE,
+	PHASE_EXCHANGE,
+	PHASE_COUNT,
+	PHASE_TWIN,
+	PHASE_GOLDBACH,
+	PHASE_AMOUNT
+};
+
+enum HwCounter {
+	HW_CYCLES = 0,
+	HW_INSTRUCTIONS,
+	HW_L1D_MISSES,
+	HW_LLC_MISSES,
+	HW_AMOUNT
+};
+
+struct PhaseStats {
+	double time;
+	/* Bytes read or written by this process during the phase */
+	uint64_t bytes;
+	uint64_t hw[HW_AMOUNT];
+};
+
+struct SieveStats {
+	int pid;
+	/* Candidates visited in crossOutMultiples */
+	uint64_t visits;
+	/* Candidates actually crossed out */
+	uint64_t crossings;
+	/* Blocks (one per sieving prime) handled by this process */
+	uint64_t segments;
+	/* Writes into the Goldbach pair buckets */
+	uint64_t bucketOps;
+	/* bsp_put and bsp_get calls issued */
+	uint64_t commOps;
+	/* Whether hw[] holds real hardware counter values */
+	bool hwValid;
+	struct PhaseStats phases[PHASE_AMOUNT];
+};
+
+/*
+ * Book-keeping for an open phase. Lives on the stack of the process; the
+ * file descriptors are -1 when perf_event_open is unavailable.
+ */
+struct PhaseTimer {
+	int fd[HW_AMOUNT];
+	double start;
+	enum SievePhase phase;
+};
+
+void statsInit(struct SieveStats *stats, int pid);
+
+/* Opens the hardware counters for the calling thread, if the kernel allows */
+void statsOpenCounters(struct PhaseTimer *timer, struct SieveStats *stats);
+void statsCloseCounters(struct PhaseTimer *timer);
+
+void phaseBegin(struct PhaseTimer *timer, enum SievePhase phase);
+void phaseEnd(struct PhaseTimer *timer, struct SieveStats *stats);
+
+/* Prints a per-process table and a compute/memory-bound verdict */
+void statsReport(FILE *out, const struct SieveStats *all, int nprocs);
+
+/* Writes one CSV line per process and phase */
+void statsExportCsv(FILE *out, const struct SieveStats *all, int nprocs);
+
+#endif